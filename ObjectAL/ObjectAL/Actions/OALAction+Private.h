@@ -7,6 +7,7 @@
 //
 
 #import "OALAction.h"
+#import "oal_tween.h"
 
 /** \cond */
 @interface OALAction ()
@@ -20,4 +21,84 @@
 @property(nonatomic,readwrite,assign) bool runningInManager;
 
 @end
+
+@interface OALPropertyAction (Accessors)
+
+/** Look up the target's accessors for propertyKey, so that they can be called
+ * directly with unboxed values rather than through key-value coding.
+ * Accessors that don't take or return a float or double fall back to key-value coding.
+ *
+ * @param target The target to look up the accessors in.
+ */
+- (void) resolveAccessorsForTarget:(id) target;
+
+/** Read the target's current property value.
+ *
+ * @return The value.
+ */
+- (float) readValue;
+
+@end
+
+
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+
+@interface OALAction ()
+
+/** The handle of this action in OALActionManager's tween engine, or OAL_TWEEN_INVALID_HANDLE. */
+@property(nonatomic,readwrite,assign) uint32_t tweenHandle;
+
+/** Incremented every time this action starts, so that OALActionManager can tell
+ * a restarted action from the run it recorded.
+ */
+@property(nonatomic,readwrite,assign) uint32_t runGeneration;
+
+@end
+
+@interface OALAction (Tween)
+
+/** Called by OALActionManager when this action starts, to see if it can run as a tween.
+ * Actions that do nothing more than move one property of their target from one value
+ * to another along an ease curve can be run as tweens.
+ *
+ * @param startValue Filled in with the value at the start of the action.
+ * @param endValue Filled in with the value at the end of the action.
+ * @param ease Filled in with the curve to follow.
+ * @param curve Filled in with a custom curve to follow instead of ease, or NULL.
+ * @return TRUE if this action can run as a tween.
+ */
+- (bool) tweenStartValue:(float*) startValue
+				endValue:(float*) endValue
+					ease:(oal_ease_type*) ease
+				   curve:(const oal_ease_table**) curve;
+
+/** Called by OALActionManager to apply a new value to this action's target when
+ * running as a tween.
+ *
+ * @param value The new value.
+ */
+- (void) applyTweenValue:(float) value;
+
+/** Get the property that this action changes when running as a tween.
+ *
+ * @return The property key, or nil if this action can't run as a tween.
+ */
+- (NSString*) tweenPropertyKey;
+
+@end
+
+@interface OALEaseAction (Private)
+
+/** Get the ease curve of the specified shape and phase.
+ *
+ * @param shape The shape of the curve.
+ * @param phase What phase of the action to apply the curve to.
+ * @return The ease curve.
+ */
++ (oal_ease_type) easeTypeForShape:(OALEaseShape) shape
+                             phase:(OALEasePhase) phase;
+
+@end
+
+#endif /* !OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
 /** \endcond */
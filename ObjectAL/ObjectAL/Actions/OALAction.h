@@ -278,6 +278,10 @@ typedef enum
 {
     kOALEaseShapeSine,
     kOALEaseShapeExponential,
+    kOALEaseShapeCubic,
+    kOALEaseShapeQuartic,
+    /** Pulls back slightly before moving forward (in), or overshoots slightly before settling (out). */
+    kOALEaseShapeBack,
 } OALEaseShape;
 
 /**
@@ -312,6 +316,38 @@ typedef enum
                phase:(OALEasePhase) phase
               action:(OALAction*) action;
 
+/** Create a new ease action following a cubic Bezier curve from (0, 0) to (1, 1),
+ * like the CSS cubic-bezier() timing function.
+ *
+ * @param x1 The x coordinate of the first control point (0.0 - 1.0).
+ * @param y1 The y coordinate of the first control point.
+ * @param x2 The x coordinate of the second control point (0.0 - 1.0).
+ * @param y2 The y coordinate of the second control point.
+ * @param action The action to apply the curve to.
+ * @return A new action.
+ */
++ (OALEaseAction*) actionWithControlPointsX1:(float) x1
+                                          y1:(float) y1
+                                          x2:(float) x2
+                                          y2:(float) y2
+                                      action:(OALAction*) action;
+
+/** Initialize an ease action following a cubic Bezier curve from (0, 0) to (1, 1),
+ * like the CSS cubic-bezier() timing function.
+ *
+ * @param x1 The x coordinate of the first control point (0.0 - 1.0).
+ * @param y1 The y coordinate of the first control point.
+ * @param x2 The x coordinate of the second control point (0.0 - 1.0).
+ * @param y2 The y coordinate of the second control point.
+ * @param action The action to apply the curve to.
+ * @return The initialized action.
+ */
+- (id) initWithControlPointsX1:(float) x1
+                            y1:(float) y1
+                            x2:(float) x2
+                            y2:(float) y2
+                        action:(OALAction*) action;
+
 /** Get a pointer to an ease function of the specified shape and phase.
  *
  * @param shape The shape of the curve to apply.
@@ -56,6 +56,7 @@
 	if(nil != (self = [super init]))
 	{
 		self.duration = duration;
+		self.tweenHandle = OAL_TWEEN_INVALID_HANDLE;
 	}
 	return self;
 }
@@ -68,6 +69,8 @@
 @synthesize elapsed = elapsed_;
 @synthesize running = running_;
 @synthesize runningInManager = runningInManager_;
+@synthesize tweenHandle = _tweenHandle;
+@synthesize runGeneration = _runGeneration;
 
 
 #pragma mark Functions
@@ -100,6 +103,7 @@
 
 - (void) startAction
 {
+	self.runGeneration++;
 	self.running = YES;
 	self.elapsed = 0;
 }
@@ -120,6 +124,34 @@
 	}
 }
 
+
+#pragma mark Tweening
+
+- (bool) tweenStartValue:(float*) startValue
+				endValue:(float*) endValue
+					ease:(oal_ease_type*) ease
+				   curve:(const oal_ease_table**) curve
+{
+    #pragma unused(startValue)
+    #pragma unused(endValue)
+    #pragma unused(ease)
+    #pragma unused(curve)
+	// Subclasses will override this.
+	return NO;
+}
+
+- (void) applyTweenValue:(float) value
+{
+    #pragma unused(value)
+	// Subclasses will override this.
+}
+
+- (NSString*) tweenPropertyKey
+{
+	// Subclasses will override this.
+	return nil;
+}
+
 @end
 
 
@@ -205,7 +237,51 @@
 #pragma mark -
 #pragma mark OALPropertyAction
 
+/** How OALPropertyAction reads or writes its target's property. */
+typedef enum
+{
+    /** Through key-value coding, boxed in an NSNumber. */
+    kOALPropertyAccessKVC,
+    /** Directly through the accessor's IMP, as a float. */
+    kOALPropertyAccessFloat,
+    /** Directly through the accessor's IMP, as a double. */
+    kOALPropertyAccessDouble,
+} OALPropertyAccess;
+
+typedef float (*OALFloatGetter)(id, SEL);
+typedef double (*OALDoubleGetter)(id, SEL);
+typedef void (*OALFloatSetter)(id, SEL, float);
+typedef void (*OALDoubleSetter)(id, SEL, double);
+
+/** Work out how to access a value with the given type encoding.
+ *
+ * @param type The type encoding of the accessor's argument or return value.
+ * @return The access to use.
+ */
+static OALPropertyAccess accessForType(const char* type)
+{
+    if(0 == strcmp(type, @encode(float)))
+    {
+        return kOALPropertyAccessFloat;
+    }
+    if(0 == strcmp(type, @encode(double)))
+    {
+        return kOALPropertyAccessDouble;
+    }
+    return kOALPropertyAccessKVC;
+}
+
 @interface OALPropertyAction ()
+{
+    /** The target the accessors were resolved for. WEAK REFERENCE. */
+    as_unsafe_unretained id accessTarget_;
+    OALPropertyAccess getterAccess_;
+    SEL getterSelector_;
+    IMP getterImp_;
+    OALPropertyAccess setterAccess_;
+    SEL setterSelector_;
+    IMP setterImp_;
+}
 
 @property(nonatomic,readwrite,assign) float delta;
 
@@ -275,92 +351,143 @@
 
 #pragma mark Functions
 
-- (void) prepareWithTarget:(id) target
+- (void) resolveAccessorsForTarget:(id) target
 {
-	[super prepareWithTarget:target];
+    accessTarget_ = target;
+    getterAccess_ = kOALPropertyAccessKVC;
+    setterAccess_ = kOALPropertyAccessKVC;
 
-    if(isnan(self.startValue))
+    NSString* key = self.propertyKey;
+    if([key length] == 0)
     {
-        self.startValue = [[target valueForKey:self.propertyKey] floatValue];
+        return;
     }
 
-	self.delta = self.endValue - self.startValue;
-}
+    SEL getter = NSSelectorFromString(key);
+    if([target respondsToSelector:getter])
+    {
+        getterAccess_ = accessForType([[target methodSignatureForSelector:getter] methodReturnType]);
+        getterSelector_ = getter;
+        getterImp_ = [target methodForSelector:getter];
+    }
 
-- (void) updateCompletion:(float) proportionComplete
-{
-    float value = self.startValue + self.delta * proportionComplete;
-    [self.target setValue:[NSNumber numberWithFloat:value] forKey:self.propertyKey];
+    SEL setter = NSSelectorFromString([NSString stringWithFormat:@"set%@%@:",
+                                       [[key substringToIndex:1] uppercaseString],
+                                       [key substringFromIndex:1]]);
+    if([target respondsToSelector:setter])
+    {
+        setterAccess_ = accessForType([[target methodSignatureForSelector:setter] getArgumentTypeAtIndex:2]);
+        setterSelector_ = setter;
+        setterImp_ = [target methodForSelector:setter];
+    }
 }
 
-@end
-
-
-#pragma mark -
-#pragma mark OALEaseAction
-
-static float easeFunction_sineIn(float x)
+- (float) readValue
 {
-    return 1.0f - cosf(x * (float)M_PI_2);
+    switch(getterAccess_)
+    {
+        case kOALPropertyAccessFloat:
+            return ((OALFloatGetter)getterImp_)(accessTarget_, getterSelector_);
+        case kOALPropertyAccessDouble:
+            return (float)((OALDoubleGetter)getterImp_)(accessTarget_, getterSelector_);
+        default:
+            return [[accessTarget_ valueForKey:self.propertyKey] floatValue];
+    }
 }
 
-static float easeFunction_sineOut(float x)
+- (void) prepareWithTarget:(id) target
 {
-    return sinf(x * (float)M_PI_2);
+	[super prepareWithTarget:target];
+
+    [self resolveAccessorsForTarget:target];
+    if(isnan(self.startValue))
+    {
+        self.startValue = [self readValue];
+    }
+
+	self.delta = self.endValue - self.startValue;
 }
 
-static float easeFunction_sineInOut(float x)
+- (void) updateCompletion:(float) proportionComplete
 {
-    return -0.5f * (cosf(x * (float)M_PI) - 1);
+    [self applyTweenValue:_startValue + _delta * proportionComplete];
 }
 
-static float easeFunction_exponentIn(float x)
+- (void) applyTweenValue:(float) value
 {
-    if(x == 0)
+    switch(setterAccess_)
     {
-        return 0;
+        case kOALPropertyAccessFloat:
+            ((OALFloatSetter)setterImp_)(accessTarget_, setterSelector_, value);
+            break;
+        case kOALPropertyAccessDouble:
+            ((OALDoubleSetter)setterImp_)(accessTarget_, setterSelector_, value);
+            break;
+        default:
+            [accessTarget_ setValue:[NSNumber numberWithFloat:value] forKey:self.propertyKey];
+            break;
     }
-    return powf(2, 10 * (x - 1));
 }
 
-static float easeFunction_exponentOut(float x)
-{
-    if(x == 1)
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+- (bool) tweenStartValue:(float*) startValue
+				endValue:(float*) endValue
+					ease:(oal_ease_type*) ease
+				   curve:(const oal_ease_table**) curve
+{
+    // Subclasses that change how the value is applied must run as regular actions.
+    if([self methodForSelector:@selector(updateCompletion:)] !=
+       [OALPropertyAction instanceMethodForSelector:@selector(updateCompletion:)])
     {
-        return 1;
+        return NO;
     }
-    return powf(-2, -10 * x) + 1;
+
+    *startValue = self.startValue;
+    *endValue = self.endValue;
+    *ease = OAL_EASE_LINEAR;
+    *curve = NULL;
+    return YES;
 }
 
-static float easeFunction_exponentInOut(float x)
+- (NSString*) tweenPropertyKey
 {
-    if(x < 0.5)
-    {
-        if(x == 0)
-        {
-            return 0;
-        }
-        return powf(2, (12 * (x - 0.86f))) * 10;
-    }
-    if(x == 1)
-    {
-        return 1;
-    }
-    return powf(-2, (-12 * (x - 0.4165f))) + 1;
+    return self.propertyKey;
 }
+#endif
 
+@end
+
+
+#pragma mark -
+#pragma mark OALEaseAction
 
-static EaseFunctionPtr g_easeFunctions[2][3] =
+/** Ease curves by shape and phase. */
+static const oal_ease_type g_easeTypes[5][3] =
 {
     {
-        easeFunction_sineIn,
-        easeFunction_sineOut,
-        easeFunction_sineInOut,
+        OAL_EASE_SINE_IN,
+        OAL_EASE_SINE_OUT,
+        OAL_EASE_SINE_IN_OUT,
+    },
+    {
+        OAL_EASE_EXPONENTIAL_IN,
+        OAL_EASE_EXPONENTIAL_OUT,
+        OAL_EASE_EXPONENTIAL_IN_OUT,
+    },
+    {
+        OAL_EASE_CUBIC_IN,
+        OAL_EASE_CUBIC_OUT,
+        OAL_EASE_CUBIC_IN_OUT,
     },
     {
-        easeFunction_exponentIn,
-        easeFunction_exponentOut,
-        easeFunction_exponentInOut,
+        OAL_EASE_QUARTIC_IN,
+        OAL_EASE_QUARTIC_OUT,
+        OAL_EASE_QUARTIC_IN_OUT,
+    },
+    {
+        OAL_EASE_BACK_IN,
+        OAL_EASE_BACK_OUT,
+        OAL_EASE_BACK_IN_OUT,
     },
 };
 
@@ -368,6 +495,9 @@ static EaseFunctionPtr g_easeFunctions[2][3] =
 
 @property(nonatomic, readwrite, retain) OALAction* action;
 @property(nonatomic, readwrite, assign) EaseFunctionPtr easeFunction;
+@property(nonatomic, readwrite, assign) oal_ease_type easeType;
+/** A custom curve to use instead of easeFunction (owned by this action). */
+@property(nonatomic, readwrite, assign) oal_ease_table* curve;
 
 @end
 
@@ -375,13 +505,23 @@ static EaseFunctionPtr g_easeFunctions[2][3] =
 
 @synthesize action = action_;
 @synthesize easeFunction = easeFunction_;
+@synthesize easeType = easeType_;
+@synthesize curve = curve_;
 
 + (EaseFunctionPtr) easeFunctionForShape:(OALEaseShape) shape
                                    phase:(OALEasePhase) phase
 {
-    return g_easeFunctions[shape][phase];
+    return oal_ease_function_for_type(g_easeTypes[shape][phase]);
 }
 
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
++ (oal_ease_type) easeTypeForShape:(OALEaseShape) shape
+                             phase:(OALEasePhase) phase
+{
+    return g_easeTypes[shape][phase];
+}
+#endif
+
 + (OALEaseAction*) actionWithShape:(OALEaseShape) shape
                              phase:(OALEasePhase) phase
                             action:(OALAction*) action
@@ -397,14 +537,51 @@ static EaseFunctionPtr g_easeFunctions[2][3] =
 {
     if((self = [super initWithDuration:action.duration]))
     {
+        self.easeType = g_easeTypes[shape][phase];
         self.easeFunction = [[self class] easeFunctionForShape:shape phase:phase];
         self.action = action;
     }
     return self;
 }
 
++ (OALEaseAction*) actionWithControlPointsX1:(float) x1
+                                           y1:(float) y1
+                                           x2:(float) x2
+                                           y2:(float) y2
+                                       action:(OALAction*) action
+{
+    return as_autorelease([[self alloc] initWithControlPointsX1:x1
+                                                             y1:y1
+                                                             x2:x2
+                                                             y2:y2
+                                                         action:action]);
+}
+
+- (id) initWithControlPointsX1:(float) x1
+                            y1:(float) y1
+                            x2:(float) x2
+                            y2:(float) y2
+                        action:(OALAction*) action
+{
+    if((self = [super initWithDuration:action.duration]))
+    {
+        self.curve = oal_ease_table_create_bezier(x1, y1, x2, y2);
+        if(NULL == self.curve)
+        {
+            OAL_LOG_ERROR(@"Could not allocate ease curve");
+            as_release(self);
+            return nil;
+        }
+        self.easeType = OAL_EASE_LINEAR;
+        self.easeFunction = oal_ease_linear;
+        self.action = action;
+    }
+    return self;
+}
+
 - (void) dealloc
 {
+    oal_ease_table_destroy(curve_);
     as_release(action_);
     as_superdealloc();
 }
@@ -437,7 +614,46 @@ static EaseFunctionPtr g_easeFunctions[2][3] =
 
 - (void) updateCompletion:(float) proportionComplete
 {
+    if(NULL != self.curve)
+    {
+        [self.action updateCompletion:oal_ease_table_value(self.curve, proportionComplete)];
+        return;
+    }
     [self.action updateCompletion:self.easeFunction(proportionComplete)];
 }
 
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+- (bool) tweenStartValue:(float*) startValue
+				endValue:(float*) endValue
+					ease:(oal_ease_type*) ease
+				   curve:(const oal_ease_table**) curve
+{
+    // Only an ease over a straight line can be run as a single tween.
+    oal_ease_type innerEase;
+    const oal_ease_table* innerCurve;
+    if([self methodForSelector:@selector(updateCompletion:)] !=
+       [OALEaseAction instanceMethodForSelector:@selector(updateCompletion:)] ||
+       ![self.action tweenStartValue:startValue endValue:endValue ease:&innerEase curve:&innerCurve] ||
+       OAL_EASE_LINEAR != innerEase ||
+       NULL != innerCurve)
+    {
+        return NO;
+    }
+
+    *ease = self.easeType;
+    *curve = self.curve;
+    return YES;
+}
+
+- (void) applyTweenValue:(float) value
+{
+    [self.action applyTweenValue:value];
+}
+
+- (NSString*) tweenPropertyKey
+{
+    return [self.action tweenPropertyKey];
+}
+#endif
+
 @end
@@ -32,6 +32,9 @@
 #import "OALAction.h"
 #import "ObjectALConfig.h"
 
+struct oal_tween_engine;
+struct OALTweenResults;
+
 /* This object is only available if OBJECTAL_CFG_USE_COCOS2D_ACTIONS is enabled in ObjectALConfig.h.
  */
 #if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
@@ -39,31 +42,114 @@
 
 #pragma mark OALActionManager
 
+/** Where OALActionManager gets the time from. */
+typedef enum
+{
+	/** The system's monotonic clock. Actions are stepped by a timer or the scheduler thread. */
+	kOALActionClockRealTime,
+	/** Time only moves when the application calls advanceTime:. */
+	kOALActionClockManual,
+	/** Time only moves when the application calls advanceSamples:, at sampleClockRate. */
+	kOALActionClockAudioSamples,
+} OALActionClockMode;
+
 /**
  * Manages all ObjectAL actions.
  */
 @interface OALActionManager : NSObject
 {
-	/** All targets that have actions running on them (id). */
-	NSMutableArray* targets;
-	
-	/** Parallel array to "targets", maintaining a list of all actions per target (NSMutableArray*) */
-	NSMutableArray* targetActions;
+	/** All actions per target that has actions running on it, other than tweens
+	 * (target (id, WEAK REFERENCE) -> NSMutableArray*).
+	 */
+	CFMutableDictionaryRef targetActions;
+
+	/** Actions that just change one property of their target, run in packed form. */
+	struct oal_tween_engine* tweens;
 	
 	/** All actions that are to be added on the next pass (OALAction*) */
 	NSMutableArray* actionsToAdd;
 	
 	/** All actions that are to be removed on the next pass (OALAction*) */
 	NSMutableArray* actionsToRemove;
+
+	/** Held while stepping, so that actions can be updated without holding this object's lock. */
+	id stepLock;
+
+	/** The tween values from the current step, applied once this object's lock is released. */
+	struct OALTweenResults* tweenResults;
 	
 	/** The timer which we use to update the actions. */
 	NSTimer* stepTimer;
 	
 	/** The last time that was recorded. */
 	uint64_t lastTimestamp;
+
+	bool runsOnSchedulerThread;
+	bool useEaseTables;
+	NSTimeInterval schedulerStepInterval;
+
+	/** The thread which updates the actions when runsOnSchedulerThread is set. */
+	NSThread* schedulerThread;
+
+	/** Wakes the scheduler thread when actions start. */
+	NSCondition* schedulerCondition;
+
+	/** If YES, there may be new actions for the scheduler thread to perform. */
+	bool schedulerWake;
+
+	OALActionClockMode clockMode;
+	double sampleClockRate;
+
+	/** The number of samples the audio sample clock has advanced by. */
+	uint64_t samplePosition;
 }
 
 
+#pragma mark Properties
+
+/** If YES, update actions on a dedicated scheduler thread instead of an NSTimer on the
+ * main run loop (default NO). <br>
+ *
+ * The scheduler thread wakes on a monotonic clock every schedulerStepInterval seconds,
+ * so actions keep running smoothly while the main thread is busy. Each step's changes
+ * to OpenAL are applied together. If a step is late, actions catch up by the time that
+ * has actually elapsed rather than running extra steps. <br>
+ *
+ * Note: Actions (including the blocks and selectors of OALCallAction) then run on the
+ * scheduler thread, so OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS must be enabled.
+ */
+@property(nonatomic,readwrite,assign) bool runsOnSchedulerThread;
+
+/** If YES, eased actions look up their curves in precomputed tables rather than
+ * calculating them (default NO). <br>
+ *
+ * Both ways are accurate to within about 1e-6, and evaluate all actions on the same curve
+ * together. Tables cost the same for every curve, but are usually a little slower than
+ * the SIMD calculations. Each curve's table takes 16KB the first time it is used.
+ */
+@property(nonatomic,readwrite,assign) bool useEaseTables;
+
+/** The interval in seconds between steps on the scheduler thread
+ * (default kActionSchedulerStepInterval).
+ */
+@property(nonatomic,readwrite,assign) NSTimeInterval schedulerStepInterval;
+
+/** Where the time used to step actions comes from (default kOALActionClockRealTime). <br>
+ *
+ * With the real time clock, actions run on their own, and timing depends on when the
+ * timer or scheduler thread fires. With the manual or audio sample clocks, actions
+ * only move when the application advances the clock, by exactly the time given. This
+ * makes action behavior reproducible in tests and replays, and lets audio be rendered
+ * faster (or slower) than real time. <br>
+ *
+ * Changing the clock doesn't move any running actions.
+ */
+@property(nonatomic,readwrite,assign) OALActionClockMode clockMode;
+
+/** The number of samples per second counted by advanceSamples: (default 44100). */
+@property(nonatomic,readwrite,assign) double sampleClockRate;
+
+
 #pragma mark Object Management
 
 /** Singleton implementation providing "sharedInstance" and "purgeSharedInstance" methods.
@@ -80,6 +166,25 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALActionManager);
  */
 - (void) stopAllActions;
 
+/** Advance all actions by an exact amount of time.
+ * Only works when clockMode is kOALActionClockManual.
+ *
+ * @param seconds The time to advance by.
+ */
+- (void) advanceTime:(NSTimeInterval) seconds;
+
+/** Advance all actions by the time taken to play a number of samples at sampleClockRate.
+ * Only works when clockMode is kOALActionClockAudioSamples. <br>
+ *
+ * The clock counts whole samples, so it doesn't drift however it is advanced.
+ * A loopback ALDevice calls this for you from renderFrames:intoBuffer:. Sources are
+ * only changed after the action manager's lock is released, so this can be called from
+ * a render callback while other threads play and stop sources.
+ *
+ * @param samples The number of samples (frames) to advance by.
+ */
+- (void) advanceSamples:(uint64_t) samples;
+
 
 #pragma mark Internal Use
 
@@ -28,16 +28,93 @@
 //
 
 #import "OALActionManager.h"
+#import "OpenALManager.h"
+#import "OALAction+Private.h"
 #import "mach_timing.h"
+#import "oal_tween.h"
 #import "ObjectALMacros.h"
 #import "ARCSafe_MemMgmt.h"
-#import "NSMutableArray+WeakReferences.h"
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
 #import <UIKit/UIKit.h>
 #endif
 
 #if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
 
+/** Priority of the scheduler thread (0.0 - 1.0). */
+#define kSchedulerThreadPriority 0.9
+
+/** The number of tweens to allocate space for up front. */
+#define kInitialTweenCapacity 64
+
+/** A tween's value from a step, waiting to be applied to its action. */
+typedef struct
+{
+	void* binding;
+	float value;
+	/** The action's run generation when the value was recorded. */
+	uint32_t generation;
+	bool finished;
+} OALTweenResult;
+
+/** The tween values from the current step. */
+typedef struct OALTweenResults
+{
+	OALTweenResult* results;
+	uint32_t count;
+	uint32_t capacity;
+} OALTweenResults;
+
+/** Take the tween engine's reference to an action. */
+static void* retainBinding(OALAction* action)
+{
+	return (as_bridge_retained void*) as_retain(action);
+}
+
+/** Give up the tween engine's reference to an action. */
+static void releaseBinding(void* binding)
+{
+	OALAction* action = as_autorelease((as_bridge_transfer OALAction*) binding);
+	#pragma unused(action)
+}
+
+/** Record a tween's value so that it can be applied once the manager's lock is released.
+ * The engine drops finished tweens, so their handles are cleared right away.
+ */
+static void recordTween(void* context, void* binding, float value, bool finished)
+{
+	OALTweenResults* results = (OALTweenResults*) context;
+	OALTweenResult* result = &results->results[results->count++];
+	result->binding = binding;
+	result->value = value;
+	result->generation = ((as_bridge OALAction*) binding).runGeneration;
+	result->finished = finished;
+	if(finished)
+	{
+		((as_bridge OALAction*) binding).tweenHandle = OAL_TWEEN_INVALID_HANDLE;
+	}
+}
+
+/** Apply a tween's value to its action, stopping the action when the tween finishes.
+ * The tween engine holds a reference to each action, which is given up here when it finishes.
+ * Actions that were stopped or restarted since the value was recorded are left alone.
+ */
+static void applyTween(const OALTweenResult* result)
+{
+	OALAction* action = (as_bridge OALAction*) result->binding;
+	if(action.running && action.runGeneration == result->generation)
+	{
+		[action applyTweenValue:result->value];
+		if(result->finished)
+		{
+			[action stopAction];
+		}
+	}
+	if(result->finished)
+	{
+		releaseBinding(result->binding);
+	}
+}
+
 SYNTHESIZE_SINGLETON_FOR_CLASS_PROTOTYPE(OALActionManager);
 
 /** \cond */
@@ -49,6 +126,47 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_PROTOTYPE(OALActionManager);
 /** Resets the time delta in cases where proper time delta calculations become impossible.
  */
 - (void) doResetTimeDelta:(NSNotification*) notification;
+
+/** Check if there are any actions running (not counting actions about to be added).
+ *
+ * @return TRUE if there are actions running.
+ */
+- (bool) hasRunningActions;
+
+/** Advance all actions by the time elapsed on the real time clock since the last step.
+ *
+ * @return TRUE if there are still actions running.
+ */
+- (bool) stepActions;
+
+/** Add and remove pending actions, then update all running actions.
+ *
+ * @param elapsedTime The time to advance the running actions by, in seconds.
+ * @return TRUE if there are still actions running.
+ */
+- (bool) stepActionsBy:(float) elapsedTime;
+
+/** Start the timer which updates actions on the main run loop.
+ */
+- (void) startStepTimer;
+
+/** Start a new scheduler thread.
+ */
+- (void) startSchedulerThread;
+
+/** Tell the scheduler thread to exit.
+ */
+- (void) stopSchedulerThread;
+
+/** Wake the scheduler thread so that it performs newly started actions.
+ */
+- (void) wakeSchedulerThread;
+
+/** The scheduler thread's main loop.
+ *
+ * @param condition The condition to wait on while there are no actions.
+ */
+- (void) schedulerLoop:(NSCondition*) condition;
 /** \endcond */
 
 @end
@@ -66,10 +184,17 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 {
 	if(nil != (self = [super init]))
 	{
-		targets = [NSMutableArray newMutableArrayUsingWeakReferencesWithCapacity:50];
-		targetActions = [[NSMutableArray alloc] initWithCapacity:50];
+		// Targets are compared by identity and not retained.
+		CFDictionaryKeyCallBacks keyCallbacks = {0, NULL, NULL, CFCopyDescription, NULL, NULL};
+		targetActions = CFDictionaryCreateMutable(NULL, 50, &keyCallbacks, &kCFTypeDictionaryValueCallBacks);
+		tweens = oal_tween_engine_create(kInitialTweenCapacity);
+		tweenResults = calloc(1, sizeof(*tweenResults));
+		stepLock = [[NSObject alloc] init];
 		actionsToAdd = [[NSMutableArray alloc] initWithCapacity:100];
 		actionsToRemove = [[NSMutableArray alloc] initWithCapacity:100];
+		schedulerStepInterval = kActionSchedulerStepInterval;
+		clockMode = kOALActionClockRealTime;
+		sampleClockRate = 44100;
 
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
 		[[NSNotificationCenter defaultCenter] addObserver:self
@@ -92,8 +217,16 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 - (void) dealloc
 {
 	[[NSNotificationCenter defaultCenter] removeObserver:self];
-	as_release(targets);
-	as_release(targetActions);
+	[self stopSchedulerThread];
+	for(uint32_t i = 0; i < oal_tween_engine_count(tweens); i++)
+	{
+		releaseBinding(oal_tween_engine_binding_at(tweens, i));
+	}
+	oal_tween_engine_destroy(tweens);
+	free(tweenResults->results);
+	free(tweenResults);
+	as_release(stepLock);
+	CFRelease(targetActions);
 	as_release(actionsToAdd);
 	as_release(actionsToRemove);
 	as_superdealloc();
@@ -106,109 +239,529 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 }
 
 
+#pragma mark Properties
+
+- (bool) runsOnSchedulerThread
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return runsOnSchedulerThread;
+	}
+}
+
+- (void) setRunsOnSchedulerThread:(bool) value
+{
+	bool hasActions;
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(value == runsOnSchedulerThread)
+		{
+			return;
+		}
+		runsOnSchedulerThread = value;
+		hasActions = [self hasRunningActions] || [actionsToAdd count] > 0;
+		if(kOALActionClockRealTime != clockMode)
+		{
+			// Nothing steps on its own until the real time clock is back.
+			return;
+		}
+
+		if(runsOnSchedulerThread)
+		{
+			[stepTimer invalidate];
+			stepTimer = nil;
+			[self startSchedulerThread];
+		}
+		else
+		{
+			[self stopSchedulerThread];
+			if(hasActions)
+			{
+				[self startStepTimer];
+			}
+		}
+	}
+	if(value && hasActions)
+	{
+		[self wakeSchedulerThread];
+	}
+}
+
+- (bool) useEaseTables
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return useEaseTables;
+	}
+}
+
+- (void) setUseEaseTables:(bool) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		useEaseTables = value;
+		oal_tween_engine_set_use_tables(tweens, value);
+	}
+}
+
+- (NSTimeInterval) schedulerStepInterval
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return schedulerStepInterval;
+	}
+}
+
+- (void) setSchedulerStepInterval:(NSTimeInterval) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		schedulerStepInterval = value;
+	}
+}
+
+- (OALActionClockMode) clockMode
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return clockMode;
+	}
+}
+
+- (void) setClockMode:(OALActionClockMode) value
+{
+	bool wake = NO;
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(value == clockMode)
+		{
+			return;
+		}
+		bool wasRealTime = kOALActionClockRealTime == clockMode;
+		clockMode = value;
+		lastTimestamp = 0;
+
+		if(wasRealTime)
+		{
+			// From now on, time only moves when the application advances it.
+			[stepTimer invalidate];
+			stepTimer = nil;
+			[self stopSchedulerThread];
+		}
+		else if(kOALActionClockRealTime == value)
+		{
+			bool hasActions = [self hasRunningActions] || [actionsToAdd count] > 0;
+			if(runsOnSchedulerThread)
+			{
+				[self startSchedulerThread];
+				wake = hasActions;
+			}
+			else if(hasActions)
+			{
+				[self startStepTimer];
+			}
+		}
+	}
+	if(wake)
+	{
+		[self wakeSchedulerThread];
+	}
+}
+
+- (double) sampleClockRate
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return sampleClockRate;
+	}
+}
+
+- (void) setSampleClockRate:(double) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(value <= 0)
+		{
+			OAL_LOG_ERROR(@"%@: Invalid sample clock rate: %f", self, value);
+			return;
+		}
+		sampleClockRate = value;
+		samplePosition = 0;
+	}
+}
+
+
 #pragma mark Action Management
 
 - (void) stopAllActions
 {
+	NSMutableArray* actionsToStop = [NSMutableArray array];
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		for(NSMutableArray* actions in targetActions)
+		for(NSMutableArray* actions in [(as_bridge NSDictionary*) targetActions objectEnumerator])
 		{
-			[actions makeObjectsPerformSelector:@selector(stopAction)];
+			[actionsToStop addObjectsFromArray:actions];
 		}
-		
-		[actionsToAdd makeObjectsPerformSelector:@selector(stopAction)];
+		for(uint32_t i = 0; i < oal_tween_engine_count(tweens); i++)
+		{
+			[actionsToStop addObject:(as_bridge OALAction*) oal_tween_engine_binding_at(tweens, i)];
+		}
+		[actionsToStop addObjectsFromArray:actionsToAdd];
+	}
+
+	// Stopping can call back into the targets, which may be waiting for this object's lock.
+	[actionsToStop makeObjectsPerformSelector:@selector(stopAction)];
+}
+
+- (void) advanceTime:(NSTimeInterval) seconds
+{
+	OPTIONALLY_SYNCHRONIZED(stepLock)
+	{
+		OPTIONALLY_SYNCHRONIZED(self)
+		{
+			if(kOALActionClockManual != clockMode)
+			{
+				OAL_LOG_WARNING(@"%@: advanceTime: only works with the manual clock", self);
+				return;
+			}
+		}
+		[self stepActionsBy:(float)seconds];
+	}
+}
+
+- (void) advanceSamples:(uint64_t) samples
+{
+	// Steps apply their changes after letting go of this object's lock, so that
+	// the render callback can't deadlock against a source that is stopping its actions.
+	OPTIONALLY_SYNCHRONIZED(stepLock)
+	{
+		double elapsed;
+		OPTIONALLY_SYNCHRONIZED(self)
+		{
+			if(kOALActionClockAudioSamples != clockMode)
+			{
+				OAL_LOG_WARNING(@"%@: advanceSamples: only works with the audio sample clock", self);
+				return;
+			}
+
+			// Work from the total sample count so that rounding errors don't build up.
+			uint64_t previous = samplePosition;
+			samplePosition += samples;
+			elapsed = (double)samplePosition / sampleClockRate - (double)previous / sampleClockRate;
+		}
+		[self stepActionsBy:(float)elapsed];
 	}
 }
 
 
 #pragma mark Timer Interface
 
+- (void) startStepTimer
+{
+	stepTimer = [NSTimer scheduledTimerWithTimeInterval:kActionStepInterval
+												 target:self
+											   selector:@selector(step:)
+											   userInfo:nil
+												repeats:YES];
+}
+
 - (void) step:(NSTimer*) timer
 {
     #pragma unused(timer)
+	if([self stepActions])
+	{
+		return;
+	}
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		// If there are no more actions running, stop the master timer,
+		// unless an action was started after the step.
+		if(0 == [actionsToAdd count])
+		{
+			[stepTimer invalidate];
+			stepTimer = nil;
+		}
+	}
+}
+
+
+#pragma mark Scheduler Thread
+
+- (void) startSchedulerThread
+{
+	schedulerCondition = [[NSCondition alloc] init];
+	schedulerWake = NO;
+	schedulerThread = [[NSThread alloc] initWithTarget:self
+											  selector:@selector(schedulerLoop:)
+												object:schedulerCondition];
+	[schedulerThread start];
+}
+
+- (void) stopSchedulerThread
+{
+	if(nil == schedulerThread)
+	{
+		return;
+	}
+
+	// The thread may be waiting for this object's lock, so don't wait for it to exit.
+	[schedulerCondition lock];
+	[schedulerThread cancel];
+	[schedulerCondition signal];
+	[schedulerCondition unlock];
+
+	as_release(schedulerThread);
+	schedulerThread = nil;
+	as_release(schedulerCondition);
+	schedulerCondition = nil;
+}
+
+- (void) wakeSchedulerThread
+{
+	NSCondition* condition;
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		// Add new actions
-		for(OALAction* action in actionsToAdd)
+		condition = as_retain(schedulerCondition);
+	}
+	[condition lock];
+	schedulerWake = YES;
+	[condition signal];
+	[condition unlock];
+	as_release(condition);
+}
+
+- (void) schedulerLoop:(NSCondition*) condition
+{
+	as_autoreleasepool_start(threadPool);
+	NSThread* thread = [NSThread currentThread];
+	[NSThread setThreadPriority:kSchedulerThreadPriority];
+
+	while(![thread isCancelled])
+	{
+		[condition lock];
+		while(!schedulerWake && ![thread isCancelled])
+		{
+			[condition wait];
+		}
+		if(![thread isCancelled])
 		{
-			// But only if they haven't been stopped already
-			if(action.running)
+			schedulerWake = NO;
+		}
+		[condition unlock];
+
+		uint64_t deadline = mach_absolute_time();
+		bool running = YES;
+		while(running && ![thread isCancelled])
+		{
+			as_autoreleasepool_start(pool);
+			running = [self stepActions];
+			as_autoreleasepool_end(pool);
+
+			// Sleep until the next step is due. If this step ran late, don't try to
+			// make up the missed steps: the next one covers the elapsed time.
+			uint64_t interval = mach_absolute_from_seconds(self.schedulerStepInterval);
+			uint64_t now = mach_absolute_time();
+			deadline += interval;
+			if(deadline <= now)
 			{
-				NSUInteger index = [targets indexOfObject:action.target];
-				if(NSNotFound == index)
-				{
-					// Since this target has no running actions yet, add the support
-					// structure to keep track of it.
-					index = [targets count];
-					[targets addObject:action.target];
-					[targetActions addObject:[NSMutableArray arrayWithCapacity:5]];
-				}
+				deadline = now + interval;
+			}
+			mach_wait_until(deadline);
+		}
+	}
+	as_autoreleasepool_end(threadPool);
+}
+
+
+#pragma mark Stepping
 
-				// Get the list of actions operating on this target and add the new action.
-				NSMutableArray* actions = [targetActions objectAtIndex:index];
-				[actions addObject:action];
+- (bool) hasRunningActions
+{
+	return CFDictionaryGetCount(targetActions) > 0 || oal_tween_engine_count(tweens) > 0;
+}
+
+- (bool) stepActions
+{
+	OPTIONALLY_SYNCHRONIZED(stepLock)
+	{
+		float elapsedTime = 0;
+		OPTIONALLY_SYNCHRONIZED(self)
+		{
+			if(kOALActionClockRealTime != clockMode)
+			{
+				// The clock was changed while this step was waiting for its turn.
+				return NO;
 			}
+
+			// Get the time elapsed and update timestamp.
+			// If there was a break in timing (lastTimestamp == 0), assume 0 time has elapsed.
+			uint64_t currentTime = mach_absolute_time();
+			if(lastTimestamp > 0)
+			{
+				elapsedTime = (float)mach_absolute_difference_seconds(currentTime, lastTimestamp);
+			}
+			lastTimestamp = currentTime;
 		}
-		// All actions have been added.  Clear the "add" list.
-		[actionsToAdd removeAllObjects];
-		
 
-		// Remove stopped actions
-		for(OALAction* action in actionsToRemove)
+		return [self stepActionsBy:elapsedTime];
+	}
+}
+
+- (bool) stepActionsBy:(float) elapsedTime
+{
+	OPTIONALLY_SYNCHRONIZED(stepLock)
+	{
+		NSMutableArray* actionsToUpdate = [NSMutableArray array];
+		NSMutableData* updateGenerations = [NSMutableData data];
+		OPTIONALLY_SYNCHRONIZED(self)
 		{
-			NSUInteger index = [targets indexOfObject:action.target];
-			if(NSNotFound != index)
+			// Add new actions
+			for(OALAction* action in actionsToAdd)
 			{
-				// Remove the action.
-				NSMutableArray* actions = [targetActions objectAtIndex:index];
-				[actions removeObject:action];
-				if([actions count] == 0)
+				// But only if they haven't been stopped already
+				if(action.running)
 				{
-					// If there are no more actions for this target, stop tracking it.
-					[targets removeObjectAtIndex:index];
-					[targetActions removeObjectAtIndex:index];
-					
-					// If there are no more actions running, stop the master timer.
-					if([targets count] == 0)
+					if(OAL_TWEEN_INVALID_HANDLE != action.tweenHandle)
 					{
-						[stepTimer invalidate];
-						stepTimer = nil;
-						break;
+						// The action was stopped and restarted before its removal was processed.
+						oal_tween_engine_remove(tweens, action.tweenHandle);
+						action.tweenHandle = OAL_TWEEN_INVALID_HANDLE;
+						releaseBinding((as_bridge void*) action);
+					}
+
+					// Actions that just change one property run in the tween engine.
+					float startValue;
+					float endValue;
+					oal_ease_type ease;
+					const oal_ease_table* curve;
+					if([action tweenStartValue:&startValue endValue:&endValue ease:&ease curve:&curve])
+					{
+						void* binding = retainBinding(action);
+						action.tweenHandle = oal_tween_engine_add(tweens, startValue, endValue, action.duration, ease, curve, binding);
+						if(OAL_TWEEN_INVALID_HANDLE != action.tweenHandle)
+						{
+							continue;
+						}
+						releaseBinding(binding);
+					}
+
+					NSMutableArray* actions = (as_bridge NSMutableArray*) CFDictionaryGetValue(targetActions, (as_bridge void*) action.target);
+					if(nil == actions)
+					{
+						// Since this target has no running actions yet, add the support
+						// structure to keep track of it.
+						actions = [NSMutableArray arrayWithCapacity:5];
+						CFDictionarySetValue(targetActions, (as_bridge void*) action.target, (as_bridge void*) actions);
+					}
+
+					// Add the new action to the list of actions operating on this target,
+					// unless it was restarted while still in the list.
+					if(![actions containsObject:action])
+					{
+						[actions addObject:action];
 					}
 				}
 			}
-		}
-		[actionsToRemove removeAllObjects];
-		
-		// Get the time elapsed and update timestamp.
-		// If there was a break in timing (lastTimestamp == 0), assume 0 time has elapsed.
-		uint64_t currentTime = mach_absolute_time();
-		float elapsedTime = 0;
-		if(lastTimestamp > 0)
-		{
-			elapsedTime = (float)mach_absolute_difference_seconds(currentTime, lastTimestamp);
-		}
-		lastTimestamp = currentTime;
+			// All actions have been added.  Clear the "add" list.
+			[actionsToAdd removeAllObjects];
+			
 
-		// Update all remaining actions, if any
-		for(NSMutableArray* actions in targetActions)
-		{
-			for(OALAction* action in actions)
+			// Remove stopped actions
+			for(OALAction* action in actionsToRemove)
 			{
-				action.elapsed += elapsedTime;
-				float proportionComplete = action.elapsed / action.duration;
-				if(proportionComplete < 1.0f)
+				if(action.running)
 				{
-					[action updateCompletion:proportionComplete];
+					// Restarted since it was stopped, so it has already been re-added.
+					continue;
 				}
-				else
+				if(OAL_TWEEN_INVALID_HANDLE != action.tweenHandle)
 				{
-					[action updateCompletion:1.0f];
-					[action stopAction];
+					// Tweens that finished on their own have already been removed.
+					oal_tween_engine_remove(tweens, action.tweenHandle);
+					action.tweenHandle = OAL_TWEEN_INVALID_HANDLE;
+					releaseBinding((as_bridge void*) action);
+					continue;
+				}
+
+				NSMutableArray* actions = (as_bridge NSMutableArray*) CFDictionaryGetValue(targetActions, (as_bridge void*) action.target);
+				if(nil != actions)
+				{
+					// Remove the action.
+					[actions removeObject:action];
+					if([actions count] == 0)
+					{
+						// If there are no more actions for this target, stop tracking it.
+						CFDictionaryRemoveValue(targetActions, (as_bridge void*) action.target);
+					}
+				}
+			}
+			[actionsToRemove removeAllObjects];
+
+			// If there are no more actions running, stop stepping.
+			if(![self hasRunningActions])
+			{
+				return NO;
+			}
+
+			uint32_t tweenCount = oal_tween_engine_count(tweens);
+			if(tweenCount > tweenResults->capacity)
+			{
+				OALTweenResult* results = realloc(tweenResults->results, tweenCount * sizeof(*results));
+				if(NULL == results)
+				{
+					OAL_LOG_ERROR(@"%@: Could not allocate space for %d tween values", self, tweenCount);
+					return YES;
+				}
+				tweenResults->results = results;
+				tweenResults->capacity = tweenCount;
+			}
+			tweenResults->count = 0;
+			oal_tween_engine_step(tweens, elapsedTime, recordTween, tweenResults);
+
+			for(NSMutableArray* actions in [(as_bridge NSDictionary*) targetActions objectEnumerator])
+			{
+				for(OALAction* action in actions)
+				{
+					uint32_t generation = action.runGeneration;
+					[actionsToUpdate addObject:action];
+					[updateGenerations appendBytes:&generation length:sizeof(generation)];
 				}
 			}
 		}
+
+		// Update the actions without holding this object's lock: targets lock themselves
+		// while they are changed, and they start and stop actions while locked.
+		// Actions can be stopped or restarted from other threads in the meantime,
+		// so only those still on the run they were recorded in are updated.
+		ALContext* context = [OpenALManager sharedInstance].currentContext;
+		[context deferUpdates];
+		for(uint32_t i = 0; i < tweenResults->count; i++)
+		{
+			applyTween(&tweenResults->results[i]);
+		}
+		const uint32_t* generations = [updateGenerations bytes];
+		NSUInteger numActions = [actionsToUpdate count];
+		for(NSUInteger i = 0; i < numActions; i++)
+		{
+			OALAction* action = [actionsToUpdate objectAtIndex:i];
+			if(!action.running || action.runGeneration != generations[i])
+			{
+				continue;
+			}
+			action.elapsed += elapsedTime;
+			float proportionComplete = action.elapsed / action.duration;
+			if(proportionComplete < 1.0f)
+			{
+				[action updateCompletion:proportionComplete];
+			}
+			else
+			{
+				[action updateCompletion:1.0f];
+				[action stopAction];
+			}
+		}
+		[context processUpdates];
+		return YES;
 	}
 }
 
@@ -217,23 +770,32 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 
 - (void) notifyActionStarted:(OALAction*) action
 {
+	bool wake = NO;
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		[actionsToAdd addObject:action];
 		
-		// Start the timer if it hasn't been started yet and there are actions to perform.
-		if([targets count] == 0 && [actionsToAdd count] == 1)
+		// Start stepping if it hasn't been started yet and there are actions to perform.
+		// Other clocks are stepped by the application.
+		if(kOALActionClockRealTime == clockMode && ![self hasRunningActions] && [actionsToAdd count] == 1)
 		{
-			stepTimer = [NSTimer scheduledTimerWithTimeInterval:kActionStepInterval
-														 target:self
-													   selector:@selector(step:)
-													   userInfo:nil
-														repeats:YES];
+			if(runsOnSchedulerThread)
+			{
+				wake = YES;
+			}
+			else if(nil == stepTimer)
+			{
+				[self startStepTimer];
+			}
 
 			// Reset timestamp since we have been off for awhile.
 			lastTimestamp = 0;
 		}
 	}
+	if(wake)
+	{
+		[self wakeSchedulerThread];
+	}
 }
 
 - (void) notifyActionStopped:(OALAction*) action
@@ -0,0 +1,137 @@
+//
+//  OALActionTimeline.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import "OALAction.h"
+#import "ObjectALConfig.h"
+
+
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+
+struct oal_timeline;
+struct oal_timeline_cursor;
+
+
+#pragma mark OALActionTimeline
+
+/**
+ * A tree of actions compiled into a flat timeline. <br>
+ *
+ * Running nested OALSequentialActions and OALConcurrentActions walks the whole tree
+ * on every update. A timeline is compiled once into a list of segments with absolute
+ * start times, so running it only touches the segments active at the time.
+ * One timeline can be run on any number of targets through OALTimelineAction. <br>
+ *
+ * Only property actions (OALPropertyAction and the audio property actions), eases of
+ * property actions, sequential and concurrent sets of these, and actions with no
+ * duration (such as OALCallAction) can be compiled.
+ */
+@interface OALActionTimeline : NSObject
+{
+	/** The action tree this timeline was compiled from. */
+	OALAction* action_;
+
+	/** The property keys ramped by the timeline, indexed by channel. */
+	NSMutableArray* propertyKeys_;
+
+	/** The compiled timeline. */
+	struct oal_timeline* timeline_;
+}
+
+/** The action tree this timeline was compiled from.
+ * Don't run or modify it while the timeline is in use.
+ */
+@property(nonatomic,readonly,retain) OALAction* action;
+
+/** The property keys ramped by this timeline. */
+@property(nonatomic,readonly,retain) NSArray* propertyKeys;
+
+/** The duration of this timeline, in seconds. */
+@property(nonatomic,readonly,assign) float duration;
+
+/** (INTERNAL USE) The compiled timeline. */
+@property(nonatomic,readonly,assign) struct oal_timeline* timeline;
+
+/** Compile a tree of actions into a timeline.
+ *
+ * @param action The root of the tree.
+ * @return A new timeline, or nil if the tree can't be compiled.
+ */
++ (OALActionTimeline*) timelineWithAction:(OALAction*) action;
+
+/** Initialize a timeline by compiling a tree of actions.
+ *
+ * @param action The root of the tree.
+ * @return The initialized timeline, or nil if the tree can't be compiled.
+ */
+- (id) initWithAction:(OALAction*) action;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALTimelineAction
+
+/**
+ * Runs a compiled timeline on a target. <br>
+ *
+ * Each target needs its own OALTimelineAction, but they can all share one timeline.
+ */
+@interface OALTimelineAction : OALAction
+{
+	/** The timeline being run. */
+	OALActionTimeline* timeline_;
+
+	/** Accessors for each of the timeline's property keys on the current target. */
+	NSMutableArray* channels_;
+
+	/** This action's position in the timeline. */
+	struct oal_timeline_cursor* cursor_;
+}
+
+/** The timeline being run. */
+@property(nonatomic,readonly,retain) OALActionTimeline* timeline;
+
+/** Create an action that runs a timeline.
+ *
+ * @param timeline The timeline to run.
+ * @return A new action.
+ */
++ (OALTimelineAction*) actionWithTimeline:(OALActionTimeline*) timeline;
+
+/** Initialize an action that runs a timeline.
+ *
+ * @param timeline The timeline to run.
+ * @return The initialized action.
+ */
+- (id) initWithTimeline:(OALActionTimeline*) timeline;
+
+@end
+
+#endif /* !OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
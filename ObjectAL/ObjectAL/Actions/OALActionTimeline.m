@@ -0,0 +1,316 @@
+//
+//  OALActionTimeline.m
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import "OALActionTimeline.h"
+#import "OALAction+Private.h"
+#import "OALUtilityActions.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+#import "oal_timeline.h"
+
+
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+
+#pragma mark OALActionTimeline
+
+/** \cond */
+@interface OALActionTimeline ()
+
+@property(nonatomic,readwrite,retain) OALAction* action;
+
+/** Add an action and all of its children to the timeline.
+ *
+ * @param action The action to add.
+ * @param startTime When the action starts, in seconds from the start of the timeline.
+ * @param endTime Filled in with when the action ends.
+ * @return TRUE if the action could be added.
+ */
+- (bool) addAction:(OALAction*) action
+		 startTime:(float) startTime
+		   endTime:(float*) endTime;
+
+@end
+/** \endcond */
+
+
+@implementation OALActionTimeline
+
+#pragma mark Object Management
+
++ (OALActionTimeline*) timelineWithAction:(OALAction*) action
+{
+	return as_autorelease([[self alloc] initWithAction:action]);
+}
+
+- (id) initWithAction:(OALAction*) action
+{
+	if(nil != (self = [super init]))
+	{
+		self.action = action;
+		propertyKeys_ = [[NSMutableArray alloc] initWithCapacity:4];
+		timeline_ = oal_timeline_create();
+		if(NULL == timeline_)
+		{
+			OAL_LOG_ERROR(@"%@: Could not allocate timeline", self);
+			goto initFailed;
+		}
+
+		float endTime;
+		if(![self addAction:action startTime:0 endTime:&endTime])
+		{
+			goto initFailed;
+		}
+		oal_timeline_compile(timeline_);
+	}
+	return self;
+
+initFailed:
+	as_release(self);
+	return nil;
+}
+
+- (void) dealloc
+{
+	oal_timeline_destroy(timeline_);
+	as_release(propertyKeys_);
+	as_release(action_);
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+@synthesize action = action_;
+@synthesize propertyKeys = propertyKeys_;
+@synthesize timeline = timeline_;
+
+- (float) duration
+{
+	return oal_timeline_duration(timeline_);
+}
+
+
+#pragma mark Compiling
+
+- (bool) addAction:(OALAction*) action
+		 startTime:(float) startTime
+		   endTime:(float*) endTime
+{
+	if([action isKindOfClass:[OALSequentialActions class]])
+	{
+		// Each child starts when the one before it ends.
+		float time = startTime;
+		for(OALAction* child in ((OALSequentialActions*)action).actions)
+		{
+			if(![self addAction:child startTime:time endTime:&time])
+			{
+				return NO;
+			}
+		}
+		*endTime = time;
+		return YES;
+	}
+
+	if([action isKindOfClass:[OALConcurrentActions class]])
+	{
+		// All children start together, and the set ends with the longest one.
+		float latest = startTime;
+		for(OALAction* child in ((OALConcurrentActions*)action).actions)
+		{
+			float childEnd;
+			if(![self addAction:child startTime:startTime endTime:&childEnd])
+			{
+				return NO;
+			}
+			if(childEnd > latest)
+			{
+				latest = childEnd;
+			}
+		}
+		*endTime = latest;
+		return YES;
+	}
+
+	oal_timeline_segment segment;
+	memset(&segment, 0, sizeof(segment));
+	segment.start = startTime;
+	segment.duration = action.duration;
+
+	NSString* key = [action tweenPropertyKey];
+	if(nil != key && [action tweenStartValue:&segment.start_value
+									endValue:&segment.end_value
+										ease:&segment.ease
+									   curve:&segment.curve])
+	{
+		NSUInteger channel = [propertyKeys_ indexOfObject:key];
+		if(NSNotFound == channel)
+		{
+			channel = [propertyKeys_ count];
+			[propertyKeys_ addObject:key];
+		}
+		segment.channel = (uint32_t)channel;
+	}
+	else if(action.duration <= 0)
+	{
+		// Instant actions are run as they are at their point in the timeline.
+		segment.duration = 0;
+		segment.event = (as_bridge void*) action;
+	}
+	else
+	{
+		OAL_LOG_ERROR(@"%@: Cannot compile %@ into a timeline. Only property actions, eases of property actions, sequential and concurrent actions, and instant actions can be compiled.", self, action);
+		return NO;
+	}
+
+	if(!oal_timeline_add(timeline_, &segment))
+	{
+		OAL_LOG_ERROR(@"%@: Could not add %@ to the timeline", self, action);
+		return NO;
+	}
+	*endTime = startTime + segment.duration;
+	return YES;
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OALTimelineAction
+
+/** \cond */
+@interface OALTimelineAction ()
+
+@property(nonatomic,readwrite,retain) OALActionTimeline* timeline;
+
+@end
+/** \endcond */
+
+@implementation OALTimelineAction
+
+#pragma mark Timeline Callbacks
+
+static float readChannel(void* context, uint32_t channel)
+{
+	OALTimelineAction* action = (as_bridge OALTimelineAction*) context;
+	return [(OALPropertyAction*)[action->channels_ objectAtIndex:channel] readValue];
+}
+
+static void writeChannel(void* context, uint32_t channel, float value)
+{
+	OALTimelineAction* action = (as_bridge OALTimelineAction*) context;
+	[(OALPropertyAction*)[action->channels_ objectAtIndex:channel] applyTweenValue:value];
+}
+
+static void fireEvent(void* context, void* event)
+{
+	OALTimelineAction* action = (as_bridge OALTimelineAction*) context;
+	[(as_bridge OALAction*) event runWithTarget:action.target];
+}
+
+static const oal_timeline_callbacks g_timelineCallbacks =
+{
+	readChannel,
+	writeChannel,
+	fireEvent,
+};
+
+
+#pragma mark Object Management
+
++ (OALTimelineAction*) actionWithTimeline:(OALActionTimeline*) timeline
+{
+	return as_autorelease([[self alloc] initWithTimeline:timeline]);
+}
+
+- (id) initWithTimeline:(OALActionTimeline*) timeline
+{
+	if(nil != (self = [super initWithDuration:timeline.duration]))
+	{
+		self.timeline = timeline;
+
+		// Each property gets an action that is never run, but holds its accessors.
+		channels_ = [[NSMutableArray alloc] initWithCapacity:[timeline.propertyKeys count]];
+		for(NSString* key in timeline.propertyKeys)
+		{
+			[channels_ addObject:[OALPropertyAction actionWithDuration:0 propertyKey:key endValue:0]];
+		}
+
+		cursor_ = oal_timeline_cursor_create(timeline.timeline);
+		if(NULL == cursor_)
+		{
+			OAL_LOG_ERROR(@"%@: Could not allocate timeline cursor", self);
+			goto initFailed;
+		}
+	}
+	return self;
+
+initFailed:
+	as_release(self);
+	return nil;
+}
+
+- (void) dealloc
+{
+	oal_timeline_cursor_destroy(cursor_);
+	as_release(channels_);
+	as_release(timeline_);
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+@synthesize timeline = timeline_;
+
+
+#pragma mark Functions
+
+- (void) prepareWithTarget:(id) target
+{
+	[super prepareWithTarget:target];
+
+	for(OALPropertyAction* channel in channels_)
+	{
+		[channel resolveAccessorsForTarget:target];
+	}
+	oal_timeline_cursor_reset(cursor_);
+}
+
+- (void) updateCompletion:(float) proportionComplete
+{
+	oal_timeline_cursor_advance_to(cursor_,
+								   proportionComplete * self.duration,
+								   &g_timelineCallbacks,
+								   (as_bridge void*) self);
+}
+
+@end
+
+#endif /* !OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
@@ -0,0 +1,120 @@
+//
+//  OALParameterRamp.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import "OALAction.h"
+
+
+#pragma mark OALParameterRamp
+
+/**
+ * Moves one property of a target to a new value over time, then notifies a callback. <br>
+ *
+ * Unlike building a new action sequence for every change, a ramp keeps one action
+ * and reuses it each time it is retargeted, so fading, panning and pitch bending
+ * don't allocate anything once the ramp exists. Retargeting a running ramp starts
+ * from the property's current value and drops the old callback.
+ */
+@interface OALParameterRamp : NSObject
+{
+	/** The property key being ramped. */
+	NSString* propertyKey_;
+
+	/** The action that is reused for each ramp. */
+	id action_;
+
+	/** The object to notify when the ramp completes. */
+	id completionTarget_;
+
+	/** The selector to call on completionTarget_. */
+	SEL completionSelector_;
+}
+
+/** The object whose property is being ramped. */
+@property(nonatomic,readonly,assign) id target;
+
+/** The property being ramped. */
+@property(nonatomic,readonly,retain) NSString* propertyKey;
+
+/** If TRUE, the ramp is currently running. */
+@property(nonatomic,readonly,assign) bool running;
+
+/** Create a ramp. The target is not retained, so it should normally own the ramp.
+ *
+ * @param target The object whose property will be ramped.
+ * @param propertyKey The property to ramp (it must be a float or double property).
+ * @return A new ramp.
+ */
++ (OALParameterRamp*) rampWithTarget:(id) target propertyKey:(NSString*) propertyKey;
+
+/** Initialize a ramp. The target is not retained, so it should normally own the ramp.
+ *
+ * @param target The object whose property will be ramped.
+ * @param propertyKey The property to ramp (it must be a float or double property).
+ * @return The initialized ramp.
+ */
+- (id) initWithTarget:(id) target propertyKey:(NSString*) propertyKey;
+
+/** Ramp linearly from the current value to a new one.
+ * Any ramp already in progress is stopped without notifying its callback.
+ *
+ * @param value The value to ramp to.
+ * @param duration The duration of the ramp in seconds.
+ * @param target The object to notify when the ramp completes (can be nil).
+ * @param selector The selector to call when the ramp completes.
+ *                 The selector must take one parameter (the ramped object).
+ */
+- (void) rampTo:(float) value
+	   duration:(float) duration
+		 target:(id) target
+	   selector:(SEL) selector;
+
+/** Ramp along a curve from the current value to a new one.
+ * Any ramp already in progress is stopped without notifying its callback.
+ *
+ * @param value The value to ramp to.
+ * @param duration The duration of the ramp in seconds.
+ * @param shape The shape of the curve to follow.
+ * @param phase What phase of the ramp to apply the curve to.
+ * @param target The object to notify when the ramp completes (can be nil).
+ * @param selector The selector to call when the ramp completes.
+ *                 The selector must take one parameter (the ramped object).
+ */
+- (void) rampTo:(float) value
+	   duration:(float) duration
+		  shape:(OALEaseShape) shape
+		  phase:(OALEasePhase) phase
+		 target:(id) target
+	   selector:(SEL) selector;
+
+/** Stop the ramp where it is, without notifying its callback.
+ */
+- (void) stop;
+
+@end
@@ -0,0 +1,289 @@
+//
+//  OALParameterRamp.m
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import "OALParameterRamp.h"
+#import "OALAction+Private.h"
+#import "OALUtilityActions.h"
+#import "ARCSafe_MemMgmt.h"
+
+
+@interface OALParameterRamp ()
+
+@property(nonatomic,readwrite,assign) id target;
+@property(nonatomic,readwrite,retain) NSString* propertyKey;
+
+/** (INTERNAL USE) Notify the completion target that the ramp has finished.
+ */
+- (void) notifyCompletion;
+
+/** (INTERNAL USE) Stop the ramp and set up a new one.
+ *
+ * @param value The value to ramp to.
+ * @param duration The duration of the ramp in seconds.
+ * @param shape The shape of the curve to follow.
+ * @param phase What phase of the ramp to apply the curve to.
+ * @param hasEase If FALSE, shape and phase are ignored and the ramp is linear.
+ * @param target The object to notify when the ramp completes.
+ * @param selector The selector to call when the ramp completes.
+ */
+- (void) rampTo:(float) value
+	   duration:(float) duration
+		   ease:(OALEaseShape) shape
+		  phase:(OALEasePhase) phase
+		hasEase:(bool) hasEase
+		 target:(id) target
+	   selector:(SEL) selector;
+
+@end
+
+
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+
+#pragma mark -
+#pragma mark OALRampAction
+
+/** \cond */
+/**
+ * (INTERNAL USE) The property action that a ramp reuses.
+ * It runs as a tween, and tells its ramp when it finishes.
+ */
+@interface OALRampAction : OALPropertyAction
+{
+	oal_ease_type ease_;
+	as_unsafe_unretained OALParameterRamp* ramp_;
+}
+
+/** The curve to follow. */
+@property(nonatomic,readwrite,assign) oal_ease_type ease;
+
+/** The ramp to notify when this action finishes. */
+@property(nonatomic,readwrite,assign) OALParameterRamp* ramp;
+
+@end
+
+@implementation OALRampAction
+
+@synthesize ease = ease_;
+@synthesize ramp = ramp_;
+
+- (void) updateCompletion:(float) proportionComplete
+{
+	// A ramp with no duration jumps straight to its end value.
+	if(self.duration <= 0)
+	{
+		proportionComplete = 1.0f;
+	}
+	[super updateCompletion:oal_ease_function_for_type(ease_)(proportionComplete)];
+}
+
+- (bool) tweenStartValue:(float*) startValue
+				endValue:(float*) endValue
+					ease:(oal_ease_type*) ease
+				   curve:(const oal_ease_table**) curve
+{
+	*startValue = self.startValue;
+	*endValue = self.endValue;
+	*ease = ease_;
+	*curve = NULL;
+	return YES;
+}
+
+- (void) stopAction
+{
+	bool wasRunning = self.running;
+	[super stopAction];
+
+	// Notify after stopping so that the ramp can be restarted from the callback.
+	if(wasRunning)
+	{
+		[ramp_ notifyCompletion];
+	}
+}
+
+@end
+/** \endcond */
+
+#endif /* !OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
+
+
+#pragma mark -
+#pragma mark OALParameterRamp
+
+@implementation OALParameterRamp
+
+#pragma mark Object Management
+
++ (OALParameterRamp*) rampWithTarget:(id) target propertyKey:(NSString*) propertyKey
+{
+	return as_autorelease([[self alloc] initWithTarget:target propertyKey:propertyKey]);
+}
+
+- (id) initWithTarget:(id) target propertyKey:(NSString*) propertyKey
+{
+	if(nil != (self = [super init]))
+	{
+		self.target = target;
+		self.propertyKey = propertyKey;
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+		OALRampAction* action = [[OALRampAction alloc] initWithDuration:0
+															 propertyKey:propertyKey
+																endValue:0];
+		action.ramp = self;
+		action_ = action;
+#endif /* !OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[self stop];
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+	((OALRampAction*)action_).ramp = nil;
+#endif /* !OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
+	as_release(action_);
+	as_release(propertyKey_);
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+@synthesize target = target_;
+@synthesize propertyKey = propertyKey_;
+
+- (bool) running
+{
+	return [action_ running];
+}
+
+
+#pragma mark Functions
+
+- (void) rampTo:(float) value
+	   duration:(float) duration
+		 target:(id) target
+	   selector:(SEL) selector
+{
+	[self rampTo:value
+		duration:duration
+			ease:kOALEaseShapeSine
+		   phase:kOALEaseIn
+		 hasEase:NO
+		  target:target
+		selector:selector];
+}
+
+- (void) rampTo:(float) value
+	   duration:(float) duration
+		  shape:(OALEaseShape) shape
+		  phase:(OALEasePhase) phase
+		 target:(id) target
+	   selector:(SEL) selector
+{
+	[self rampTo:value
+		duration:duration
+			ease:shape
+		   phase:phase
+		 hasEase:YES
+		  target:target
+		selector:selector];
+}
+
+- (void) rampTo:(float) value
+	   duration:(float) duration
+		   ease:(OALEaseShape) shape
+		  phase:(OALEasePhase) phase
+		hasEase:(bool) hasEase
+		 target:(id) target
+	   selector:(SEL) selector
+{
+	[self stop];
+
+	completionTarget_ = target;
+	completionSelector_ = selector;
+
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+	// Reuse the same action, starting from wherever the property is now.
+	OALRampAction* action = action_;
+	action.startValue = NAN;
+	action.endValue = value;
+	action.duration = duration;
+	action.ease = hasEase ? [OALEaseAction easeTypeForShape:shape phase:phase] : OAL_EASE_LINEAR;
+	[action runWithTarget:target_];
+#else
+	// cocos2d actions can't be rerun with new values, so build a new sequence.
+	OALAction* action = [OALPropertyAction actionWithDuration:duration
+												  propertyKey:propertyKey_
+													 endValue:value];
+	if(hasEase)
+	{
+		action = [OALEaseAction actionWithShape:shape phase:phase action:action];
+	}
+	action_ = as_retain([OALSequentialActions actions:
+						 action,
+						 [OALCallAction actionWithCallTarget:self selector:@selector(notifyCompletion)],
+						 nil]);
+	[action_ runWithTarget:target_];
+#endif /* !OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
+}
+
+- (void) stop
+{
+	completionTarget_ = nil;
+	completionSelector_ = NULL;
+	[action_ stopAction];
+#if OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+	// The sequence calls back to this ramp, so don't keep it around.
+	as_release(action_);
+	action_ = nil;
+#endif /* OBJECTAL_CFG_USE_COCOS2D_ACTIONS */
+}
+
+
+#pragma mark Internal Use
+
+- (void) notifyCompletion
+{
+	id target = completionTarget_;
+	SEL selector = completionSelector_;
+	completionTarget_ = nil;
+	completionSelector_ = NULL;
+
+	if(nil != target && NULL != selector)
+	{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Warc-performSelector-leaks"
+		[target performSelector:selector withObject:target_];
+#pragma clang diagnostic pop
+	}
+}
+
+@end
@@ -32,6 +32,8 @@
 #import "OALAudioTrackNotifications.h"
 #import "OALSuspendHandler.h"
 
+@class OALParameterRamp;
+
 /**
  * Plays an audio track via AVAudioPlayer.
  * Unlike AVAudioPlayer, however, it can be re-used to play another file.
@@ -72,11 +74,11 @@
 	bool playing;
 	NSTimeInterval currentTime;
 	
-	/** The current action being applied to gain. */
-	OALAction* gainAction;
+	/** The reusable ramp applied to gain. */
+	OALParameterRamp* gainRamp;
 	
-	/** The current action being applied to pan. */
-	OALAction* panAction;
+	/** The reusable ramp applied to pan. */
+	OALParameterRamp* panRamp;
 	
 	/** Handles suspending and interrupting for this object. */
 	OALSuspendHandler* suspendHandler;
@@ -28,10 +28,9 @@
 //
 
 #import "OALAudioTrack.h"
-#import "OALAudioActions.h"
 #import "OALAudioTracks.h"
 #import "OALTools.h"
-#import "OALUtilityActions.h"
+#import "OALParameterRamp.h"
 #import "ObjectALMacros.h"
 #import "ARCSafe_MemMgmt.h"
 
@@ -253,10 +252,10 @@
 	as_release(operationQueue);
 	as_release(currentlyLoadedUrl);
 	as_release(simulatorPlayerRef);
-	[gainAction stopAction];
-	as_release(gainAction);
-	[panAction stopAction];
-	as_release(panAction);
+	[gainRamp stop];
+	as_release(gainRamp);
+	[panRamp stop];
+	as_release(panRamp);
 	as_release(suspendHandler);
 	as_superdealloc();
 }
@@ -818,13 +817,11 @@
 	// Must always be synchronized
 	@synchronized(self)
 	{
-		[self stopFade];
-		gainAction = [OALSequentialActions actions:
-                      [OALPropertyAction gainActionWithDuration:duration endValue:value],
-                      [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
-                      nil];
-        gainAction = as_retain(gainAction);
-		[gainAction runWithTarget:self];
+		if(nil == gainRamp)
+		{
+			gainRamp = [[OALParameterRamp alloc] initWithTarget:self propertyKey:@"gain"];
+		}
+		[gainRamp rampTo:value duration:duration target:target selector:selector];
 	}
 }
 
@@ -833,9 +830,7 @@
 	// Must always be synchronized
 	@synchronized(self)
 	{
-		[gainAction stopAction];
-		as_release(gainAction);
-		gainAction = nil;
+		[gainRamp stop];
 	}
 }
 
@@ -847,13 +842,11 @@
     // Must always be synchronized
     @synchronized(self)
     {
-        [self stopPan];
-        panAction = [OALSequentialActions actions:
-                     [OALPropertyAction panActionWithDuration:duration endValue:value],
-                     [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
-                     nil];
-        panAction = as_retain(panAction);
-        [panAction runWithTarget:self];
+        if(nil == panRamp)
+        {
+            panRamp = [[OALParameterRamp alloc] initWithTarget:self propertyKey:@"pan"];
+        }
+        [panRamp rampTo:value duration:duration target:target selector:selector];
     }
 }
 
@@ -862,9 +855,7 @@
     // Must always be synchronized
     @synchronized(self)
     {
-        [panAction stopAction];
-        as_release(panAction);
-        panAction = nil;
+        [panRamp stop];
     }
 }
 
@@ -34,6 +34,19 @@
 #import "ALSoundSource.h"
 #import "ALChannelSource.h"
 #import "OALAudioTrack.h"
+#import "OALPreloadManifest.h"
+
+
+/** How a preloaded sound effect is held in memory. */
+typedef enum
+{
+	/** 16-bit PCM (or whatever format the file decodes to), ready to play. */
+	kOALEffectResidencyPCM,
+	/** IMA ADPCM, about a quarter of the size of 16-bit PCM. Played directly if
+	 * OpenAL supports it, otherwise decoded to PCM when played (see decodedEffectsCacheSize).
+	 */
+	kOALEffectResidencyADPCM,
+} OALEffectResidency;
 
 
 #pragma mark OALSimpleAudio
@@ -70,6 +83,22 @@
 	ALChannelSource* channel;
 	/** Cache for preloaded sound samples. */
 	NSMutableDictionary* preloadCache;
+	/** The distinct effects in the preload cache, keyed by a hash of their decoded audio. */
+	NSMutableDictionary* uniqueEffects;
+	/** How many preload cache entries share each distinct effect. */
+	NSCountedSet* uniqueEffectRefs;
+	/** The content key of each preload cache entry. */
+	NSMutableDictionary* effectContentKeys;
+	/** Bytes of audio data not loaded because an identical effect was already cached. */
+	unsigned long long preloadCacheBytesSaved;
+	/** Decoded buffers of ADPCM effects, least recently played first. */
+	NSMutableArray* decodedEffects;
+	NSUInteger decodedEffectsCacheSize;
+	unsigned long long preloadMemoryCeiling;
+	/** The paths of the effects loaded by each manifest group (NSSet), by group name. */
+	NSMutableDictionary* manifestGroups;
+	/** The number of loaded manifest groups using each effect path. */
+	NSCountedSet* manifestPathRefs;
 #if NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS
 	/** Queue for preloading and async operations that use blocks.
 	 * This ensures all operations are safe because they are guaranteed to run
@@ -189,6 +218,32 @@
 /** The number of items currently in the preload cache. */
 @property(nonatomic,readonly,assign) NSUInteger preloadCacheCount;
 
+/** The number of distinct sounds in the preload cache. Effects loaded from different
+ * files whose decoded audio is identical share a single buffer.
+ */
+@property(nonatomic,readonly,assign) NSUInteger preloadCacheUniqueCount;
+
+/** The number of bytes of audio data the preload cache is saving by sharing
+ * buffers between identical effects.
+ */
+@property(nonatomic,readonly,assign) unsigned long long preloadCacheBytesSaved;
+
+/** The maximum number of effects preloaded with kOALEffectResidencyADPCM that are
+ * kept decoded after being played (default 8). When more are played, the decoded
+ * data of the least recently played one is released once it stops playing. <br>
+ *
+ * Has no effect if OpenAL can play ADPCM directly.
+ */
+@property(nonatomic,readwrite,assign) NSUInteger decodedEffectsCacheSize;
+
+/** The most decoded audio, in bytes, that preloadEffects will hold while waiting
+ * to turn it into buffers (default 64 MB, 0 = no limit). <br>
+ *
+ * Effects are decoded on several threads at once, but buffers are created one at
+ * a time. When this much is waiting, decoding pauses until buffers catch up.
+ */
+@property(nonatomic,readwrite,assign) unsigned long long preloadMemoryCeiling;
+
 /** Set to YES to manually suspend the sound system. */
 @property(nonatomic,readwrite,assign) bool manuallySuspended;
 
@@ -382,6 +437,23 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALSimpleAudio);
  */
 - (ALBuffer*) preloadEffect:(NSString*) filePath reduceToMono:(bool) reduceToMono;
 
+/** Preload and cache a sound effect for later playback, choosing how it is held in memory. <br>
+ *
+ * kOALEffectResidencyADPCM cuts the memory used by 16-bit effects to about a quarter,
+ * at some cost in quality. It suits large libraries of effects that are rarely played
+ * at the same time. Effects that don't decode to 16-bit mono or stereo are kept as PCM,
+ * and effects that are already loaded are left as they are.
+ *
+ * @param filePath The path containing the sound data.
+ * @param reduceToMono If true, reduce the sample to mono
+ *        (stereo samples don't support panning or positional audio).
+ * @param residency How to hold the effect in memory.
+ * @return TRUE if the effect was loaded.
+ */
+- (bool) preloadEffect:(NSString*) filePath
+		  reduceToMono:(bool) reduceToMono
+			 residency:(OALEffectResidency) residency;
+
 #if NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS
 
 /** Asynchronous preload and cache sound effect for later playback.
@@ -406,8 +478,88 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALSimpleAudio);
 				   reduceToMono:(bool) reduceToMono
 		  progressBlock:(void (^)(NSUInteger progress, NSUInteger successCount, NSUInteger total)) progressBlock;
 
+/** Asynchronous preload and cache multiple sound effects for later playback,
+ * choosing how they are held in memory.
+ *
+ * @param filePaths An NSArray of NSStrings with the paths containing the sound data.
+ * @param reduceToMono If true, reduce the samples to mono
+ *        (stereo samples don't support panning or positional audio).
+ * @param residency How to hold the effects in memory.
+ * @param progressBlock Executed regularly while file loading is in progress.
+ */
+- (void) preloadEffects:(NSArray*) filePaths
+		   reduceToMono:(bool) reduceToMono
+			  residency:(OALEffectResidency) residency
+		  progressBlock:(void (^)(NSUInteger progress, NSUInteger successCount, NSUInteger total)) progressBlock;
+
+/** Asynchronous preload and cache multiple sound effects for later playback,
+ * also reporting how much audio data has been loaded. <br>
+ *
+ * Effects are decoded on one thread per CPU, and loaded into buffers in the order
+ * they finish decoding (see preloadMemoryCeiling).
+ *
+ * @param filePaths An NSArray of NSStrings with the paths containing the sound data.
+ * @param reduceToMono If true, reduce the samples to mono
+ *        (stereo samples don't support panning or positional audio).
+ * @param residency How to hold the effects in memory.
+ * @param progressBlock Executed each time an effect finishes loading (on the main thread,
+ *        unless [OpenALManager sharedInstance].completionMode says otherwise).
+ *        bytesLoaded is the total size of the decoded audio loaded so far
+ *        (effects that were already cached count as 0).
+ */
+- (void) preloadEffects:(NSArray*) filePaths
+		   reduceToMono:(bool) reduceToMono
+			  residency:(OALEffectResidency) residency
+	  byteProgressBlock:(void (^)(NSUInteger progress, NSUInteger successCount, NSUInteger total, unsigned long long bytesLoaded)) progressBlock;
+
+/** Asynchronously preload the effects in one group of a manifest, highest priority first. <br>
+ *
+ * Effects are held the way the manifest asks, unless that would take them over the
+ * memory budget. Then effects that would be PCM are compressed instead (see
+ * kOALEffectResidencyADPCM), and effects that still don't fit are deferred:
+ * they are not preloaded, and will be loaded when first played.
+ * Streamed effects are never preloaded. <br>
+ *
+ * Effects already in the preload cache are kept as they are, but count against the budget.
+ *
+ * @param group The name of the manifest group to load.
+ * @param manifest The manifest.
+ * @param memoryBudget The most audio data, in bytes, the group's effects may take up
+ *        (0 = no limit).
+ * @param progressBlock Executed each time an effect finishes loading (on the main thread,
+ *        unless [OpenALManager sharedInstance].completionMode says otherwise).
+ *        successCount is the number of effects now resident. deferredCount is the number
+ *        of deferred and streamed effects, which will load when played. Any others failed
+ *        to load. bytesLoaded is the memory taken up by the group's effects so far.
+ */
+- (void) loadManifestGroup:(NSString*) group
+			  fromManifest:(OALPreloadManifest*) manifest
+			  memoryBudget:(unsigned long long) memoryBudget
+			 progressBlock:(void (^)(NSUInteger progress, NSUInteger successCount, NSUInteger deferredCount, NSUInteger total, unsigned long long bytesLoaded)) progressBlock;
+
 #endif
 
+/** Unload all effects that were preloaded by a manifest group, except those that
+ * another loaded group also uses. Effects that are still playing stay loaded,
+ * and are unloaded by calling this again. <br>
+ *
+ * Each loaded path keeps a count of the groups using it, so this takes time
+ * proportional to the number of effects in the group, however many other groups
+ * are loaded. Each effect that is unloaded also checks the sources that might be
+ * playing it.
+ *
+ * @param group The name of the manifest group.
+ * @return YES if all of the group's effects were unloaded.
+ */
+- (bool) unloadManifestGroup:(NSString*) group;
+
+/** Check if a manifest group has been loaded (and not unloaded since).
+ *
+ * @param group The name of the manifest group.
+ * @return YES if the group is loaded.
+ */
+- (bool) isManifestGroupLoaded:(NSString*) group;
+
 /** Unload a preloaded effect. Only unloads if no source is currently playing
  * that effect (or paused with the effect loaded).
  *
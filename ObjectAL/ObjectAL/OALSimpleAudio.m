@@ -32,10 +32,20 @@
 #import "ARCSafe_MemMgmt.h"
 #import "OALAudioSession.h"
 #import "OpenALManager.h"
+#import "OALADPCMAudio.h"
+#import "OALAudioData.h"
+#import "OALLoadTelemetry.h"
+#import "oal_hash.h"
 
 // By default, reserve all 32 sources.
 #define kDefaultReservedSources 32
 
+// By default, keep up to 8 ADPCM effects decoded.
+#define kDefaultDecodedEffectsCacheSize 8
+
+// By default, hold up to 64 MB of decoded effects waiting to be loaded into buffers.
+#define kDefaultPreloadMemoryCeiling (64ull * 1024 * 1024)
+
 #pragma mark -
 #pragma mark Private Methods
 
@@ -56,6 +66,74 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_PROTOTYPE(OALSimpleAudio);
  */
 - (ALBuffer*) internalPreloadEffect:(NSString*) filePath reduceToMono:(bool) reduceToMono;
 
+/** (INTERNAL USE) Load a sound effect into the preload cache if it isn't there already.
+ *
+ * @param filePath The path containing the sound data.
+ * @param reduceToMono If true, reduce the sample to mono
+ *        (stereo samples don't support panning or positional audio).
+ * @param residency How to hold the effect in memory if it has to be loaded.
+ * @return The cached effect (an ALBuffer or OALADPCMAudio), or nil on error.
+ */
+- (id) internalLoadEffect:(NSString*) filePath
+			 reduceToMono:(bool) reduceToMono
+				residency:(OALEffectResidency) residency;
+
+/** (INTERNAL USE) Add a newly loaded buffer to the preload cache, converting it
+ * to the requested residency.
+ *
+ * @param buffer The buffer holding the effect's decoded audio.
+ * @param cacheKey The preload cache key.
+ * @param residency How to hold the effect in memory.
+ * @return The cached effect (an ALBuffer or OALADPCMAudio), or nil on error.
+ */
+- (id) internalAddEffect:(ALBuffer*) buffer
+				  forKey:(NSString*) cacheKey
+			   residency:(OALEffectResidency) residency;
+
+/** (INTERNAL USE) Make a key identifying a buffer's decoded audio, so that
+ * identical effects loaded from different files can share one buffer.
+ *
+ * @param buffer The buffer.
+ * @return The content key.
+ */
+- (NSString*) contentKeyForBuffer:(ALBuffer*) buffer;
+
+/** (INTERNAL USE) Add an effect to the preload cache. If an effect with the same
+ * content is already cached, that one is shared instead.
+ *
+ * @param effect The effect (an ALBuffer or OALADPCMAudio).
+ * @param cacheKey The preload cache key.
+ * @param contentKey The content key of the effect's decoded audio.
+ * @return The cached effect.
+ */
+- (id) cacheEffect:(id) effect forKey:(NSString*) cacheKey contentKey:(NSString*) contentKey;
+
+/** (INTERNAL USE) Remove an entry from the preload cache, releasing the effect
+ * once no other entry shares it.
+ *
+ * @param cacheKey The preload cache key.
+ */
+- (void) uncacheEffectForKey:(NSString*) cacheKey;
+
+/** (INTERNAL USE) The number of bytes of audio data held by an effect.
+ *
+ * @param effect The effect (an ALBuffer or OALADPCMAudio).
+ * @return The size in bytes.
+ */
+- (unsigned long long) sizeOfEffect:(id) effect;
+
+/** (INTERNAL USE) Get a buffer that can play a cached effect, decoding ADPCM
+ * effects if they aren't in the decoded effects cache.
+ *
+ * @param effect The cached effect (an ALBuffer or OALADPCMAudio).
+ * @return A playable buffer, or nil on error.
+ */
+- (ALBuffer*) playableBufferForEffect:(id) effect;
+
+/** (INTERNAL USE) Remove decoded effects until there are no more than decodedEffectsCacheSize.
+ */
+- (void) trimDecodedEffects;
+
 @end
 /** \endcond */
 
@@ -102,6 +180,14 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 #endif
     pendingLoadCount	= 0;
 
+    uniqueEffects = [[NSMutableDictionary alloc] initWithCapacity:64];
+    uniqueEffectRefs = [[NSCountedSet alloc] initWithCapacity:64];
+    effectContentKeys = [[NSMutableDictionary alloc] initWithCapacity:64];
+    decodedEffects = [[NSMutableArray alloc] initWithCapacity:kDefaultDecodedEffectsCacheSize];
+    decodedEffectsCacheSize = kDefaultDecodedEffectsCacheSize;
+    preloadMemoryCeiling = kDefaultPreloadMemoryCeiling;
+    manifestGroups = [[NSMutableDictionary alloc] initWithCapacity:8];
+    manifestPathRefs = [[NSCountedSet alloc] initWithCapacity:64];
     self.preloadCacheEnabled = YES;
     self.bgVolume = 1.0f;
     self.effectsVolume = 1.0f;
@@ -183,6 +269,12 @@ initFailed:
 	as_release(context);
 	as_release(device);
 	as_release(preloadCache);
+	as_release(uniqueEffects);
+	as_release(uniqueEffectRefs);
+	as_release(effectContentKeys);
+	as_release(decodedEffects);
+	as_release(manifestGroups);
+	as_release(manifestPathRefs);
 	as_superdealloc();
 }
 
@@ -196,6 +288,55 @@ initFailed:
 	}
 }
 
+- (NSUInteger) preloadCacheUniqueCount
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [uniqueEffects count];
+	}
+}
+
+- (unsigned long long) preloadCacheBytesSaved
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return preloadCacheBytesSaved;
+	}
+}
+
+- (NSUInteger) decodedEffectsCacheSize
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return decodedEffectsCacheSize;
+	}
+}
+
+- (void) setDecodedEffectsCacheSize:(NSUInteger) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		decodedEffectsCacheSize = value;
+		[self trimDecodedEffects];
+	}
+}
+
+- (unsigned long long) preloadMemoryCeiling
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return preloadMemoryCeiling;
+	}
+}
+
+- (void) setPreloadMemoryCeiling:(unsigned long long) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		preloadMemoryCeiling = value;
+	}
+}
+
 - (bool) preloadCacheEnabled
 {
     return nil != preloadCache;
@@ -222,6 +363,11 @@ initFailed:
 				{
 					as_release(preloadCache);
 					preloadCache = nil;
+					[uniqueEffects removeAllObjects];
+					[uniqueEffectRefs removeAllObjects];
+					[effectContentKeys removeAllObjects];
+					preloadCacheBytesSaved = 0;
+					[decodedEffects removeAllObjects];
 				}
 			}
 		}
@@ -472,34 +618,208 @@ initFailed:
     return [[OALTools urlForPath:filePath] description];
 }
 
-- (ALBuffer*) internalPreloadEffect:(NSString*) filePath reduceToMono:(bool) reduceToMono
+- (id) internalLoadEffect:(NSString*) filePath
+			 reduceToMono:(bool) reduceToMono
+				residency:(OALEffectResidency) residency
 {
-	ALBuffer* buffer;
+	id effect;
     NSString* cacheKey = [self cacheKeyForEffectPath:filePath];
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		buffer = [preloadCache objectForKey:cacheKey];
+		effect = [preloadCache objectForKey:cacheKey];
 	}
-	if(nil == buffer)
+	if(nil == effect)
 	{
 		OAL_LOG_DEBUG(@"Effect not in cache. Loading %@", filePath);
-		buffer = [[OpenALManager sharedInstance] bufferFromFile:filePath reduceToMono:reduceToMono];
+		OALLoadTelemetry* telemetry = [OALLoadTelemetry sharedInstance];
+		OALLoadRecord* record = [telemetry beginRecordForUrl:[OALTools urlForPath:filePath]];
+		ALBuffer* buffer = [[OpenALManager sharedInstance] bufferFromFile:filePath reduceToMono:reduceToMono];
 		if(nil == buffer)
 		{
 			OAL_LOG_ERROR(@"Could not load effect %@", filePath);
+			[telemetry endRecord:record];
 			return nil;
 		}
+		effect = [self internalAddEffect:buffer forKey:cacheKey residency:residency];
+		[telemetry endRecord:record];
+	}
 
-        buffer.name = cacheKey;
-		OPTIONALLY_SYNCHRONIZED(self)
+	return effect;
+}
+
+- (id) internalAddEffect:(ALBuffer*) buffer
+				  forKey:(NSString*) cacheKey
+			   residency:(OALEffectResidency) residency
+{
+	id effect;
+	buffer.name = cacheKey;
+	NSString* contentKey = [self contentKeyForBuffer:buffer];
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		effect = [uniqueEffects objectForKey:contentKey];
+		if(nil != effect)
+		{
+			// Identical audio is already cached under another name.
+			return [self cacheEffect:effect forKey:cacheKey contentKey:contentKey];
+		}
+	}
+
+	effect = buffer;
+	if(kOALEffectResidencyADPCM == residency)
+	{
+		OALADPCMAudio* audio = [OALADPCMAudio audioWithBuffer:buffer];
+		if(nil == audio)
+		{
+			OAL_LOG_WARNING(@"Effect %@ is not 16-bit mono or stereo. Keeping it as PCM", cacheKey);
+		}
+		else if(audio.playsNatively)
 		{
-			[preloadCache setObject:buffer forKey:cacheKey];
+			// OpenAL keeps the compressed data, so the encoded copy isn't needed.
+			effect = [audio nativeBufferNamed:cacheKey];
 		}
+		else
+		{
+			effect = audio;
+		}
+		if(nil == effect)
+		{
+			OAL_LOG_ERROR(@"Could not load effect %@", cacheKey);
+			return nil;
+		}
+	}
+
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		effect = [self cacheEffect:effect forKey:cacheKey contentKey:contentKey];
+	}
+	return effect;
+}
+
+- (NSString*) contentKeyForBuffer:(ALBuffer*) buffer
+{
+	ALint size = buffer.size;
+	if(NULL == buffer.data)
+	{
+		// Nothing to compare against, so it can only match itself.
+		return buffer.name;
 	}
+	uint64_t hash = oal_hash64(buffer.data, (size_t)size, 0);
+	return [NSString stringWithFormat:@"%016llx:%x:%d:%d",
+			(unsigned long long)hash, buffer.format, buffer.frequency, size];
+}
 
+- (id) cacheEffect:(id) effect forKey:(NSString*) cacheKey contentKey:(NSString*) contentKey
+{
+	if(nil == preloadCache)
+	{
+		return effect;
+	}
+	id cached = [preloadCache objectForKey:cacheKey];
+	if(nil != cached)
+	{
+		// Loaded by another thread in the meantime.
+		return cached;
+	}
+
+	id unique = [uniqueEffects objectForKey:contentKey];
+	if(nil == unique)
+	{
+		unique = effect;
+		[uniqueEffects setObject:unique forKey:contentKey];
+	}
+	else
+	{
+		OAL_LOG_DEBUG(@"Effect %@ is identical to %@. Sharing its buffer", [cacheKey lastPathComponent], unique);
+		preloadCacheBytesSaved += [self sizeOfEffect:unique];
+	}
+	[uniqueEffectRefs addObject:contentKey];
+	[effectContentKeys setObject:contentKey forKey:cacheKey];
+	[preloadCache setObject:unique forKey:cacheKey];
+	return unique;
+}
+
+- (void) uncacheEffectForKey:(NSString*) cacheKey
+{
+	NSString* contentKey = [effectContentKeys objectForKey:cacheKey];
+	if(nil != contentKey)
+	{
+		id unique = [uniqueEffects objectForKey:contentKey];
+		[uniqueEffectRefs removeObject:contentKey];
+		if([uniqueEffectRefs countForObject:contentKey] > 0)
+		{
+			preloadCacheBytesSaved -= [self sizeOfEffect:unique];
+		}
+		else
+		{
+			[uniqueEffects removeObjectForKey:contentKey];
+		}
+		[effectContentKeys removeObjectForKey:cacheKey];
+	}
+	[preloadCache removeObjectForKey:cacheKey];
+}
+
+- (unsigned long long) sizeOfEffect:(id) effect
+{
+	if([effect isKindOfClass:[OALADPCMAudio class]])
+	{
+		return [[effect data] length];
+	}
+	return (unsigned long long)[(ALBuffer*)effect size];
+}
+
+- (ALBuffer*) playableBufferForEffect:(id) effect
+{
+	if(![effect isKindOfClass:[OALADPCMAudio class]])
+	{
+		return effect;
+	}
+
+	OALADPCMAudio* audio = effect;
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		NSUInteger index = 0;
+		for(ALBuffer* buffer in decodedEffects)
+		{
+			if([buffer.name isEqualToString:audio.name])
+			{
+				// Move it to the most recently played end.
+				[decodedEffects addObject:buffer];
+				[decodedEffects removeObjectAtIndex:index];
+				return buffer;
+			}
+			index++;
+		}
+	}
+
+	OAL_LOG_DEBUG(@"Decoding effect %@", audio);
+	ALBuffer* buffer = [audio decodedBufferNamed:audio.name];
+	if(nil != buffer)
+	{
+		OPTIONALLY_SYNCHRONIZED(self)
+		{
+			[decodedEffects addObject:buffer];
+			[self trimDecodedEffects];
+		}
+	}
 	return buffer;
 }
 
+- (void) trimDecodedEffects
+{
+	// Buffers still attached to a source are retained by it until it's done with them.
+	while([decodedEffects count] > decodedEffectsCacheSize)
+	{
+		[decodedEffects removeObjectAtIndex:0];
+	}
+}
+
+- (ALBuffer*) internalPreloadEffect:(NSString*) filePath reduceToMono:(bool) reduceToMono
+{
+	return [self playableBufferForEffect:[self internalLoadEffect:filePath
+													 reduceToMono:reduceToMono
+														residency:kOALEffectResidencyPCM]];
+}
+
 - (ALBuffer*) preloadEffect:(NSString*) filePath
 {
 	return [self preloadEffect:filePath reduceToMono:NO];
@@ -535,6 +855,35 @@ initFailed:
 #endif
 }
 
+- (bool) preloadEffect:(NSString*) filePath
+		  reduceToMono:(bool) reduceToMono
+			 residency:(OALEffectResidency) residency
+{
+	if(nil == filePath)
+	{
+		OAL_LOG_ERROR(@"filePath was NULL");
+		return NO;
+	}
+
+    if(pendingLoadCount > 0)
+    {
+        OAL_LOG_WARNING(@"You are loading an effect synchronously, but have pending async loads that have not completed. Your load will happen after those finish. Your thread is now stuck waiting. Next time just load everything async please.");
+    }
+
+#if NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS
+	__block bool loaded = NO;
+	pendingLoadCount++;
+	dispatch_sync(oal_dispatch_queue,
+                  ^{
+                      loaded = nil != [self internalLoadEffect:filePath reduceToMono:reduceToMono residency:residency];
+                  });
+	pendingLoadCount--;
+	return loaded;
+#else
+	return nil != [self internalLoadEffect:filePath reduceToMono:reduceToMono residency:residency];
+#endif
+}
+
 #if NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS
 
 - (BOOL) preloadEffect:(NSString*) filePath
@@ -558,11 +907,11 @@ initFailed:
                        {
                            OAL_LOG_WARNING(@"%@ failed to preload.", filePath);
                        }
-                       dispatch_async(dispatch_get_main_queue(),
-                                      ^{
-                                          completionBlock(retBuffer);
-                                          self->pendingLoadCount--;
-                                      });
+                       [[OpenALManager sharedInstance] performCompletion:^
+                        {
+                            completionBlock(retBuffer);
+                            self->pendingLoadCount--;
+                        }];
                    });
 	return YES;
 }
@@ -570,44 +919,300 @@ initFailed:
 - (void) preloadEffects:(NSArray*) filePaths
            reduceToMono:(bool) reduceToMono
 		  progressBlock:(void (^)(NSUInteger progress, NSUInteger successCount, NSUInteger total)) progressBlock
+{
+	[self preloadEffects:filePaths
+			reduceToMono:reduceToMono
+			   residency:kOALEffectResidencyPCM
+		   progressBlock:progressBlock];
+}
+
+- (void) preloadEffects:(NSArray*) filePaths
+		   reduceToMono:(bool) reduceToMono
+			  residency:(OALEffectResidency) residency
+		  progressBlock:(void (^)(NSUInteger progress, NSUInteger successCount, NSUInteger total)) progressBlock
+{
+	[self preloadEffects:filePaths
+			reduceToMono:reduceToMono
+			   residency:residency
+	   byteProgressBlock:^(NSUInteger progress, NSUInteger successCount, NSUInteger total, unsigned long long bytesLoaded)
+	 {
+		 #pragma unused(bytesLoaded)
+		 progressBlock(progress, successCount, total);
+	 }];
+}
+
+- (void) preloadEffects:(NSArray*) filePaths
+		   reduceToMono:(bool) reduceToMono
+			  residency:(OALEffectResidency) residency
+	  byteProgressBlock:(void (^)(NSUInteger progress, NSUInteger successCount, NSUInteger total, unsigned long long bytesLoaded)) progressBlock
 {
 	NSUInteger total = [filePaths count];
 	if(total < 1)
 	{
 		OAL_LOG_ERROR(@"Preload effects: No files to process");
-		progressBlock(0,0,0);
+		progressBlock(0,0,0,0);
 		return;
 	}
 
+	NSUInteger workerCount = [[NSProcessInfo processInfo] activeProcessorCount];
+	if(workerCount > total)
+	{
+		workerCount = total;
+	}
+	unsigned long long ceiling = self.preloadMemoryCeiling;
+
+	// Decoding is spread over several workers, while buffers are only created on
+	// oal_dispatch_queue. The workers stall while too much decoded audio is waiting for it.
+	NSCondition* condition = as_autorelease([[NSCondition alloc] init]);
+	__block NSUInteger nextIndex = 0;
+	__block NSUInteger completedCount = 0;
 	__block NSUInteger successCount = 0;
+	__block unsigned long long bytesQueued = 0;
+	__block unsigned long long bytesLoaded = 0;
+
+	void (^completeEffect)(bool, unsigned long long) = ^(bool succeeded, unsigned long long bytes)
+	{
+		[condition lock];
+		bytesQueued -= bytes;
+		completedCount++;
+		if(succeeded)
+		{
+			successCount++;
+			bytesLoaded += bytes;
+		}
+		NSUInteger cnt = completedCount;
+		NSUInteger successCnt = successCount;
+		unsigned long long loaded = bytesLoaded;
+		// Queued while locked so that progress is reported in order.
+		[[OpenALManager sharedInstance] performCompletion:^
+		 {
+			 if(cnt == total)
+			 {
+				 self->pendingLoadCount		-= total;
+			 }
+			 progressBlock(cnt, successCnt, total, loaded);
+		 }];
+		[condition broadcast];
+		[condition unlock];
+	};
+
+	void (^decodeEffects)(void) = ^
+	{
+		for(;;)
+		{
+			[condition lock];
+			while(ceiling > 0 && bytesQueued >= ceiling)
+			{
+				[condition wait];
+			}
+			NSUInteger idx = nextIndex++;
+			[condition unlock];
+			if(idx >= total)
+			{
+				break;
+			}
+
+			as_autoreleasepool_start(pool);
+			NSString* filePath = [filePaths objectAtIndex:idx];
+			NSString* cacheKey = [self cacheKeyForEffectPath:filePath];
+			id cached;
+			OPTIONALLY_SYNCHRONIZED(self)
+			{
+				cached = [self->preloadCache objectForKey:cacheKey];
+			}
+			if(nil != cached)
+			{
+				completeEffect(YES, 0);
+			}
+			else
+			{
+				OAL_LOG_INFO(@"Preloading effect: %@", filePath);
+				NSURL* url = [OALTools urlForPath:filePath];
+				OALLoadTelemetry* telemetry = [OALLoadTelemetry sharedInstance];
+				OALLoadRecord* record = [telemetry beginRecordForUrl:url];
+				OALAudioData* audio = [[OpenALManager sharedInstance] audioDataFromUrl:url
+																		  reduceToMono:reduceToMono];
+				// The rest of the load is recorded on the upload queue.
+				[telemetry suspendRecord:record];
+				if(nil == audio)
+				{
+					OAL_LOG_WARNING(@"%@ failed to preload.", filePath);
+					[telemetry endRecord:record];
+					completeEffect(NO, 0);
+				}
+				else
+				{
+					unsigned long long bytes = (unsigned long long)audio.size;
+					[condition lock];
+					bytesQueued += bytes;
+					[condition unlock];
+					dispatch_async(self->oal_dispatch_queue,
+								   ^{
+									   [telemetry resumeRecord:record];
+									   ALBuffer* buffer = [audio bufferNamed:cacheKey];
+									   id result = nil;
+									   if(nil != buffer)
+									   {
+										   result = [self internalAddEffect:buffer forKey:cacheKey residency:residency];
+									   }
+									   [telemetry endRecord:record];
+									   if(!result)
+									   {
+										   OAL_LOG_WARNING(@"%@ failed to preload.", filePath);
+									   }
+									   completeEffect(nil != result, bytes);
+								   });
+				}
+			}
+			as_autoreleasepool_end(pool);
+		}
+	};
+
+	pendingLoadCount += total;
+	for(NSUInteger i = 0; i < workerCount; i++)
+	{
+		dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), decodeEffects);
+	}
+}
+
+- (void) loadManifestGroup:(NSString*) group
+			  fromManifest:(OALPreloadManifest*) manifest
+			  memoryBudget:(unsigned long long) memoryBudget
+			 progressBlock:(void (^)(NSUInteger progress, NSUInteger successCount, NSUInteger deferredCount, NSUInteger total, unsigned long long bytesLoaded)) progressBlock
+{
+	NSArray* entries = [manifest entriesInGroup:group];
+	NSUInteger total = [entries count];
+	if(total < 1)
+	{
+		OAL_LOG_ERROR(@"Load manifest group: No effects in group %@", group);
+		progressBlock(0,0,0,0,0);
+		return;
+	}
+	if(0 == memoryBudget)
+	{
+		memoryBudget = ULLONG_MAX;
+	}
 
 	pendingLoadCount += total;
 	dispatch_async(oal_dispatch_queue,
-                   ^{
-                       [filePaths enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop)
-                        {
-                            #pragma unused(stop)
-                            OAL_LOG_INFO(@"Preloading effect: %@", obj);
-                            ALBuffer *result = [self internalPreloadEffect:(NSString *)obj reduceToMono:reduceToMono];
-                            if(!result)
-                            {
-                                OAL_LOG_WARNING(@"%@ failed to preload.", obj);
-                            }
-                            else
-                            {
-                                successCount++;
-                            }
-                            NSUInteger cnt = idx+1;
-                            dispatch_async(dispatch_get_main_queue(),
-                                           ^{
-                                               if(cnt == total)
-                                               {
-                                                   self->pendingLoadCount		-= total;
-                                               }
-                                               progressBlock(cnt, successCount, total);
-                                           });
-                        }];
-                   });
+				   ^{
+					   NSMutableSet* loadedPaths = [NSMutableSet setWithCapacity:total];
+					   __block NSUInteger successCount = 0;
+					   __block NSUInteger deferredCount = 0;
+					   __block unsigned long long bytesLoaded = 0;
+					   [entries enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop)
+						{
+							#pragma unused(stop)
+							OALPreloadManifestEntry* entry = obj;
+							bool succeeded = NO;
+							bool deferred = NO;
+							if(kOALManifestResidencyStreamed == entry.residency)
+							{
+								deferred = YES;
+							}
+							else
+							{
+								NSString* cacheKey = [self cacheKeyForEffectPath:entry.path];
+								id effect;
+								OPTIONALLY_SYNCHRONIZED(self)
+								{
+									effect = [self->preloadCache objectForKey:cacheKey];
+								}
+								if(nil == effect)
+								{
+									OAL_LOG_INFO(@"Preloading effect: %@", entry.path);
+									NSURL* url = [OALTools urlForPath:entry.path];
+									OALLoadTelemetry* telemetry = [OALLoadTelemetry sharedInstance];
+									OALLoadRecord* record = [telemetry beginRecordForUrl:url];
+									OALAudioData* audio = [[OpenALManager sharedInstance] audioDataFromUrl:url
+																							  reduceToMono:entry.reduceToMono];
+									if(nil != audio)
+									{
+										unsigned long long size = (unsigned long long)audio.size;
+										bool compressible = AL_FORMAT_MONO16 == audio.format || AL_FORMAT_STEREO16 == audio.format;
+										OALEffectResidency residency = kOALEffectResidencyPCM;
+										if(compressible &&
+										   (kOALManifestResidencyCompressed == entry.residency || size > memoryBudget - bytesLoaded))
+										{
+											residency = kOALEffectResidencyADPCM;
+											// 4 bits per sample, ignoring block headers.
+											size /= 4;
+										}
+										if(bytesLoaded > memoryBudget || size > memoryBudget - bytesLoaded)
+										{
+											OAL_LOG_INFO(@"Deferring %@: over the memory budget", entry.path);
+											deferred = YES;
+										}
+										else
+										{
+											ALBuffer* buffer = [audio bufferNamed:cacheKey];
+											if(nil != buffer)
+											{
+												effect = [self internalAddEffect:buffer forKey:cacheKey residency:residency];
+											}
+										}
+									}
+									[telemetry endRecord:record];
+								}
+								if(nil != effect)
+								{
+									bytesLoaded += [self sizeOfEffect:effect];
+									[loadedPaths addObject:entry.path];
+									succeeded = YES;
+								}
+								else if(!deferred)
+								{
+									OAL_LOG_WARNING(@"%@ failed to preload.", entry.path);
+								}
+							}
+							if(succeeded)
+							{
+								successCount++;
+							}
+							else if(deferred)
+							{
+								deferredCount++;
+							}
+
+							NSUInteger cnt = idx+1;
+							NSUInteger successCnt = successCount;
+							NSUInteger deferredCnt = deferredCount;
+							unsigned long long loaded = bytesLoaded;
+							if(cnt == total)
+							{
+								OPTIONALLY_SYNCHRONIZED(self)
+								{
+									NSMutableSet* groupPaths = [self->manifestGroups objectForKey:group];
+									if(nil == groupPaths)
+									{
+										groupPaths = loadedPaths;
+										[self->manifestGroups setObject:groupPaths forKey:group];
+										[self->manifestPathRefs unionSet:loadedPaths];
+									}
+									else
+									{
+										// Each group counts once per path, however often it is loaded.
+										for(NSString* path in loadedPaths)
+										{
+											if(![groupPaths containsObject:path])
+											{
+												[groupPaths addObject:path];
+												[self->manifestPathRefs addObject:path];
+											}
+										}
+									}
+								}
+							}
+							[[OpenALManager sharedInstance] performCompletion:^
+							 {
+								 if(cnt == total)
+								 {
+									 self->pendingLoadCount		-= total;
+								 }
+								 progressBlock(cnt, successCnt, deferredCnt, total, loaded);
+							 }];
+						}];
+				   });
 }
 #endif
 
@@ -623,10 +1228,31 @@ initFailed:
     bool isSuccess = YES;
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-        isSuccess = [channel removeBuffersNamed:cacheKey];
+        NSString* contentKey = [effectContentKeys objectForKey:cacheKey];
+        if(nil != contentKey && [uniqueEffectRefs countForObject:contentKey] > 1)
+        {
+            // Other entries still share this effect, so only the alias goes.
+            [self uncacheEffectForKey:cacheKey];
+            return YES;
+        }
+
+        // Shared effects are named after the entry that first loaded them.
+        NSString* bufferName = [[preloadCache objectForKey:cacheKey] name];
+        if(nil == bufferName)
+        {
+            bufferName = cacheKey;
+        }
+        isSuccess = [channel removeBuffersNamed:bufferName];
         if(isSuccess)
         {
-            [preloadCache removeObjectForKey:cacheKey];
+            [self uncacheEffectForKey:cacheKey];
+            for(NSUInteger i = [decodedEffects count]; i > 0; i--)
+            {
+                if([[[decodedEffects objectAtIndex:i - 1] name] isEqualToString:bufferName])
+                {
+                    [decodedEffects removeObjectAtIndex:i - 1];
+                }
+            }
         }
 	}
     if(!isSuccess)
@@ -643,8 +1269,61 @@ initFailed:
 	{
         for(ALBuffer* buffer in [channel clearUnusedBuffers])
         {
-            [preloadCache removeObjectForKey:[self cacheKeyForBuffer:buffer]];
+            // Remove every entry sharing this buffer, not just the one it's named after.
+            NSString* bufferName = [self cacheKeyForBuffer:buffer];
+            for(NSString* cacheKey in [preloadCache allKeys])
+            {
+                if([[[preloadCache objectForKey:cacheKey] name] isEqualToString:bufferName])
+                {
+                    [self uncacheEffectForKey:cacheKey];
+                }
+            }
         }
+        // Decoded ADPCM effects that are still playing are kept alive by their sources.
+        [decodedEffects removeAllObjects];
+	}
+}
+
+- (bool) unloadManifestGroup:(NSString*) group
+{
+	NSMutableSet* remainingPaths = [NSMutableSet set];
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		NSSet* groupPaths = [manifestGroups objectForKey:group];
+		if(nil == groupPaths)
+		{
+			OAL_LOG_DEBUG(@"Manifest group %@ is not loaded", group);
+			return NO;
+		}
+
+		OAL_LOG_DEBUG(@"Unload manifest group %@", group);
+		for(NSString* path in groupPaths)
+		{
+			// Effects that another loaded group uses stay loaded.
+			[manifestPathRefs removeObject:path];
+			if([manifestPathRefs countForObject:path] == 0 && ![self unloadEffect:path])
+			{
+				[remainingPaths addObject:path];
+			}
+		}
+
+		if([remainingPaths count] > 0)
+		{
+			// Still playing, so keep them for the next try.
+			[manifestGroups setObject:remainingPaths forKey:group];
+			[manifestPathRefs unionSet:remainingPaths];
+			return NO;
+		}
+		[manifestGroups removeObjectForKey:group];
+	}
+	return YES;
+}
+
+- (bool) isManifestGroupLoaded:(NSString*) group
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return nil != [manifestGroups objectForKey:group];
 	}
 }
 
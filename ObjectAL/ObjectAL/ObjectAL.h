@@ -31,6 +31,8 @@
 #import "OALAction.h"
 #import "OALAudioActions.h"
 #import "OALUtilityActions.h"
+#import "OALParameterRamp.h"
+#import "OALActionTimeline.h"
 #import "OALActionManager.h"
 
 // AudioTrack
@@ -51,6 +53,12 @@
 #import "ALSoundSourcePool.h"
 #import "OpenALManager.h"
 #import "OALAudioFile.h"
+#import "OALAudioData.h"
+#import "OALStreamingSource.h"
+#import "OALDecodedAudioCache.h"
+#import "OALADPCMAudio.h"
+#import "OALPreloadManifest.h"
+#import "OALLoadTelemetry.h"
 
 // Other
 //#import "OALNotifications.h"
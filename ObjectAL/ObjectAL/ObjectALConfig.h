@@ -95,6 +95,51 @@
 #endif
 
 
+/** Sets the default interval in seconds between steps when OALActionManager runs
+ * actions on its own scheduler thread (see OALActionManager.runsOnSchedulerThread). <br>
+ *
+ * The scheduler thread sleeps against the system's monotonic clock rather than the main
+ * run loop, so much smaller intervals are practical. Rates of 100-250 steps per second
+ * remove the audible stepping in short fades. <br>
+ *
+ * Note: This setting only has effect if OBJECTAL_CFG_USE_COCOS2D_ACTIONS is 0. <br>
+ *
+ * Recommended setting: 1.0/200.0
+ */
+#ifndef kActionSchedulerStepInterval
+#define kActionSchedulerStepInterval (1.0/200.0)
+#endif
+
+
+/** Sets the smallest change in a source's effective gain (gain * groupGain) that a
+ * change to its group gain will be written to OpenAL for. <br>
+ *
+ * A channel fade changes the group gain of every source in the channel on every step.
+ * Steps that would change a source's gain by less than this are skipped, which saves
+ * OpenAL calls during the flat parts of a fade and for quiet sources. A group gain of
+ * exactly 0 or 1 is always written. <br>
+ *
+ * Recommended setting: 0.001
+ */
+#ifndef kGroupGainEpsilon
+#define kGroupGainEpsilon 0.001f
+#endif
+
+
+/** The default number of frames a loopback device renders between steps of the
+ * audio sample clock (see ALDevice.automationBlockFrames). <br>
+ *
+ * OpenAL Soft smooths gain changes across each block it mixes, so a fade stepped
+ * this often follows its curve closely without clicking. Smaller blocks follow the
+ * curve more closely but step the actions more often. <br>
+ *
+ * Recommended setting: 64
+ */
+#ifndef kLoopbackAutomationBlockFrames
+#define kLoopbackAutomationBlockFrames 64
+#endif
+
+
 /** When this option is enabled, all critical ObjectAL operations will be wrapped in
  * synchronized blocks. <br>
  *
@@ -125,3 +170,42 @@
 #ifndef OBJECTAL_CFG_LOG_LEVEL
 #define OBJECTAL_CFG_LOG_LEVEL LEVEL_WARNING
 #endif
+
+
+/** When enabled, OALAudioFile decodes WAV and FLAC files (and Ogg Vorbis/Opus if
+ * enabled below) using ObjectAL's own portable decoders, falling back to
+ * ExtAudioFile for anything they don't recognize. <br>
+ *
+ * Recommended setting: 1
+ */
+#ifndef OBJECTAL_CFG_USE_NATIVE_DECODERS
+#define OBJECTAL_CFG_USE_NATIVE_DECODERS 1
+#endif
+
+
+/** Enables decoding of Ogg Vorbis files using stb_vorbis. <br>
+ *
+ * stb_vorbis is not included with ObjectAL. To use it, add stb_vorbis.c to your
+ * project and make sure it can be found in your header search path. <br>
+ *
+ * Note: This setting only has effect if OBJECTAL_CFG_USE_NATIVE_DECODERS is 1. <br>
+ *
+ * Recommended setting: 1 if you have Ogg Vorbis assets, 0 otherwise.
+ */
+#ifndef OBJECTAL_CFG_USE_STB_VORBIS
+#define OBJECTAL_CFG_USE_STB_VORBIS 0
+#endif
+
+
+/** Enables decoding of Ogg Opus files using libopusfile. <br>
+ *
+ * libopusfile (along with libopus and libogg) is not included with ObjectAL.
+ * To use it, link against it and add its headers to your header search path. <br>
+ *
+ * Note: This setting only has effect if OBJECTAL_CFG_USE_NATIVE_DECODERS is 1. <br>
+ *
+ * Recommended setting: 1 if you have Ogg Opus assets, 0 otherwise.
+ */
+#ifndef OBJECTAL_CFG_USE_OPUSFILE
+#define OBJECTAL_CFG_USE_OPUSFILE 0
+#endif
@@ -50,6 +50,7 @@
 	void* bufferData;
 	bool freeDataOnDestroy;
 	ALBuffer* parentBuffer;
+	NSData* backingData;
 }
 
 
@@ -90,6 +91,43 @@
 /** The parent buffer (which owns the uncompressed data) */
 @property(nonatomic,readwrite,retain) ALBuffer* parentBuffer;
 
+/** The object that owns the sound data, if the data lives inside an NSData object
+ * (for example a memory mapped file). It is retained for as long as the buffer exists.
+ */
+@property(nonatomic,readonly,retain) NSData* backingData;
+
+/** The uncompressed sound data backing this buffer.
+ * Do not modify the contents while the buffer is attached to a playing source.
+ */
+@property(nonatomic,readonly,assign) void* data;
+
+#pragma mark Formats
+
+/** Get the OpenAL format for a sample layout, if the current context can play it. <br>
+ *
+ * 8 and 16-bit mono and stereo are always available. 32-bit float needs the
+ * AL_EXT_FLOAT32 extension, and 4, 6, 7 or 8 channels need AL_EXT_MCFORMATS.
+ *
+ * @param channels The number of channels.
+ * @param bits The size of a sample in bits (8, 16, or 32 for floating point).
+ * @param floatingPoint If TRUE, the samples are 32-bit floating point.
+ * @return The format (AL_FORMAT_XXX), or AL_NONE if it isn't supported.
+ */
++ (ALenum) formatWithChannels:(ALint) channels
+						 bits:(ALint) bits
+				floatingPoint:(bool) floatingPoint;
+
+/** Check if the current context can play IMA ADPCM data directly. <br>
+ *
+ * This needs the AL_EXT_IMA4 extension, and blocks of any size other than
+ * 65 frames also need AL_SOFT_block_alignment.
+ *
+ * @param framesPerBlock The number of frames in each block of the data.
+ * @return TRUE if bufferWithName:imaData:size:channels:frequency:framesPerBlock: will work.
+ */
++ (bool) canPlayIMAWithFramesPerBlock:(ALint) framesPerBlock;
+
+
 #pragma mark Object Management
 
 /** Make a new buffer.
@@ -122,6 +160,83 @@
 			 format:(ALenum) format
 		  frequency:(ALsizei) frequency;
 
+/** Make a new buffer that plays sound data stored inside an NSData object.
+ * The data is not copied. The NSData object is retained instead, and is released
+ * when the buffer is destroyed.
+ *
+ * @param name Optional name that you can use to identify this buffer in your code.
+ * @param backingData The object containing the sound data.
+ * @param offset The offset in bytes where the sound data starts.
+ * @param size The size of the sound data in bytes.
+ * @param format The format of the data (see the Core Audio documentation).
+ * @param frequency The sampling frequency in Hz.
+ * @return A new buffer.
+ */
++ (id) bufferWithName:(NSString*) name
+		  backingData:(NSData*) backingData
+			   offset:(NSUInteger) offset
+				 size:(ALsizei) size
+			   format:(ALenum) format
+			frequency:(ALsizei) frequency;
+
+/** Initialize a buffer that plays sound data stored inside an NSData object.
+ * The data is not copied. The NSData object is retained instead, and is released
+ * when the buffer is destroyed.
+ *
+ * @param name Optional name that you can use to identify this buffer in your code.
+ * @param backingData The object containing the sound data.
+ * @param offset The offset in bytes where the sound data starts.
+ * @param size The size of the sound data in bytes.
+ * @param format The format of the data (see the Core Audio documentation).
+ * @param frequency The sampling frequency in Hz.
+ * @return The initialized buffer.
+ */
+- (id) initWithName:(NSString*) name
+		backingData:(NSData*) backingData
+			 offset:(NSUInteger) offset
+			   size:(ALsizei) size
+			 format:(ALenum) format
+		  frequency:(ALsizei) frequency;
+
+/** Make a new buffer holding IMA ADPCM data (in the Microsoft IMA ADPCM block layout),
+ * which OpenAL decodes as it plays. The data is copied into OpenAL, so the caller keeps
+ * ownership of it, and the new buffer's data property is NULL. <br>
+ *
+ * Only possible if canPlayIMAWithFramesPerBlock: returns TRUE.
+ *
+ * @param name Optional name that you can use to identify this buffer in your code.
+ * @param data The encoded data, made up of whole blocks.
+ * @param size The size of the data in bytes.
+ * @param channels The number of channels (1 or 2).
+ * @param frequency The sampling frequency in Hz.
+ * @param framesPerBlock The number of frames in each block.
+ * @return A new buffer.
+ */
++ (id) bufferWithName:(NSString*) name
+			  imaData:(const void*) data
+				 size:(ALsizei) size
+			 channels:(ALint) channels
+			frequency:(ALsizei) frequency
+	   framesPerBlock:(ALint) framesPerBlock;
+
+/** Initialize a buffer holding IMA ADPCM data.
+ * See bufferWithName:imaData:size:channels:frequency:framesPerBlock:
+ *
+ * @param name Optional name that you can use to identify this buffer in your code.
+ * @param data The encoded data, made up of whole blocks.
+ * @param size The size of the data in bytes.
+ * @param channels The number of channels (1 or 2).
+ * @param frequency The sampling frequency in Hz.
+ * @param framesPerBlock The number of frames in each block.
+ * @return The initialized buffer.
+ */
+- (id) initWithName:(NSString*) name
+			imaData:(const void*) data
+			   size:(ALsizei) size
+		   channels:(ALint) channels
+		  frequency:(ALsizei) frequency
+	 framesPerBlock:(ALint) framesPerBlock;
+
 /** Returns a part of the buffer as a new buffer. You can use this method to split a buffer
  * into a sub-buffers. The sub-buffers retain a reference to their parent buffer, and share
  * the same memory. Therefore, modifying the parent buffer contents will affect its slices
@@ -134,5 +249,20 @@
  */
 - (ALBuffer*)sliceWithName:(NSString *) sliceName offset:(ALsizei) offset size:(ALsizei) size;
 
+/** Replace the sound data in this buffer. Used to recycle buffers when streaming.
+ * If freeDataOnDestroy is set, the old data will be freed unless it is the same as the new data.
+ * The buffer must not be queued on or attached to any source while its data is replaced.
+ *
+ * @param data The sound data. If freeDataOnDestroy is set, ALBuffer will call free() on this data when it is destroyed!
+ * @param size The size of the data in bytes.
+ * @param format The format of the data (see the Core Audio documentation).
+ * @param frequency The sampling frequency in Hz.
+ * @return TRUE if the operation was successful.
+ */
+- (bool) replaceData:(void*) data
+				size:(ALsizei) size
+			  format:(ALenum) format
+		   frequency:(ALsizei) frequency;
+
 
 @end
@@ -32,8 +32,48 @@
 #import "OpenALManager.h"
 #import "ObjectALMacros.h"
 #import "ARCSafe_MemMgmt.h"
+#import "OALLoadTelemetry.h"
+#import "oal_adpcm.h"
+#import <mach/mach_time.h>
 
 
+/** The block size OpenAL uses for IMA ADPCM data unless told otherwise. */
+#define kIMADefaultFramesPerBlock 65
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for ALBuffer.
+ */
+@interface ALBuffer (Private)
+
+/** (INTERNAL USE) Initialize the buffer.
+ *
+ * @param name Optional name that you can use to identify this buffer in your code.
+ * @param data The sound data.
+ * @param size The size of the data in bytes.
+ * @param format The format of the data (see the Core Audio documentation).
+ * @param frequency The sampling frequency in Hz.
+ * @param backingData The object that owns the data, or nil if ALBuffer owns it and should free() it.
+ * @return The initialized buffer.
+ */
+- (id) initWithName:(NSString*) name
+               data:(void*) data
+               size:(ALsizei) size
+             format:(ALenum) format
+          frequency:(ALsizei) frequency
+		backingData:(NSData*) backingData;
+
+@end
+/** \endcond */
+
+
+#pragma mark -
+#pragma mark ALBuffer
+
 @implementation ALBuffer
 
 
@@ -52,11 +92,77 @@
                                                 frequency:frequency]);
 }
 
++ (id) bufferWithName:(NSString*) name
+		  backingData:(NSData*) backingData
+			   offset:(NSUInteger) offset
+				 size:(ALsizei) size
+			   format:(ALenum) format
+			frequency:(ALsizei) frequency
+{
+	return as_autorelease([[self alloc] initWithName:name
+										 backingData:backingData
+											  offset:offset
+												size:size
+											  format:format
+										   frequency:frequency]);
+}
+
+- (id) initWithName:(NSString*) nameIn
+               data:(void*) data
+               size:(ALsizei) size
+             format:(ALenum) formatIn
+          frequency:(ALsizei) frequency
+{
+	return [self initWithName:nameIn
+						 data:data
+						 size:size
+					   format:formatIn
+					frequency:frequency
+				  backingData:nil];
+}
+
++ (id) bufferWithName:(NSString*) name
+			  imaData:(const void*) data
+				 size:(ALsizei) size
+			 channels:(ALint) channels
+			frequency:(ALsizei) frequency
+	   framesPerBlock:(ALint) framesPerBlock
+{
+	return as_autorelease([[self alloc] initWithName:name
+											 imaData:data
+												size:size
+											channels:channels
+										   frequency:frequency
+									  framesPerBlock:framesPerBlock]);
+}
+
+- (id) initWithName:(NSString*) nameIn
+		backingData:(NSData*) backingDataIn
+			 offset:(NSUInteger) offset
+			   size:(ALsizei) size
+			 format:(ALenum) formatIn
+		  frequency:(ALsizei) frequency
+{
+	if(nil == backingDataIn || offset + (NSUInteger)size > [backingDataIn length])
+	{
+		OAL_LOG_ERROR(@"%@: Backing data is too small for offset %lu + size %d", self, (unsigned long)offset, size);
+		as_release(self);
+		return nil;
+	}
+	return [self initWithName:nameIn
+						 data:(char*)[backingDataIn bytes] + offset
+						 size:size
+					   format:formatIn
+					frequency:frequency
+				  backingData:backingDataIn];
+}
+
 - (id) initWithName:(NSString*) nameIn
                data:(void*) data
                size:(ALsizei) size
              format:(ALenum) formatIn
           frequency:(ALsizei) frequency
+		backingData:(NSData*) backingDataIn
 {
 	if(nil != (self = [super init]))
 	{
@@ -71,14 +177,18 @@
 		device = as_retain([OpenALManager sharedInstance].currentContext.device);
 		bufferData = data;
 		format = formatIn;
-		freeDataOnDestroy = YES;
+		backingData = as_retain(backingDataIn);
+		// Data owned by another object must never be freed.
+		freeDataOnDestroy = nil == backingData;
 		parentBuffer = nil;
 
+		uint64_t uploadStart = mach_absolute_time();
 		if(![ALWrapper bufferDataStatic:bufferId format:format data:bufferData size:size frequency:frequency])
         {
             OAL_LOG_ERROR(@"%@: Failed to create an OpenAL buffer", self);
             goto initFailed;
         }
+		[[OALLoadRecord currentRecord] addTimeSince:uploadStart toStage:kOALLoadStageUpload];
 		
 		duration = (float)self.size / ((float)(self.frequency * self.channels * self.bits) / 8);
 	}
@@ -89,6 +199,63 @@ initFailed:
     return nil;
 }
 
+- (id) initWithName:(NSString*) nameIn
+			imaData:(const void*) data
+			   size:(ALsizei) size
+		   channels:(ALint) channels
+		  frequency:(ALsizei) frequency
+	 framesPerBlock:(ALint) framesPerBlock
+{
+	if(nil != (self = [super init]))
+	{
+		OAL_LOG_DEBUG(@"%@: Init IMA ADPCM", self);
+		self.name = nameIn;
+		bufferId = [ALWrapper genBuffer];
+		if(nil == [OpenALManager sharedInstance].currentContext)
+		{
+			OAL_LOG_ERROR(@"%@: Cannot allocate a buffer without a current context. Make sure [OpenALManager sharedInstance].currentContext is valid", self);
+			goto initFailed;
+		}
+		device = as_retain([OpenALManager sharedInstance].currentContext.device);
+		// OpenAL keeps its own copy of the data.
+		bufferData = NULL;
+		freeDataOnDestroy = NO;
+		parentBuffer = nil;
+
+		size_t blockSize = oal_adpcm_ima_block_size((uint32_t)channels, (uint32_t)framesPerBlock);
+		if(channels < 1 || channels > 2 || 0 == blockSize || 0 != (size_t)size % blockSize ||
+		   ![ALBuffer canPlayIMAWithFramesPerBlock:framesPerBlock])
+		{
+			OAL_LOG_ERROR(@"%@: Cannot play IMA ADPCM with %d channels and %d frames per block", self, channels, framesPerBlock);
+			goto initFailed;
+		}
+		format = [ALWrapper getEnumValue:1 == channels ? @"AL_FORMAT_MONO_IMA4" : @"AL_FORMAT_STEREO_IMA4"];
+
+		if(kIMADefaultFramesPerBlock != framesPerBlock &&
+		   ![ALWrapper bufferi:bufferId
+					 parameter:[ALWrapper getEnumValue:@"AL_UNPACK_BLOCK_ALIGNMENT_SOFT"]
+						 value:framesPerBlock])
+		{
+			OAL_LOG_ERROR(@"%@: Failed to set the block alignment", self);
+			goto initFailed;
+		}
+		uint64_t uploadStart = mach_absolute_time();
+		if(![ALWrapper bufferData:bufferId format:format data:data size:size frequency:frequency])
+		{
+			OAL_LOG_ERROR(@"%@: Failed to create an OpenAL buffer", self);
+			goto initFailed;
+		}
+		[[OALLoadRecord currentRecord] addTimeSince:uploadStart toStage:kOALLoadStageUpload];
+
+		duration = (float)((size_t)size / blockSize * (size_t)framesPerBlock) / (float)frequency;
+	}
+	return self;
+
+initFailed:
+	as_release(self);
+	return nil;
+}
+
 - (void) dealloc
 {
 	OAL_LOG_DEBUG(@"%@: Dealloc", self);
@@ -96,6 +263,7 @@ initFailed:
 	as_release(device);
 	as_release(name);
 	as_release(parentBuffer);
+	as_release(backingData);
 	if(freeDataOnDestroy)
 	{
 		free(bufferData);
@@ -110,6 +278,92 @@ initFailed:
 	return [NSString stringWithFormat:@"<%@: %p: %@>", [self class], self, nameStr];
 }
 
+#pragma mark Formats
+
++ (ALenum) formatWithChannels:(ALint) channels
+						 bits:(ALint) bits
+				floatingPoint:(bool) floatingPoint
+{
+	if(!floatingPoint && channels <= 2)
+	{
+		switch(bits)
+		{
+			case 8:
+				return 1 == channels ? AL_FORMAT_MONO8 : AL_FORMAT_STEREO8;
+			case 16:
+				return 1 == channels ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+		}
+		return AL_NONE;
+	}
+	if(floatingPoint && 32 != bits)
+	{
+		return AL_NONE;
+	}
+
+	// Extension formats need a context to check against.
+	if(nil == [OpenALManager sharedInstance].currentContext)
+	{
+		return AL_NONE;
+	}
+
+	NSString* formatName;
+	if(channels <= 2)
+	{
+		if(![ALWrapper isExtensionPresent:@"AL_EXT_FLOAT32"])
+		{
+			return AL_NONE;
+		}
+		formatName = 1 == channels ? @"AL_FORMAT_MONO_FLOAT32" : @"AL_FORMAT_STEREO_FLOAT32";
+	}
+	else
+	{
+		// The 32-bit multichannel formats are floating point.
+		if(!floatingPoint && 8 != bits && 16 != bits)
+		{
+			return AL_NONE;
+		}
+		if(![ALWrapper isExtensionPresent:@"AL_EXT_MCFORMATS"])
+		{
+			return AL_NONE;
+		}
+		NSString* layout;
+		switch(channels)
+		{
+			case 4:
+				layout = @"QUAD";
+				break;
+			case 6:
+				layout = @"51CHN";
+				break;
+			case 7:
+				layout = @"61CHN";
+				break;
+			case 8:
+				layout = @"71CHN";
+				break;
+			default:
+				return AL_NONE;
+		}
+		formatName = [NSString stringWithFormat:@"AL_FORMAT_%@%d", layout, bits];
+	}
+
+	// Unknown names come back as 0 (AL_NONE).
+	return [ALWrapper getEnumValue:formatName];
+}
+
+
++ (bool) canPlayIMAWithFramesPerBlock:(ALint) framesPerBlock
+{
+	if(nil == [OpenALManager sharedInstance].currentContext ||
+	   0 == oal_adpcm_ima_block_size(1, (uint32_t)framesPerBlock) ||
+	   ![ALWrapper isExtensionPresent:@"AL_EXT_IMA4"])
+	{
+		return NO;
+	}
+	return kIMADefaultFramesPerBlock == framesPerBlock || [ALWrapper isExtensionPresent:@"AL_SOFT_block_alignment"];
+}
+
+
 #pragma mark Properties
 
 - (ALint) bits
@@ -146,10 +400,20 @@ initFailed:
 
 @synthesize parentBuffer;
 
+@synthesize backingData;
+
+@synthesize data = bufferData;
+
 #pragma mark Buffer slicing
 
 - (ALBuffer*)sliceWithName:(NSString *) sliceName offset:(ALsizei) offset size:(ALsizei) size
 {
+	if(NULL == bufferData)
+	{
+		OAL_LOG_ERROR(@"%@: Buffer data is held by OpenAL and cannot be sliced. Returning nil", self);
+		return nil;
+	}
+
 	int frameSize = self.channels * self.bits / 8;
 	int byteOffset = offset * frameSize;
 	int byteSize = size * frameSize;
@@ -179,4 +443,28 @@ initFailed:
 	return slice;
 }
 
+
+#pragma mark Buffer recycling
+
+- (bool) replaceData:(void*) data
+				size:(ALsizei) size
+			  format:(ALenum) formatIn
+		   frequency:(ALsizei) frequency
+{
+	if(![ALWrapper bufferDataStatic:bufferId format:formatIn data:data size:size frequency:frequency])
+	{
+		OAL_LOG_ERROR(@"%@: Failed to replace OpenAL buffer data", self);
+		return NO;
+	}
+
+	if(freeDataOnDestroy && data != bufferData)
+	{
+		free(bufferData);
+	}
+	bufferData = data;
+	format = formatIn;
+	duration = (float)self.size / ((float)(self.frequency * self.channels * self.bits) / 8);
+	return YES;
+}
+
 @end
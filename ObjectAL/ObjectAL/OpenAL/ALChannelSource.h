@@ -31,6 +31,7 @@
 #import "ALSoundSourcePool.h"
 #import "ALContext.h"
 
+@class OALParameterRamp;
 
 #pragma mark ALChannelSource
 
@@ -39,7 +40,11 @@
  * Property values are applied to all sources within the channel. <br>
  * Sounds will get played by any free sources within this channel. <br>
  * If all sources are busy when playback is requested, it will attempt to interrupt a source
- * to free it for playback.
+ * to free it for playback. <br>
+ * Fading a channel ramps its groupGain, which multiplies the gain of every source in it,
+ * so the sources keep their own gains. <br>
+ * Property changes are only written to sources that are playing (or paused). Other sources
+ * catch up when the channel next plays them, or when they are removed from the channel.
  */
 @interface ALChannelSource : NSObject <ALSoundSource>
 {
@@ -116,17 +121,23 @@
 	bool muted;
 	bool paused;
 
-	/** Target to inform when the current fade operation completes. */
-	id fadeCompleteTarget;
-	
-	/** Selector to call when the current fade operation completes. */
-	SEL fadeCompleteSelector;
-	
-	/** The expected number of sources that will callback when fading completes */
-	int expectedFadeCallbackCount;
+	/** Multiplier applied to the gain of every source in this channel. */
+	float groupGain;
 
-	/** The actual number of sources that have called back */
-	int currentFadeCallbackCount;
+	/** Ramps groupGain when fading. */
+	OALParameterRamp* groupGainRamp;
+
+	/** Incremented on every change to a property that is propagated lazily. */
+	NSUInteger propertyVersion;
+
+	/** The propertyVersion of the last change to each lazily propagated property. */
+	NSUInteger* propertyVersions;
+
+	/** The propertyVersion each source has caught up to (source -> NSUInteger). */
+	CFMutableDictionaryRef appliedVersions;
+
+	/** Sources this channel has started playing, which may still be playing. */
+	NSMutableSet* activeSources;
 	
 
 	/** Target to inform when the current pan operation completes. */
@@ -31,6 +31,7 @@
 #import "ObjectALMacros.h"
 #import "ARCSafe_MemMgmt.h"
 #import "OpenALManager.h"
+#import "OALParameterRamp.h"
 
 
 
@@ -55,6 +56,72 @@
 	} \
 }
 
+/** The properties that only get written to a source when it needs them.
+ * Paused and interruptible are always written, since they matter to idle sources too.
+ */
+#define LAZY_CHANNEL_PROPERTIES(X) \
+	X(coneInnerAngle, ConeInnerAngle) \
+	X(coneOuterAngle, ConeOuterAngle) \
+	X(coneOuterGain, ConeOuterGain) \
+	X(direction, Direction) \
+	X(gain, Gain) \
+	X(groupGain, GroupGain) \
+	X(looping, Looping) \
+	X(maxDistance, MaxDistance) \
+	X(maxGain, MaxGain) \
+	X(minGain, MinGain) \
+	X(muted, Muted) \
+	X(pitch, Pitch) \
+	X(position, Position) \
+	X(referenceDistance, ReferenceDistance) \
+	X(rolloffFactor, RolloffFactor) \
+	X(sourceRelative, SourceRelative) \
+	X(velocity, Velocity) \
+	X(reverbSendLevel, ReverbSendLevel) \
+	X(reverbOcclusion, ReverbOcclusion) \
+	X(reverbObstruction, ReverbObstruction)
+
+#define LAZY_PROPERTY_ENUM_ENTRY(NAME, CAPSNAME) kChannelProperty##CAPSNAME,
+
+typedef enum
+{
+	LAZY_CHANNEL_PROPERTIES(LAZY_PROPERTY_ENUM_ENTRY)
+	kNumLazyChannelProperties
+} ALChannelProperty;
+
+/** Like SYNTHESIZE_DELEGATE_PROPERTY, but only sources that this channel started and that
+ * are still playing (or paused) get the new value right away. The rest catch up in
+ * applyChangesToSource:.
+ */
+#define SYNTHESIZE_LAZY_DELEGATE_PROPERTY(NAME, CAPSNAME, TYPE) \
+- (TYPE) NAME \
+{ \
+	OPTIONALLY_SYNCHRONIZED(sourcePool) \
+	{ \
+		return NAME; \
+	} \
+} \
+ \
+- (void) set##CAPSNAME:(TYPE) value \
+{ \
+	OPTIONALLY_SYNCHRONIZED(sourcePool) \
+	{ \
+		NAME = value; \
+		propertyVersions[kChannelProperty##CAPSNAME] = ++propertyVersion; \
+		for(id<ALSoundSource> source in [activeSources allObjects]) \
+		{ \
+			if(source.playing || source.paused) \
+			{ \
+				[self applyChangesToSource:source]; \
+			} \
+			else \
+			{ \
+				[activeSources removeObject:source]; \
+			} \
+		} \
+	} \
+}
+
 
 
 #pragma mark -
@@ -66,10 +133,6 @@
  */
 @interface ALChannelSource (Private)
 
-/** (INTERNAL USE) Called by the action system when a fade completes.
- */
-- (void) onFadeComplete:(id<ALSoundSource>) source;
-
 /** (INTERNAL USE) Called by the action system when a pan completes.
  */
 - (void) onPanComplete:(id<ALSoundSource>) source;
@@ -82,6 +145,11 @@
  */
 - (void) setDefaultsFromChannel:(ALChannelSource*) channel;
 
+/** (INTERNAL USE) Write any property changes the source hasn't had yet.
+ * Must be called while synchronized on the source pool.
+ */
+- (void) applyChangesToSource:(id<ALSoundSource>) source;
+
 @end
 /** \endcond */
 
@@ -109,6 +177,11 @@
         }
 
 		sourcePool = [[ALSoundSourcePool alloc] init];
+		groupGain = 1.0f;
+		propertyVersions = calloc(kNumLazyChannelProperties, sizeof(*propertyVersions));
+		// Sources are retained by the pool, so neither keys nor values are retained here.
+		appliedVersions = CFDictionaryCreateMutable(NULL, 0, NULL, NULL);
+		activeSources = [[NSMutableSet alloc] init];
 
         for(int i = 0; i < reservedSources; i++)
         {
@@ -126,8 +199,16 @@ initFailed:
 {
 	OAL_LOG_DEBUG(@"%@: Dealloc", self);
 	
+	[groupGainRamp stop];
+	as_release(groupGainRamp);
 	as_release(sourcePool);
 	as_release(context);
+	free(propertyVersions);
+	if(NULL != appliedVersions)
+	{
+		CFRelease(appliedVersions);
+	}
+	as_release(activeSources);
 
     as_superdealloc();
 }
@@ -197,47 +278,49 @@ initFailed:
 	return NO;
 }
 
-SYNTHESIZE_DELEGATE_PROPERTY(coneInnerAngle, ConeInnerAngle, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(coneInnerAngle, ConeInnerAngle, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(coneOuterAngle, ConeOuterAngle, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(coneOuterAngle, ConeOuterAngle, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(coneOuterGain, ConeOuterGain, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(coneOuterGain, ConeOuterGain, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(direction, Direction, ALVector);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(direction, Direction, ALVector);
 
-SYNTHESIZE_DELEGATE_PROPERTY(gain, Gain, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(gain, Gain, float);
+
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(groupGain, GroupGain, float);
 
 SYNTHESIZE_DELEGATE_PROPERTY(interruptible, Interruptible, bool);
 
-SYNTHESIZE_DELEGATE_PROPERTY(looping, Looping, bool);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(looping, Looping, bool);
 
-SYNTHESIZE_DELEGATE_PROPERTY(maxDistance, MaxDistance, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(maxDistance, MaxDistance, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(maxGain, MaxGain, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(maxGain, MaxGain, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(minGain, MinGain, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(minGain, MinGain, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(muted, Muted, bool);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(muted, Muted, bool);
 
 SYNTHESIZE_DELEGATE_PROPERTY(paused, Paused, bool);
 
-SYNTHESIZE_DELEGATE_PROPERTY(pitch, Pitch, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(pitch, Pitch, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(position, Position, ALPoint);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(position, Position, ALPoint);
 
-SYNTHESIZE_DELEGATE_PROPERTY(referenceDistance, ReferenceDistance, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(referenceDistance, ReferenceDistance, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(rolloffFactor, RolloffFactor, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(rolloffFactor, RolloffFactor, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(sourceRelative, SourceRelative, int);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(sourceRelative, SourceRelative, int);
 
-SYNTHESIZE_DELEGATE_PROPERTY(velocity, Velocity, ALVector);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(velocity, Velocity, ALVector);
 
-SYNTHESIZE_DELEGATE_PROPERTY(reverbSendLevel, ReverbSendLevel, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(reverbSendLevel, ReverbSendLevel, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(reverbOcclusion, ReverbOcclusion, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(reverbOcclusion, ReverbOcclusion, float);
 
-SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
+SYNTHESIZE_LAZY_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 
 #pragma mark Playback
 
@@ -260,7 +343,13 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 		// Try to find a free source for playback.
 		// If this channel is not interruptible, it will not attempt to interrupt its contained sources.
 		id<ALSoundSource> soundSource = [sourcePool getFreeSource:interruptible];
-		return [soundSource play:buffer loop:loop];
+		[self applyChangesToSource:soundSource];
+		id<ALSoundSource> playingSource = [soundSource play:buffer loop:loop];
+		if(nil != playingSource)
+		{
+			[activeSources addObject:playingSource];
+		}
+		return playingSource;
 	}
 }
 
@@ -271,7 +360,13 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 		// Try to find a free source for playback.
 		// If this channel is not interruptible, it will not attempt to interrupt its contained sources.
 		id<ALSoundSource> soundSource = [sourcePool getFreeSource:interruptible];
-		return [soundSource play:buffer gain:gainIn pitch:pitchIn pan:panIn loop:loop];
+		[self applyChangesToSource:soundSource];
+		id<ALSoundSource> playingSource = [soundSource play:buffer gain:gainIn pitch:pitchIn pan:panIn loop:loop];
+		if(nil != playingSource)
+		{
+			[activeSources addObject:playingSource];
+		}
+		return playingSource;
 	}
 }
 
@@ -280,6 +375,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 	OPTIONALLY_SYNCHRONIZED(sourcePool)
 	{
         [sourcePool.sources makeObjectsPerformSelector:@selector(stop)];
+        [activeSources removeAllObjects];
 	}
 }
 
@@ -296,33 +392,12 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 	// Must always be synchronized
 	@synchronized(sourcePool)
 	{
-		[self stopFade];
-		fadeCompleteTarget = target;
-		fadeCompleteSelector = selector;
-
-		currentFadeCallbackCount = 0;
-		expectedFadeCallbackCount = (int)[sourcePool.sources count];
-		for(id<ALSoundSource> source in sourcePool.sources)
-		{
-			[source fadeTo:value duration:duration target:self selector:@selector(onFadeComplete:)];
-		}
-	}
-}
-
-- (void) onFadeComplete:(id<ALSoundSource>) source
-{
-    #pragma unused(source)
-	// Must always be synchronized
-	@synchronized(sourcePool)
-	{
-		currentFadeCallbackCount++;
-		if(currentFadeCallbackCount == expectedFadeCallbackCount)
+		// One ramp on the group gain fades every source, with a single callback.
+		if(nil == groupGainRamp)
 		{
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Warc-performSelector-leaks"
-			[fadeCompleteTarget performSelector:fadeCompleteSelector withObject:self];
-#pragma clang diagnostic pop
+			groupGainRamp = [[OALParameterRamp alloc] initWithTarget:self propertyKey:@"groupGain"];
 		}
+		[groupGainRamp rampTo:value duration:duration target:target selector:selector];
 	}
 }
 
@@ -331,7 +406,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 	// Must always be synchronized
 	@synchronized(sourcePool)
 	{
-		[sourcePool.sources makeObjectsPerformSelector:@selector(stopFade)];
+		[groupGainRamp stop];
 	}
 }
 
@@ -428,6 +503,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 	// Must always be synchronized
 	@synchronized(sourcePool)
 	{
+		[groupGainRamp stop];
 		[sourcePool.sources makeObjectsPerformSelector:@selector(stopActions)];
 	}
 }
@@ -438,6 +514,7 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 	OPTIONALLY_SYNCHRONIZED(sourcePool)
 	{
         [sourcePool.sources makeObjectsPerformSelector:@selector(clear)];
+        [activeSources removeAllObjects];
 	}
 }
 
@@ -495,10 +572,14 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
 
 - (void) resetToDefault
 {
-	OPTIONALLY_SYNCHRONIZED(sourcePool)
+	// Must always be synchronized
+	@synchronized(sourcePool)
 	{
+        // Otherwise a running fade would keep overwriting the reset group gain.
+        [groupGainRamp stop];
         self.pitch = defaultPitch;
         self.gain = defaultGain;
+        self.groupGain = 1.0f;
         self.maxDistance = defaultMaxDistance;
         self.rolloffFactor = defaultRolloffFactor;
         self.referenceDistance = defaultReferenceDistance;
@@ -532,30 +613,16 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
                 return;
             }
         }
-        if(defaultsInitialized)
-        {
-            source.pitch = pitch;
-            source.gain = gain;
-            source.maxDistance = maxDistance;
-            source.rolloffFactor = rolloffFactor;
-            source.referenceDistance = referenceDistance;
-            source.minGain = minGain;
-            source.maxGain = maxGain;
-            // Bug: Disabled due to OpenAL default ConeOuterGain value issue
-            // source.coneOuterGain = coneOuterGain;
-            source.coneInnerAngle = coneInnerAngle;
-            source.coneOuterAngle = coneOuterAngle;
-            source.position = position;
-            source.velocity = velocity;
-            source.direction = direction;
-            source.sourceRelative = sourceRelative;
-            source.looping = looping;
-        }
-        else
+        if(!defaultsInitialized)
         {
             [self setDefaultsFromSource:source];
             [self resetToDefault];
         }
+
+        // The new source has none of this channel's changes yet, so bring it fully up to date.
+        // coneOuterGain is only applied once it has been set, since its default can't be read reliably.
+        CFDictionarySetValue(appliedVersions, (as_bridge void*) source, (void*) 0);
+        [self applyChangesToSource:source];
         [sourcePool addSource:source];
     }
 }
@@ -573,12 +640,39 @@ SYNTHESIZE_DELEGATE_PROPERTY(reverbObstruction, ReverbObstruction, float);
             }
         }
         as_autorelease_noref(as_retain(source));
+        [self applyChangesToSource:source];
+        CFDictionaryRemoveValue(appliedVersions, (as_bridge void*) source);
+        [activeSources removeObject:source];
         [sourcePool removeSource:source];
+        source.groupGain = 1.0f;
     }
     
     return source;
 }
 
+- (void) applyChangesToSource:(id<ALSoundSource>) source
+{
+    if(nil == source)
+    {
+        return;
+    }
+    NSUInteger applied = (NSUInteger) CFDictionaryGetValue(appliedVersions, (as_bridge void*) source);
+    if(applied == propertyVersion)
+    {
+        return;
+    }
+
+#define APPLY_IF_CHANGED(NAME, CAPSNAME) \
+    if(propertyVersions[kChannelProperty##CAPSNAME] > applied) \
+    { \
+        source.NAME = NAME; \
+    }
+    LAZY_CHANNEL_PROPERTIES(APPLY_IF_CHANGED)
+#undef APPLY_IF_CHANGED
+
+    CFDictionarySetValue(appliedVersions, (as_bridge void*) source, (void*) propertyVersion);
+}
+
 - (ALChannelSource*) splitChannelWithSources:(int) numSources
 {
     ALChannelSource* newChannel;
@@ -190,6 +190,16 @@
  */
 - (void) process;
 
+/** Hold back changes to this context's sources and listener until processUpdates
+ * is called, so that they all take effect at the same moment.
+ * This context must be the current context.
+ */
+- (void) deferUpdates;
+
+/** Apply all changes held back since deferUpdates.
+ */
+- (void) processUpdates;
+
 /** Stop all sound sources in this context.
  */
 - (void) stopAllSounds;
@@ -156,17 +156,26 @@
 
 		suspendHandler = [[OALSuspendHandler alloc] initWithTarget:self selector:@selector(setSuspended:)];
 
-		// Build up an ALCint array for OpenAL's createContext function.
+		// Contexts on a loopback device must render in the device's format.
+		// These go last so that they take precedence.
+		NSArray* loopbackAttributes = [deviceIn loopbackContextAttributes];
+		if(nil != loopbackAttributes)
+		{
+			attributesIn = nil == attributesIn ? loopbackAttributes : [attributesIn arrayByAddingObjectsFromArray:loopbackAttributes];
+		}
+
+		// Build up a zero-terminated ALCint array for OpenAL's createContext function.
 		ALCint* attributesList = nil;
 
 		if([attributesIn count] > 0)
 		{
-			attributesList = (ALCint*)malloc(sizeof(ALCint) * [attributesIn count]);
+			attributesList = (ALCint*)malloc(sizeof(ALCint) * ([attributesIn count] + 1));
 			ALCint* attributePtr = attributesList;
 			for(NSNumber* number in attributesIn)
 			{
 				*attributePtr++ = [number intValue];
 			}
+			*attributePtr = 0;
 		}
 		
 		// Notify the device that we are being created.
@@ -415,6 +424,28 @@ initFailed:
 	[ALWrapper processContext:context];
 }
 
+- (void) deferUpdates
+{
+	if(self.suspended)
+	{
+		OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
+		return;
+	}
+
+	[ALWrapper deferUpdates:context];
+}
+
+- (void) processUpdates
+{
+	if(self.suspended)
+	{
+		OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
+		return;
+	}
+
+	[ALWrapper processUpdates:context];
+}
+
 - (void) stopAllSounds
 {
 	OPTIONALLY_SYNCHRONIZED(sources)
@@ -46,6 +46,14 @@
 	
 	/** Handles suspending and interrupting for this object. */
 	OALSuspendHandler* suspendHandler;
+
+	bool loopback;
+	ALCsizei renderFrequency;
+	ALCenum renderChannels;
+	ALCenum renderType;
+	/** The size of one rendered sample frame, in bytes. */
+	UInt32 bytesPerRenderFrame;
+	UInt32 automationBlockFrames;
 }
 
 
@@ -66,6 +74,27 @@
 /** The specification revision for this implementation (minor version). */
 @property(nonatomic,readonly,assign) int minorVersion;
 
+/** If YES, this is a loopback device, whose output is fetched with renderFrames:intoBuffer:. */
+@property(nonatomic,readonly,assign) bool loopback;
+
+/** The sample rate a loopback device renders at. */
+@property(nonatomic,readonly,assign) ALCsizei renderFrequency;
+
+/** The channel configuration a loopback device renders in (ALC_MONO_SOFT, ALC_STEREO_SOFT etc). */
+@property(nonatomic,readonly,assign) ALCenum renderChannels;
+
+/** The sample type a loopback device renders in (ALC_SHORT_SOFT, ALC_FLOAT_SOFT etc). */
+@property(nonatomic,readonly,assign) ALCenum renderType;
+
+/** The number of frames renderFrames:intoBuffer: mixes between steps of the action manager's
+ * audio sample clock (default kLoopbackAutomationBlockFrames, 0 = step once per render). <br>
+ *
+ * Only used when OALActionManager's clockMode is kOALActionClockAudioSamples. Actions
+ * (such as fades) are then stepped in time with the audio rather than by a timer, and
+ * OpenAL Soft smooths each change across the block it mixes.
+ */
+@property(nonatomic,readwrite,assign) UInt32 automationBlockFrames;
+
 
 #pragma mark Object Management
 
@@ -83,6 +112,32 @@
  */
 - (id) initWithDeviceSpecifier:(NSString*) deviceSpecifier;
 
+/** Open a loopback device (requires ALC_SOFT_loopback). <br>
+ *
+ * A loopback device doesn't play anything itself. Instead, its mixed output is fetched
+ * with renderFrames:intoBuffer:, usually from an audio callback or an offline render loop.
+ * Contexts created on it render in the format given here.
+ *
+ * @param frequency The sample rate to render at.
+ * @param channels The channel configuration (ALC_MONO_SOFT, ALC_STEREO_SOFT etc).
+ * @param type The sample type (ALC_SHORT_SOFT, ALC_FLOAT_SOFT etc).
+ * @return A new device, or nil if loopback devices or the format are not supported.
+ */
++ (id) loopbackDeviceWithFrequency:(ALCsizei) frequency
+						  channels:(ALCenum) channels
+							  type:(ALCenum) type;
+
+/** Initialize as a loopback device (requires ALC_SOFT_loopback).
+ *
+ * @param frequency The sample rate to render at.
+ * @param channels The channel configuration (ALC_MONO_SOFT, ALC_STEREO_SOFT etc).
+ * @param type The sample type (ALC_SHORT_SOFT, ALC_FLOAT_SOFT etc).
+ * @return the initialized device, or nil if loopback devices or the format are not supported.
+ */
+- (id) initLoopbackWithFrequency:(ALCsizei) frequency
+						channels:(ALCenum) channels
+							type:(ALCenum) type;
+
 
 #pragma mark Extensions
 
@@ -107,6 +162,16 @@
  */
 - (void) clearBuffers;
 
+/** Mix the output of a loopback device. <br>
+ *
+ * When OALActionManager's clockMode is kOALActionClockAudioSamples, the frames are mixed
+ * in blocks of automationBlockFrames, and the action manager is advanced before each block.
+ *
+ * @param numFrames The number of sample frames to mix.
+ * @param buffer The buffer to mix into. It must hold numFrames frames in the render format.
+ */
+- (void) renderFrames:(UInt32) numFrames intoBuffer:(void*) buffer;
+
 
 #pragma mark Internal Use
 
@@ -122,6 +187,12 @@
  * @param context The context that is deallocating.
  */
 - (void) notifyContextDeallocating:(ALContext*) context;
+
+/** (INTERNAL USE) Used by ALContext to get the attributes a loopback device's contexts need.
+ *
+ * @return The render format attributes, or nil if this is not a loopback device.
+ */
+- (NSArray*) loopbackContextAttributes;
 /** \endcond */
 
 @end
@@ -33,6 +33,7 @@
 #import "ARCSafe_MemMgmt.h"
 #import "ALWrapper.h"
 #import "OpenALManager.h"
+#import "OALActionManager.h"
 
 
 @implementation ALDevice
@@ -71,6 +72,88 @@ initFailed:
     return nil;
 }
 
++ (id) loopbackDeviceWithFrequency:(ALCsizei) frequency
+						  channels:(ALCenum) channels
+							  type:(ALCenum) type
+{
+	return as_autorelease([[self alloc] initLoopbackWithFrequency:frequency channels:channels type:type]);
+}
+
+- (id) initLoopbackWithFrequency:(ALCsizei) frequency
+						channels:(ALCenum) channels
+							type:(ALCenum) type
+{
+	if(nil != (self = [super init]))
+	{
+		suspendHandler = [[OALSuspendHandler alloc] initWithTarget:nil selector:nil];
+		
+		contexts = [NSMutableArray newMutableArrayUsingWeakReferencesWithCapacity:5];
+		
+		[[OpenALManager sharedInstance] notifyDeviceInitializing:self];
+		[[OpenALManager sharedInstance] addSuspendListener:self];
+		
+		OAL_LOG_DEBUG(@"%@: Init loopback device (%d Hz, channels 0x%x, type 0x%x)", self, frequency, channels, type);
+		
+		loopback = YES;
+		renderFrequency = frequency;
+		renderChannels = channels;
+		renderType = type;
+		automationBlockFrames = kLoopbackAutomationBlockFrames;
+		
+		UInt32 numChannels = 0;
+		switch(channels)
+		{
+			case ALC_MONO_SOFT: numChannels = 1; break;
+			case ALC_STEREO_SOFT: numChannels = 2; break;
+			case ALC_QUAD_SOFT: numChannels = 4; break;
+			case ALC_5POINT1_SOFT: numChannels = 6; break;
+			case ALC_6POINT1_SOFT: numChannels = 7; break;
+			case ALC_7POINT1_SOFT: numChannels = 8; break;
+		}
+		UInt32 bytesPerSample = 0;
+		switch(type)
+		{
+			case ALC_BYTE_SOFT:
+			case ALC_UNSIGNED_BYTE_SOFT:
+				bytesPerSample = 1;
+				break;
+			case ALC_SHORT_SOFT:
+			case ALC_UNSIGNED_SHORT_SOFT:
+				bytesPerSample = 2;
+				break;
+			case ALC_INT_SOFT:
+			case ALC_UNSIGNED_INT_SOFT:
+			case ALC_FLOAT_SOFT:
+				bytesPerSample = 4;
+				break;
+		}
+		bytesPerRenderFrame = numChannels * bytesPerSample;
+		if(0 == bytesPerRenderFrame)
+		{
+			OAL_LOG_ERROR(@"%@: Unknown render format (channels 0x%x, type 0x%x)", self, channels, type);
+            goto initFailed;
+		}
+		
+		device = [ALWrapper openLoopbackDevice:nil];
+		if(nil == device)
+		{
+			OAL_LOG_ERROR(@"%@: Failed to create OpenAL loopback device", self);
+            goto initFailed;
+		}
+		
+		if(![ALWrapper isRenderFormatSupported:device frequency:frequency channels:channels type:type])
+		{
+			OAL_LOG_ERROR(@"%@: Render format not supported (%d Hz, channels 0x%x, type 0x%x)", self, frequency, channels, type);
+            goto initFailed;
+		}
+	}
+	return self;
+	
+initFailed:
+    as_release(self);
+    return nil;
+}
+
 - (void) dealloc
 {
 	OAL_LOG_DEBUG(@"%@: Dealloc", self);
@@ -78,7 +161,10 @@ initFailed:
 	[[OpenALManager sharedInstance] removeSuspendListener:self];
 	[[OpenALManager sharedInstance] notifyDeviceDeallocating:self];
 
-    [ALWrapper closeDevice:device];
+    if(NULL != device)
+    {
+        [ALWrapper closeDevice:device];
+    }
 	
 	as_release(contexts);
 	as_release(suspendHandler);
@@ -107,6 +193,16 @@ initFailed:
 	return [ALWrapper getInteger:device attribute:ALC_MINOR_VERSION];
 }
 
+@synthesize loopback;
+
+@synthesize renderFrequency;
+
+@synthesize renderChannels;
+
+@synthesize renderType;
+
+@synthesize automationBlockFrames;
+
 #pragma mark Suspend Handler
 
 - (void) addSuspendListener:(id<OALSuspendListener>) listener
@@ -171,6 +267,42 @@ initFailed:
 	}
 }
 
+- (void) renderFrames:(UInt32) numFrames intoBuffer:(void*) buffer
+{
+	if(!loopback)
+	{
+		OAL_LOG_ERROR(@"%@: renderFrames:intoBuffer: only works on a loopback device", self);
+		return;
+	}
+
+	UInt32 blockFrames = numFrames;
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+	OALActionManager* actionManager = [OALActionManager sharedInstance];
+	bool stepActions = kOALActionClockAudioSamples == actionManager.clockMode;
+	if(stepActions && automationBlockFrames > 0)
+	{
+		blockFrames = automationBlockFrames;
+	}
+#endif
+
+	uint8_t* position = buffer;
+	while(numFrames > 0)
+	{
+		UInt32 frames = numFrames < blockFrames ? numFrames : blockFrames;
+#if !OBJECTAL_CFG_USE_COCOS2D_ACTIONS
+		// Step to the end of the block first, so that OpenAL Soft ramps each
+		// parameter from its value at the start of the block to its value at the end.
+		if(stepActions)
+		{
+			[actionManager advanceSamples:frames];
+		}
+#endif
+		[ALWrapper renderSamples:device buffer:position numFrames:(ALCsizei)frames];
+		position += frames * bytesPerRenderFrame;
+		numFrames -= frames;
+	}
+}
+
 
 #pragma mark Internal Use
 
@@ -194,4 +326,17 @@ initFailed:
 	}
 }
 
+- (NSArray*) loopbackContextAttributes
+{
+	if(!loopback)
+	{
+		return nil;
+	}
+	return [NSArray arrayWithObjects:
+			[NSNumber numberWithInt:ALC_FREQUENCY], [NSNumber numberWithInt:renderFrequency],
+			[NSNumber numberWithInt:ALC_FORMAT_CHANNELS_SOFT], [NSNumber numberWithInt:renderChannels],
+			[NSNumber numberWithInt:ALC_FORMAT_TYPE_SOFT], [NSNumber numberWithInt:renderType],
+			nil];
+}
+
 @end
@@ -62,6 +62,11 @@
 /** Gain (volume) (OpenAL property). */
 @property(nonatomic,readwrite,assign) float gain;
 
+/** A multiplier applied to gain by the channel this source belongs to (default 1.0).
+ * Channel fades ramp this rather than each source's gain.
+ */
+@property(nonatomic,readwrite,assign) float groupGain;
+
 /** Volume (alias to gain). */
 @property(nonatomic,readwrite,assign) float volume;
 
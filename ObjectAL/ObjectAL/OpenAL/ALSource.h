@@ -35,6 +35,7 @@
 #import "OALSuspendHandler.h"
 
 @class ALContext;
+@class OALParameterRamp;
 @class ALSource;
 
 
@@ -51,6 +52,9 @@ typedef void (^OALSourceNotificationCallback)(ALSource* source, ALuint notificat
 	ALuint sourceId;
 	bool interruptible;
 	float gain;
+	float groupGain;
+	/** The gain last written to OpenAL. */
+	float appliedGain;
 	bool muted;
 
 	/** Shadow value which keeps the correct state value
@@ -67,14 +71,14 @@ typedef void (^OALSourceNotificationCallback)(ALSource* source, ALuint notificat
 	ALBuffer* buffer;
 	ALContext* context;
 
-	/** Current action operating on the gain control. */
-	OALAction* gainAction;
+	/** Reusable ramp operating on the gain control. */
+	OALParameterRamp* gainRamp;
 
-	/** Current action operating on the pan control. */
-	OALAction* panAction;
+	/** Reusable ramp operating on the pan control. */
+	OALParameterRamp* panRamp;
 
-	/** Current action operating on the pitch control. */
-	OALAction* pitchAction;
+	/** Reusable ramp operating on the pitch control. */
+	OALParameterRamp* pitchRamp;
 	
 	/** Handles suspending and interrupting for this object. */
 	OALSuspendHandler* suspendHandler;
@@ -32,8 +32,7 @@
 #import "ARCSafe_MemMgmt.h"
 #import "ALWrapper.h"
 #import "OpenALManager.h"
-#import "OALAudioActions.h"
-#import "OALUtilityActions.h"
+#import "OALParameterRamp.h"
 #import "NSMutableDictionary+WeakReferences.h"
 
 
@@ -54,6 +53,12 @@
  * get around OpenAL bug.
  */
 - (void) delayedResumePlayback;
+
+/** (INTERNAL USE) Write the effective gain (gain * groupGain, or 0 if muted) to OpenAL.
+ *
+ * @param always If FALSE, skip the write if the gain has changed by kGroupGainEpsilon or less.
+ */
+- (void) applyGain:(bool) always;
 /** \endcond */
 
 - (void) receiveNotification:(ALuint) notificationID userData:(void*) userData;
@@ -133,6 +138,8 @@ static ALvoid alSourceNotification(ALuint sid, ALuint notificationID, ALvoid* us
 
 		[context notifySourceInitializing:self];
 		gain = [ALWrapper getSourcef:sourceId parameter:AL_GAIN];
+		groupGain = 1.0f;
+		appliedGain = gain;
 		shadowState = AL_INITIAL;
 		
 		[context addSuspendListener:self];
@@ -154,12 +161,12 @@ initFailed:
 	[context removeSuspendListener:self];
 	[context notifySourceDeallocating:self];
 
-	[gainAction stopAction];
-	as_release(gainAction);
-	[panAction stopAction];
-	as_release(panAction);
-	[pitchAction stopAction];
-	as_release(pitchAction);
+	[gainRamp stop];
+	as_release(gainRamp);
+	[panRamp stop];
+	as_release(panRamp);
+	[pitchRamp stop];
+	as_release(pitchRamp);
 	as_release(suspendHandler);
     as_release(_notificationCallbacks);
 
@@ -346,12 +353,39 @@ initFailed:
 		}
 		
 		gain = value;
-		if(muted)
+		[self applyGain:YES];
+	}
+}
+
+- (float) groupGain
+{
+    return groupGain;
+}
+
+- (void) setGroupGain:(float) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(self.suspended)
 		{
-			value = 0;
+			OAL_LOG_DEBUG(@"%@: Called mutator on suspended object", self);
+			return;
 		}
-		[ALWrapper sourcef:sourceId parameter:AL_GAIN value:value];
+		
+		groupGain = value;
+		[self applyGain:0 == value || 1.0f == value];
+	}
+}
+
+- (void) applyGain:(bool) always
+{
+	float value = muted ? 0 : gain * groupGain;
+	if(!always && fabsf(value - appliedGain) <= kGroupGainEpsilon)
+	{
+		return;
 	}
+	appliedGain = value;
+	[ALWrapper sourcef:sourceId parameter:AL_GAIN value:value];
 }
 
 @synthesize interruptible;
@@ -1137,13 +1171,12 @@ initFailed:
 			return;
 		}
 		
-		[self stopFade];
-		gainAction = [OALSequentialActions actions:
-                      [OALPropertyAction gainActionWithDuration:duration endValue:value],
-                      [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
-                      nil];
-        gainAction = as_retain(gainAction);
-		[gainAction runWithTarget:self];
+		// The ramp is reused for every change, so nothing is allocated after the first one.
+		if(nil == gainRamp)
+		{
+			gainRamp = [[OALParameterRamp alloc] initWithTarget:self propertyKey:@"gain"];
+		}
+		[gainRamp rampTo:value duration:duration target:target selector:selector];
 	}
 }
 
@@ -1158,9 +1191,7 @@ initFailed:
 			return;
 		}
 		
-		[gainAction stopAction];
-		as_release(gainAction);
-		gainAction = nil;
+		[gainRamp stop];
 	}
 }
 
@@ -1178,13 +1209,11 @@ initFailed:
 			return;
 		}
 		
-		[self stopPan];
-		panAction = [OALSequentialActions actions:
-                     [OALPropertyAction panActionWithDuration:duration endValue:value],
-                     [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
-                     nil];
-        panAction = as_retain(panAction);
-		[panAction runWithTarget:self];
+		if(nil == panRamp)
+		{
+			panRamp = [[OALParameterRamp alloc] initWithTarget:self propertyKey:@"pan"];
+		}
+		[panRamp rampTo:value duration:duration target:target selector:selector];
 	}
 }
 
@@ -1199,9 +1228,7 @@ initFailed:
 			return;
 		}
 		
-		[panAction stopAction];
-		as_release(panAction);
-		panAction = nil;
+		[panRamp stop];
 	}
 }
 
@@ -1219,13 +1246,11 @@ initFailed:
 			return;
 		}
 		
-		[self stopPitch];
-		pitchAction = [OALSequentialActions actions:
-                       [OALPropertyAction pitchActionWithDuration:duration endValue:value],
-					   [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
-					   nil];
-        pitchAction = as_retain(pitchAction);
-		[pitchAction runWithTarget:self];
+		if(nil == pitchRamp)
+		{
+			pitchRamp = [[OALParameterRamp alloc] initWithTarget:self propertyKey:@"pitch"];
+		}
+		[pitchRamp rampTo:value duration:duration target:target selector:selector];
 	}
 }
 
@@ -1240,9 +1265,7 @@ initFailed:
 			return;
 		}
 		
-		[pitchAction stopAction];
-		as_release(pitchAction);
-		pitchAction = nil;
+		[pitchRamp stop];
 	}
 }
 
@@ -36,6 +36,28 @@
 #import <OpenAL/MacOSX_OALExtensions.h>
 #endif
 
+#ifndef ALC_SOFT_loopback
+/** ALC_SOFT_loopback (from OpenAL Soft's alext.h) */
+#define ALC_SOFT_loopback 1
+#define ALC_FORMAT_CHANNELS_SOFT 0x1990
+#define ALC_FORMAT_TYPE_SOFT 0x1991
+
+#define ALC_BYTE_SOFT 0x1400
+#define ALC_UNSIGNED_BYTE_SOFT 0x1401
+#define ALC_SHORT_SOFT 0x1402
+#define ALC_UNSIGNED_SHORT_SOFT 0x1403
+#define ALC_INT_SOFT 0x1404
+#define ALC_UNSIGNED_INT_SOFT 0x1405
+#define ALC_FLOAT_SOFT 0x1406
+
+#define ALC_MONO_SOFT 0x1500
+#define ALC_STEREO_SOFT 0x1501
+#define ALC_QUAD_SOFT 0x1503
+#define ALC_5POINT1_SOFT 0x1504
+#define ALC_6POINT1_SOFT 0x1505
+#define ALC_7POINT1_SOFT 0x1506
+#endif
+
 
 /**
  * A thin wrapper around the C OpenAL API, with a few convenience methods thrown in.
@@ -812,6 +834,20 @@
  */
 + (void) suspendContext:(ALCcontext*) context;
 
+/** Hold back changes to sources and the listener until processUpdates: is called,
+ * so that they all take effect together. Uses AL_SOFT_deferred_updates if available,
+ * otherwise suspends the context.
+ *
+ * @param context The context (must be the current context).
+ */
++ (void) deferUpdates:(ALCcontext*) context;
+
+/** Apply all changes held back since deferUpdates:.
+ *
+ * @param context The context (must be the current context).
+ */
++ (void) processUpdates:(ALCcontext*) context;
+
 /** Destroy a context.
  *
  * @param context The contect to destroy.
@@ -969,6 +1005,51 @@
 			 numSamples:(ALCsizei) numSamples;
 
 
+#pragma mark Loopback functions
+
+/** Check if loopback devices are available (ALC_SOFT_loopback). <br>
+ *
+ * Apple's OpenAL doesn't support them, but OpenAL Soft does.
+ *
+ * @return TRUE if loopback devices can be opened.
+ */
++ (bool) isLoopbackSupported;
+
+/** Open a loopback device. A loopback device doesn't play anything itself. Instead, the mixed
+ * output is fetched with renderSamples:buffer:numFrames:.
+ *
+ * @param deviceName The name of the device to open (nil = open the default loopback device).
+ * @return The opened device, or nil on failure.
+ */
++ (ALCdevice*) openLoopbackDevice:(NSString*) deviceName;
+
+/** Check if a loopback device can render in the specified format.
+ *
+ * @param device The loopback device.
+ * @param frequency The sample rate to render at.
+ * @param channels The channel configuration (ALC_MONO_SOFT, ALC_STEREO_SOFT etc).
+ * @param type The sample type (ALC_SHORT_SOFT, ALC_FLOAT_SOFT etc).
+ * @return TRUE if the format is supported.
+ */
++ (bool) isRenderFormatSupported:(ALCdevice*) device
+					   frequency:(ALCsizei) frequency
+						channels:(ALCenum) channels
+							type:(ALCenum) type;
+
+/** Mix audio from a loopback device. <br>
+ *
+ * This is not synchronized, since it is normally called from a real-time audio thread.
+ * OpenAL Soft guards its own mixer.
+ *
+ * @param device The loopback device.
+ * @param buffer The buffer to mix into (in the format of the device's contexts).
+ * @param numFrames The number of sample frames to mix.
+ */
++ (void) renderSamples:(ALCdevice*) device
+				buffer:(ALCvoid*) buffer
+			 numFrames:(ALCsizei) numFrames;
+
+
 #pragma mark iOS extensions
 
 /** Get the iOS device's mixer outut data rate.
@@ -106,6 +106,19 @@ static alcASASetListenerProcPtr alcASASetListener = NULL;
 static alSourceAddNotificationProcPtr alSourceAddNotification = NULL;
 static alSourceRemoveNotificationProcPtr alSourceRemoveNotification = NULL;
 
+/** AL_SOFT_deferred_updates */
+typedef ALvoid AL_APIENTRY (*alDeferUpdatesProcPtr) (void);
+static alDeferUpdatesProcPtr alDeferUpdatesSOFT = NULL;
+static alDeferUpdatesProcPtr alProcessUpdatesSOFT = NULL;
+
+/** ALC_SOFT_loopback */
+typedef ALCdevice* ALC_APIENTRY (*alcLoopbackOpenDeviceProcPtr) (const ALCchar* deviceName);
+typedef ALCboolean ALC_APIENTRY (*alcIsRenderFormatSupportedProcPtr) (ALCdevice* device, ALCsizei freq, ALCenum channels, ALCenum type);
+typedef ALCvoid ALC_APIENTRY (*alcRenderSamplesProcPtr) (ALCdevice* device, ALCvoid* buffer, ALCsizei samples);
+static alcLoopbackOpenDeviceProcPtr alcLoopbackOpenDeviceSOFT = NULL;
+static alcIsRenderFormatSupportedProcPtr alcIsRenderFormatSupportedSOFT = NULL;
+static alcRenderSamplesProcPtr alcRenderSamplesSOFT = NULL;
+
 
 #pragma mark -
 #pragma mark Error Handling
@@ -446,6 +459,60 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 }
 
 
+#pragma mark Loopback
+
++ (bool) isLoopbackSupported
+{
+	return NULL != alcLoopbackOpenDeviceSOFT && NULL != alcRenderSamplesSOFT;
+}
+
++ (ALCdevice*) openLoopbackDevice:(NSString*) deviceName
+{
+	if(![self isLoopbackSupported])
+	{
+		OAL_LOG_ERROR(@"Could not open loopback device %@: ALC_SOFT_loopback is not supported", deviceName);
+		return NULL;
+	}
+
+	ALCdevice* result;
+	@synchronized(self)
+	{
+		result = alcLoopbackOpenDeviceSOFT([deviceName UTF8String]);
+		if(NULL == result)
+		{
+			OAL_LOG_ERROR(@"Could not open loopback device %@", deviceName);
+		}
+	}
+	return result;
+}
+
++ (bool) isRenderFormatSupported:(ALCdevice*) device
+					   frequency:(ALCsizei) frequency
+						channels:(ALCenum) channels
+							type:(ALCenum) type
+{
+	if(NULL == alcIsRenderFormatSupportedSOFT)
+	{
+		return NO;
+	}
+
+	bool result;
+	@synchronized(self)
+	{
+		result = alcIsRenderFormatSupportedSOFT(device, frequency, channels, type);
+		CHECK_ALC_CALL(device);
+	}
+	return result;
+}
+
++ (void) renderSamples:(ALCdevice*) device
+				buffer:(ALCvoid*) buffer
+			 numFrames:(ALCsizei) numFrames
+{
+	alcRenderSamplesSOFT(device, buffer, numFrames);
+}
+
+
 #pragma mark -
 #pragma mark Context Management
 
@@ -503,6 +570,36 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 	}
 }
 
++ (void) deferUpdates:(ALCcontext*) context
+{
+	if(NULL == alDeferUpdatesSOFT)
+	{
+		[self suspendContext:context];
+		return;
+	}
+
+	@synchronized(self)
+	{
+		alDeferUpdatesSOFT();
+		CHECK_AL_CALL();
+	}
+}
+
++ (void) processUpdates:(ALCcontext*) context
+{
+	if(NULL == alProcessUpdatesSOFT)
+	{
+		[self processContext:context];
+		return;
+	}
+
+	@synchronized(self)
+	{
+		alProcessUpdatesSOFT();
+		CHECK_AL_CALL();
+	}
+}
+
 + (void) destroyContext:(ALCcontext*) context
 {
 	@synchronized(self)
@@ -1374,6 +1471,13 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
     alSourceAddNotification = (alSourceAddNotificationProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alSourceAddNotification");
     alSourceRemoveNotification = (alSourceRemoveNotificationProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alSourceRemoveNotification");
+
+    alDeferUpdatesSOFT = (alDeferUpdatesProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alDeferUpdatesSOFT");
+    alProcessUpdatesSOFT = (alDeferUpdatesProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alProcessUpdatesSOFT");
+
+    alcLoopbackOpenDeviceSOFT = (alcLoopbackOpenDeviceProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alcLoopbackOpenDeviceSOFT");
+    alcIsRenderFormatSupportedSOFT = (alcIsRenderFormatSupportedProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alcIsRenderFormatSupportedSOFT");
+    alcRenderSamplesSOFT = (alcRenderSamplesProcPtr) alcGetProcAddress(NULL, (const ALCchar*) "alcRenderSamplesSOFT");
 }
 
 + (ALdouble) getMixerOutputDataRate
@@ -0,0 +1,189 @@
+//
+//  OALStreamingSource.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import <Foundation/Foundation.h>
+#import "ALSource.h"
+#import "OALAudioFile.h"
+
+@class OALStreamWorker;
+
+
+#pragma mark OALStreamingSource
+
+/**
+ * Plays an audio file through OpenAL without decoding it all into memory.
+ *
+ * A background thread decodes the file in fixed-size chunks into a small pool of
+ * ALBuffer objects, queues them on an ALSource, and recycles them once they have
+ * been played. Memory use depends only on the pool size, not on the length of the
+ * file, which makes this suitable for long music or ambience tracks.
+ *
+ * Use the source property to control gain, pitch, position and so on. Do not
+ * attach buffers to that source or set its looping property yourself;
+ * use the looping property of this object instead.
+ *
+ * The streaming thread does not retain this object. Releasing a stream that is
+ * still playing stops it.
+ */
+@interface OALStreamingSource : NSObject
+{
+	OALAudioFile* file;
+	ALSource* source;
+
+	/** All buffers in the pool (ALBuffer*). */
+	NSMutableArray* buffers;
+	/** Buffers currently queued on the source, oldest first (ALBuffer*). */
+	NSMutableArray* queuedBuffers;
+	/** Buffers available for decoding into (ALBuffer*). */
+	NSMutableArray* freeBuffers;
+	/** File frame that each pool buffer's data starts at (parallel to "buffers"). */
+	SInt64* bufferStartFrames;
+	/** Number of frames held by each pool buffer (parallel to "buffers"). */
+	UInt32* bufferFrameCounts;
+
+	UInt32 framesPerBuffer;
+	/** The next frame to be decoded from the file. */
+	SInt64 nextFrame;
+	bool looping;
+	bool playing;
+	bool paused;
+	/** If TRUE, the whole file has been decoded and no more data will be queued. */
+	bool endOfStream;
+
+	/** Guards the stream's state. Shared with the streaming thread, which doesn't retain the stream. */
+	id streamLock;
+	/** The thread that keeps the buffer queue topped up. */
+	NSThread* streamThread;
+	/** Services this stream on the streaming thread. */
+	OALStreamWorker* streamWorker;
+	/** Used to wake the streaming thread early. */
+	NSCondition* streamCondition;
+	/** How long the streaming thread sleeps between checks, in seconds. */
+	NSTimeInterval pollInterval;
+}
+
+
+#pragma mark Properties
+
+/** The URL of the audio file being streamed. */
+@property(nonatomic,readonly,retain) NSURL* url;
+
+/** The audio file being streamed. */
+@property(nonatomic,readonly,retain) OALAudioFile* file;
+
+/** The source that the stream is played through. */
+@property(nonatomic,readonly,retain) ALSource* source;
+
+/** The number of buffers in the pool. */
+@property(nonatomic,readonly,assign) NSUInteger numBuffers;
+
+/** The number of audio frames decoded into each buffer. */
+@property(nonatomic,readonly,assign) UInt32 framesPerBuffer;
+
+/** The total number of audio frames in the stream. */
+@property(nonatomic,readonly,assign) SInt64 totalFrames;
+
+/** The frame currently being heard. */
+@property(nonatomic,readonly,assign) SInt64 currentFrame;
+
+/** The duration of the stream, in seconds. */
+@property(nonatomic,readonly,assign) NSTimeInterval duration;
+
+/** If TRUE, start over from the beginning when the end of the stream is reached. */
+@property(nonatomic,readwrite,assign) bool looping;
+
+/** If TRUE, the stream is playing (paused streams are still considered to be playing). */
+@property(nonatomic,readonly,assign) bool playing;
+
+/** Pauses or resumes playback. */
+@property(nonatomic,readwrite,assign) bool paused;
+
+
+#pragma mark Object Management
+
+/** Create a new stream with the default buffer pool (4 buffers of 8192 frames).
+ *
+ * @param url The URL of the audio file to stream.
+ * @return A new stream, or nil if the file could not be opened.
+ */
++ (id) streamWithUrl:(NSURL*) url;
+
+/** Create a new stream with the default buffer pool (4 buffers of 8192 frames).
+ *
+ * @param url The URL of the audio file to stream.
+ * @param reduceToMono If true, reduce the audio to mono
+ *        (stereo samples don't support panning or positional audio).
+ * @return A new stream, or nil if the file could not be opened.
+ */
++ (id) streamWithUrl:(NSURL*) url reduceToMono:(bool) reduceToMono;
+
+/** Initialize a stream on the current context.
+ *
+ * @param url The URL of the audio file to stream.
+ * @param reduceToMono If true, reduce the audio to mono
+ *        (stereo samples don't support panning or positional audio).
+ * @param numBuffers The number of buffers in the pool (minimum 2).
+ * @param framesPerBuffer The number of audio frames to decode into each buffer.
+ * @return The initialized stream, or nil if the file could not be opened.
+ */
+- (id) initWithUrl:(NSURL*) url
+	  reduceToMono:(bool) reduceToMono
+		numBuffers:(NSUInteger) numBuffers
+   framesPerBuffer:(UInt32) framesPerBuffer;
+
+
+#pragma mark Playback
+
+/** Start playing from the current position (the beginning of the file, unless seekToFrame:
+ * has been called). If the stream is already playing, it restarts from the beginning.
+ *
+ * @return TRUE if the operation was successful.
+ */
+- (bool) play;
+
+/** Stop playback and rewind to the beginning of the file.
+ */
+- (void) stop;
+
+/** Move the playback position. Works whether or not the stream is playing.
+ *
+ * @param frame The audio frame to continue playback from.
+ * @return TRUE if the operation was successful.
+ */
+- (bool) seekToFrame:(SInt64) frame;
+
+/** Move the playback position. Works whether or not the stream is playing.
+ *
+ * @param time The time, in seconds, to continue playback from.
+ * @return TRUE if the operation was successful.
+ */
+- (bool) seekToTime:(NSTimeInterval) time;
+
+@end
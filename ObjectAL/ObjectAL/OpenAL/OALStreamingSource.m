@@ -0,0 +1,669 @@
+//
+//  OALStreamingSource.m
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import "OALStreamingSource.h"
+#import "ALWrapper.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+
+/** The default number of buffers in a stream's pool. */
+#define kDefaultNumBuffers 4
+
+/** The default number of frames decoded into each buffer. */
+#define kDefaultFramesPerBuffer 8192
+
+/** The longest time the streaming thread will sleep between checks, in seconds. */
+#define kMaxPollInterval 0.1
+
+
+#pragma mark -
+#pragma mark OALStreamWorker
+
+/** \cond */
+/**
+ * (INTERNAL USE) Runs the streaming thread without keeping the stream alive.
+ * The thread retains the worker rather than the stream. The stream detaches the
+ * worker under the shared stream lock when it stops streaming or goes away.
+ */
+@interface OALStreamWorker : NSObject
+{
+	/** The stream to service (nil once detached). */
+	as_unsafe_unretained OALStreamingSource* stream;
+	/** The stream's lock. Held while servicing and while detaching. */
+	id lock;
+	/** Used to wake the streaming thread early. */
+	NSCondition* condition;
+	/** How long to sleep between checks, in seconds. */
+	NSTimeInterval pollInterval;
+}
+
+/** (INTERNAL USE) Initialize a worker for a stream.
+ *
+ * @param stream The stream to service.
+ * @param lock The stream's lock.
+ * @param condition Signalled to wake the thread early.
+ * @param pollInterval How long to sleep between checks, in seconds.
+ * @return The initialized worker.
+ */
+- (id) initWithStream:(OALStreamingSource*) stream
+				 lock:(id) lock
+			condition:(NSCondition*) condition
+		 pollInterval:(NSTimeInterval) pollInterval;
+
+/** (INTERNAL USE) Stop servicing the stream. Must be called with the stream's lock held.
+ */
+- (void) detach;
+
+/** (INTERNAL USE) Entry point for the streaming thread.
+ */
+- (void) run;
+
+@end
+/** \endcond */
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for OALStreamingSource.
+ */
+@interface OALStreamingSource (Private)
+
+/** (INTERNAL USE) Recycle played buffers, top up the queue, and recover from underruns.
+ */
+- (void) service;
+
+/** (INTERNAL USE) Decode the next chunk of the file into a buffer.
+ *
+ * @param buffer The buffer to decode into.
+ * @return TRUE if the buffer now contains audio data.
+ */
+- (bool) fillBuffer:(ALBuffer*) buffer;
+
+/** (INTERNAL USE) Decode into and queue as many free buffers as possible.
+ */
+- (void) fillFreeBuffers;
+
+/** (INTERNAL USE) Stop the source and return all queued buffers to the free list.
+ */
+- (void) unqueueAllBuffers;
+
+/** (INTERNAL USE) Start the streaming thread.
+ */
+- (void) startStreamThread;
+
+/** (INTERNAL USE) Detach the streaming thread from this stream and signal it to exit.
+ * Must be called with the stream lock held.
+ */
+- (void) stopStreamThread;
+
+@end
+/** \endcond */
+
+
+#pragma mark -
+#pragma mark OALStreamWorker
+
+@implementation OALStreamWorker
+
+- (id) initWithStream:(OALStreamingSource*) streamIn
+				 lock:(id) lockIn
+			condition:(NSCondition*) conditionIn
+		 pollInterval:(NSTimeInterval) pollIntervalIn
+{
+	if(nil != (self = [super init]))
+	{
+		stream = streamIn;
+		lock = as_retain(lockIn);
+		condition = as_retain(conditionIn);
+		pollInterval = pollIntervalIn;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	as_release(lock);
+	as_release(condition);
+	as_superdealloc();
+}
+
+- (void) detach
+{
+	stream = nil;
+}
+
+- (void) run
+{
+	NSThread* thread = [NSThread currentThread];
+	while(![thread isCancelled])
+	{
+		as_autoreleasepool_start(pool);
+		@synchronized(lock)
+		{
+			[stream service];
+		}
+		as_autoreleasepool_end(pool);
+
+		[condition lock];
+		if(![thread isCancelled])
+		{
+			[condition waitUntilDate:[NSDate dateWithTimeIntervalSinceNow:pollInterval]];
+		}
+		[condition unlock];
+	}
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OALStreamingSource
+
+@implementation OALStreamingSource
+
+#pragma mark Object Management
+
++ (id) streamWithUrl:(NSURL*) url
+{
+	return [self streamWithUrl:url reduceToMono:NO];
+}
+
++ (id) streamWithUrl:(NSURL*) url reduceToMono:(bool) reduceToMono
+{
+	return as_autorelease([[self alloc] initWithUrl:url
+									   reduceToMono:reduceToMono
+										 numBuffers:kDefaultNumBuffers
+									framesPerBuffer:kDefaultFramesPerBuffer]);
+}
+
+- (id) initWithUrl:(NSURL*) url
+	  reduceToMono:(bool) reduceToMono
+		numBuffers:(NSUInteger) numBuffers
+   framesPerBuffer:(UInt32) framesPerBufferIn
+{
+	if(nil != (self = [super init]))
+	{
+		OAL_LOG_DEBUG(@"%@: Init with url %@, %lu buffers of %u frames",
+					  self, url, (unsigned long)numBuffers, (unsigned int)framesPerBufferIn);
+
+		if(numBuffers < 2)
+		{
+			OAL_LOG_WARNING(@"%@: A stream needs at least 2 buffers. Using 2", self);
+			numBuffers = 2;
+		}
+		if(framesPerBufferIn < 1)
+		{
+			OAL_LOG_WARNING(@"%@: Invalid buffer size %u. Using %d", self, (unsigned int)framesPerBufferIn, kDefaultFramesPerBuffer);
+			framesPerBufferIn = kDefaultFramesPerBuffer;
+		}
+		framesPerBuffer = framesPerBufferIn;
+
+		file = [[OALAudioFile alloc] initWithUrl:url reduceToMono:reduceToMono];
+		if(nil == file)
+		{
+			OAL_LOG_ERROR(@"%@: Could not open audio file %@", self, url);
+			goto initFailed;
+		}
+
+		source = as_retain([ALSource source]);
+		if(nil == source)
+		{
+			OAL_LOG_ERROR(@"%@: Could not create a source", self);
+			goto initFailed;
+		}
+
+		AudioStreamBasicDescription* desc = file.streamDescription;
+		ALsizei bytesPerBuffer = (ALsizei)(framesPerBuffer * desc->mBytesPerFrame);
+		buffers = [[NSMutableArray alloc] initWithCapacity:numBuffers];
+		for(NSUInteger i = 0; i < numBuffers; i++)
+		{
+			void* data = calloc(1, (size_t)bytesPerBuffer);
+			if(nil == data)
+			{
+				OAL_LOG_ERROR(@"%@: Could not allocate %d bytes for stream buffer", self, bytesPerBuffer);
+				goto initFailed;
+			}
+			ALBuffer* buffer = [ALBuffer bufferWithName:[NSString stringWithFormat:@"%@ (stream buffer %lu)", url, (unsigned long)i]
+												   data:data
+												   size:bytesPerBuffer
+												 format:file.format
+											  frequency:(ALsizei)desc->mSampleRate];
+			if(nil == buffer)
+			{
+				OAL_LOG_ERROR(@"%@: Could not create stream buffer", self);
+				goto initFailed;
+			}
+			[buffers addObject:buffer];
+		}
+		bufferStartFrames = calloc(numBuffers, sizeof(*bufferStartFrames));
+		bufferFrameCounts = calloc(numBuffers, sizeof(*bufferFrameCounts));
+		queuedBuffers = [[NSMutableArray alloc] initWithCapacity:numBuffers];
+		freeBuffers = [[NSMutableArray alloc] initWithArray:buffers];
+
+		streamLock = [[NSObject alloc] init];
+		streamCondition = [[NSCondition alloc] init];
+
+		// Wake up often enough to refill a buffer well before the queue runs dry.
+		pollInterval = (NSTimeInterval)framesPerBuffer / desc->mSampleRate / 4;
+		if(pollInterval > kMaxPollInterval)
+		{
+			pollInterval = kMaxPollInterval;
+		}
+	}
+	return self;
+
+initFailed:
+	as_release(self);
+	return nil;
+}
+
+- (void) dealloc
+{
+	OAL_LOG_DEBUG(@"%@: Dealloc", self);
+
+	// The streaming thread may be servicing this stream right now,
+	// so it must be detached under the stream lock.
+	@synchronized(streamLock)
+	{
+		[self stopStreamThread];
+	}
+
+	// Buffers can't be deleted while they are still queued.
+	if(nil != source)
+	{
+		[self unqueueAllBuffers];
+	}
+	as_release(source);
+	as_release(queuedBuffers);
+	as_release(freeBuffers);
+	as_release(buffers);
+	as_release(file);
+	as_release(streamCondition);
+	as_release(streamLock);
+	free(bufferStartFrames);
+	free(bufferFrameCounts);
+
+	as_superdealloc();
+}
+
+- (NSString*) description
+{
+	return [NSString stringWithFormat:@"<%@: %p: %@>", [self class], self, file.url];
+}
+
+
+#pragma mark Properties
+
+@synthesize file;
+
+@synthesize source;
+
+@synthesize framesPerBuffer;
+
+- (NSURL*) url
+{
+	return file.url;
+}
+
+- (NSUInteger) numBuffers
+{
+	return [buffers count];
+}
+
+- (SInt64) totalFrames
+{
+	return file.totalFrames;
+}
+
+- (NSTimeInterval) duration
+{
+	return (NSTimeInterval)file.totalFrames / file.streamDescription->mSampleRate;
+}
+
+- (SInt64) currentFrame
+{
+	@synchronized(streamLock)
+	{
+		if(!playing)
+		{
+			return nextFrame;
+		}
+
+		// The sample offset is relative to the start of the oldest buffer still in the queue.
+		SInt64 offset = [ALWrapper getSourcei:source.sourceId parameter:AL_SAMPLE_OFFSET];
+		for(ALBuffer* buffer in queuedBuffers)
+		{
+			NSUInteger index = [buffers indexOfObjectIdenticalTo:buffer];
+			if(offset < bufferFrameCounts[index])
+			{
+				SInt64 frame = bufferStartFrames[index] + offset;
+				SInt64 total = file.totalFrames;
+				// A looping chunk can run past the end of the file and wrap around.
+				return total > 0 ? frame % total : frame;
+			}
+			offset -= bufferFrameCounts[index];
+		}
+		return nextFrame;
+	}
+}
+
+- (bool) looping
+{
+	return looping;
+}
+
+- (void) setLooping:(bool) value
+{
+	@synchronized(streamLock)
+	{
+		looping = value;
+		if(looping && endOfStream && playing)
+		{
+			// The end of the file has already been queued. Carry on from the start.
+			if([file seekToFrame:0])
+			{
+				nextFrame = 0;
+				endOfStream = NO;
+			}
+		}
+	}
+}
+
+- (bool) playing
+{
+	return playing;
+}
+
+- (bool) paused
+{
+	return paused;
+}
+
+- (void) setPaused:(bool) value
+{
+	@synchronized(streamLock)
+	{
+		if(!playing)
+		{
+			return;
+		}
+		paused = value;
+		source.paused = value;
+	}
+}
+
+
+#pragma mark Playback
+
+- (bool) play
+{
+	@synchronized(streamLock)
+	{
+		if(playing)
+		{
+			[self stop];
+		}
+
+		endOfStream = NO;
+		if(![file seekToFrame:nextFrame])
+		{
+			return NO;
+		}
+		[self fillFreeBuffers];
+		if([queuedBuffers count] == 0)
+		{
+			OAL_LOG_WARNING(@"%@: Nothing to play", self);
+			return NO;
+		}
+
+		// Looping is handled by the decoder. Looping the queue would replay stale buffers.
+		[ALWrapper sourcei:source.sourceId parameter:AL_LOOPING value:AL_FALSE];
+		if(nil == [source play])
+		{
+			[self unqueueAllBuffers];
+			return NO;
+		}
+
+		playing = YES;
+		paused = NO;
+		[self startStreamThread];
+		return YES;
+	}
+}
+
+- (void) stop
+{
+	@synchronized(streamLock)
+	{
+		[self stopStreamThread];
+		[source stop];
+		[self unqueueAllBuffers];
+		playing = NO;
+		paused = NO;
+		endOfStream = NO;
+		nextFrame = 0;
+	}
+}
+
+- (bool) seekToFrame:(SInt64) frame
+{
+	@synchronized(streamLock)
+	{
+		if(frame < 0 || frame > file.totalFrames)
+		{
+			OAL_LOG_ERROR(@"%@: Cannot seek to frame %lld (total frames = %lld)", self, frame, file.totalFrames);
+			return NO;
+		}
+
+		if(!playing)
+		{
+			// Takes effect on the next call to play.
+			nextFrame = frame;
+			return YES;
+		}
+
+		[self unqueueAllBuffers];
+		if(![file seekToFrame:frame])
+		{
+			[self stop];
+			return NO;
+		}
+		nextFrame = frame;
+		endOfStream = NO;
+		[self fillFreeBuffers];
+
+		[ALWrapper sourcePlay:source.sourceId];
+		if(paused)
+		{
+			// Go back into the paused state at the new position.
+			[ALWrapper sourcePause:source.sourceId];
+		}
+		return YES;
+	}
+}
+
+- (bool) seekToTime:(NSTimeInterval) time
+{
+	return [self seekToFrame:(SInt64)(time * file.streamDescription->mSampleRate)];
+}
+
+
+#pragma mark Streaming
+
+- (void) startStreamThread
+{
+	streamWorker = [[OALStreamWorker alloc] initWithStream:self
+													  lock:streamLock
+												 condition:streamCondition
+											  pollInterval:pollInterval];
+	streamThread = [[NSThread alloc] initWithTarget:streamWorker selector:@selector(run) object:nil];
+	[streamThread start];
+}
+
+- (void) stopStreamThread
+{
+	[streamWorker detach];
+	as_release(streamWorker);
+	streamWorker = nil;
+
+	[streamThread cancel];
+	[streamCondition lock];
+	[streamCondition signal];
+	[streamCondition unlock];
+	as_release(streamThread);
+	streamThread = nil;
+}
+
+- (void) service
+{
+	@synchronized(streamLock)
+	{
+		if(!playing || source.suspended)
+		{
+			return;
+		}
+
+		// Recycle the buffers that have finished playing.
+		for(int processed = source.buffersProcessed; processed > 0 && [queuedBuffers count] > 0; processed--)
+		{
+			ALBuffer* buffer = [queuedBuffers objectAtIndex:0];
+			if(![source unqueueBuffer:buffer])
+			{
+				break;
+			}
+			[freeBuffers addObject:buffer];
+			[queuedBuffers removeObjectAtIndex:0];
+		}
+
+		[self fillFreeBuffers];
+
+		if([queuedBuffers count] == 0)
+		{
+			// Everything has been played.
+			OAL_LOG_DEBUG(@"%@: End of stream", self);
+			playing = NO;
+			paused = NO;
+			nextFrame = 0;
+			[self stopStreamThread];
+			return;
+		}
+
+		if(!paused && AL_STOPPED == [ALWrapper getSourcei:source.sourceId parameter:AL_SOURCE_STATE])
+		{
+			// The queue ran dry before we could refill it.
+			OAL_LOG_DEBUG(@"%@: Buffer underrun. Resuming playback", self);
+			[ALWrapper sourcePlay:source.sourceId];
+		}
+	}
+}
+
+- (void) fillFreeBuffers
+{
+	while(!endOfStream && [freeBuffers count] > 0)
+	{
+		ALBuffer* buffer = [freeBuffers objectAtIndex:0];
+		if(![self fillBuffer:buffer])
+		{
+			break;
+		}
+		if(![source queueBuffer:buffer])
+		{
+			OAL_LOG_ERROR(@"%@: Could not queue stream buffer %@", self, buffer);
+			break;
+		}
+		[queuedBuffers addObject:buffer];
+		[freeBuffers removeObjectAtIndex:0];
+	}
+}
+
+- (void) unqueueAllBuffers
+{
+	// Stopping the source marks every queued buffer as processed, so they can all be unqueued.
+	[ALWrapper sourceStop:source.sourceId];
+	for(ALBuffer* buffer in queuedBuffers)
+	{
+		if(![source unqueueBuffer:buffer])
+		{
+			// Detaching the source's buffer clears the whole queue of a stopped source.
+			OAL_LOG_WARNING(@"%@: Could not unqueue stream buffer %@. Clearing the queue", self, buffer);
+			[ALWrapper sourcei:source.sourceId parameter:AL_BUFFER value:AL_NONE];
+			break;
+		}
+	}
+	[freeBuffers addObjectsFromArray:queuedBuffers];
+	[queuedBuffers removeAllObjects];
+}
+
+- (bool) fillBuffer:(ALBuffer*) buffer
+{
+	NSUInteger index = [buffers indexOfObjectIdenticalTo:buffer];
+	AudioStreamBasicDescription* desc = file.streamDescription;
+	char* data = (char*)buffer.data;
+	UInt32 framesFilled = 0;
+	bool rewound = NO;
+
+	bufferStartFrames[index] = nextFrame;
+	while(framesFilled < framesPerBuffer)
+	{
+		UInt32 framesRead = [file readFrames:framesPerBuffer - framesFilled
+								  intoBuffer:data + framesFilled * desc->mBytesPerFrame];
+		framesFilled += framesRead;
+		nextFrame += framesRead;
+		if(framesRead > 0)
+		{
+			rewound = NO;
+			continue;
+		}
+
+		// End of file. Rewinding twice in a row means the file is empty.
+		if(!looping || rewound || ![file seekToFrame:0])
+		{
+			endOfStream = YES;
+			break;
+		}
+		rewound = YES;
+		nextFrame = 0;
+	}
+
+	bufferFrameCounts[index] = framesFilled;
+	if(0 == framesFilled)
+	{
+		return NO;
+	}
+	return [buffer replaceData:data
+						  size:(ALsizei)(framesFilled * desc->mBytesPerFrame)
+						format:file.format
+					 frequency:(ALsizei)desc->mSampleRate];
+}
+
+@end
@@ -30,6 +30,7 @@
 #import <Foundation/Foundation.h>
 #import "SynthesizeSingleton.h"
 #import "ALContext.h"
+#import "OALAudioFile.h"
 #ifdef __IPHONE_OS_VERSION_MAX_ALLOWED
 #import <OpenAL/oalMacOSX_OALExtensions.h>
 #else
@@ -37,6 +38,72 @@
 #endif
 
 
+/** The order in which queued asynchronous buffer loads are started. */
+typedef enum
+{
+	/** Sounds that may be needed later, such as the next level's effects. */
+	kOALBufferLoadPriorityLow,
+	/** The default. */
+	kOALBufferLoadPriorityNormal,
+	/** Sounds that are needed right now. */
+	kOALBufferLoadPriorityHigh,
+} OALBufferLoadPriority;
+
+/** How asynchronous loads report that they have finished. */
+typedef enum
+{
+	/** Completions run on the main thread's run loop (the default). */
+	kOALCompletionModeMainThread,
+	/** Completions wait in a preallocated queue until drainCompletions is called. */
+	kOALCompletionModeDrain,
+} OALCompletionMode;
+
+struct oal_completion_ring;
+
+
+#pragma mark OALBufferLoadRequest
+
+/**
+ * A pending asynchronous buffer load, as returned by
+ * [OpenALManager loadBufferAsyncFromUrl:reduceToMono:priority:target:selector:]. <br>
+ *
+ * Requests for the same URL share a single decode, and each request's target is
+ * called with the same buffer.
+ */
+@interface OALBufferLoadRequest : NSObject
+{
+	NSURL* url;
+	bool reduceToMono;
+	OALBufferLoadPriority priority;
+	/** The target to inform when the load completes (WEAK reference). */
+	id target;
+	/** The selector to call when the load completes. */
+	SEL selector;
+	bool cancelled;
+}
+
+/** The URL being loaded. */
+@property(nonatomic,readonly,retain) NSURL* url;
+
+/** If YES, the audio is being reduced to mono. */
+@property(nonatomic,readonly,assign) bool reduceToMono;
+
+/** The priority this request was made with. */
+@property(nonatomic,readonly,assign) OALBufferLoadPriority priority;
+
+/** If YES, this request was cancelled, and its target will not be called. */
+@property(nonatomic,readonly,assign) bool cancelled;
+
+/** Cancel this request. Its target will not be called. If no other request is waiting
+ * for the same file and decoding hasn't started yet, the file is not decoded at all. <br>
+ *
+ * Call this on the main thread to be sure the target isn't called afterwards.
+ */
+- (void) cancel;
+
+@end
+
+
 #pragma mark OpenALManager
 
 /**
@@ -60,6 +127,15 @@
 
 	/** Operation queue for asynchronous loading. */
 	NSOperationQueue* operationQueue;
+	/** Asynchronous loads that have not finished, keyed by URL and mono setting. */
+	NSMutableDictionary* pendingLoads;
+
+	bool resampleOnLoad;
+	OALResampleQuality resampleQuality;
+
+	OALCompletionMode completionMode;
+	/** Completions waiting for drainCompletions. */
+	struct oal_completion_ring* completions;
 }
 
 
@@ -97,6 +173,33 @@
  */
 @property(nonatomic,readwrite,assign) ALint renderingQuality;
 
+/** If YES, audio loaded into buffers is converted to the mixer's sample rate
+ * (mixerOutputFrequency, or the current context's ALC_FREQUENCY if the mixer rate
+ * is unavailable). This moves the conversion from every playback of every source
+ * to a one-time cost when loading (default NO).
+ */
+@property(nonatomic,readwrite,assign) bool resampleOnLoad;
+
+/** The quality of the sample rate conversion done by resampleOnLoad
+ * (default kOALResampleQualityHigh).
+ */
+@property(nonatomic,readwrite,assign) OALResampleQuality resampleQuality;
+
+/** The maximum number of files decoded at the same time by the asynchronous
+ * loading methods (default: the number of active CPU cores). Other loads wait
+ * their turn, with higher priority loads started first.
+ */
+@property(nonatomic,readwrite,assign) NSUInteger maxAsyncLoads;
+
+/** How asynchronous loads, including OALSimpleAudio's preloading, report that they
+ * have finished (default kOALCompletionModeMainThread). <br>
+ *
+ * With kOALCompletionModeDrain, nothing is called until your code calls
+ * drainCompletions, so a game loop can handle finished loads at a known point
+ * in its frame without waiting on the main run loop.
+ */
+@property(nonatomic,readwrite,assign) OALCompletionMode completionMode;
+
 
 #pragma mark Object Management
 
@@ -144,6 +247,7 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OpenALManager);
 
 /** Load an OpenAL buffer with the contents of an audio file.
  * The buffer's name will be the fully qualified URL.
+ * If OALDecodedAudioCache is enabled, previously decoded data is loaded from the cache.
  *
  * See the class description note regarding sound file formats.
  *
@@ -154,6 +258,20 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OpenALManager);
  */
 - (ALBuffer*) bufferFromUrl:(NSURL*) url reduceToMono:(bool) reduceToMono;
 
+/** Decode the contents of an audio file without creating a buffer, converting it to the
+ * rate buffers are loaded at (see resampleOnLoad).
+ * If OALDecodedAudioCache is enabled, previously decoded data is loaded from the cache. <br>
+ *
+ * This can be called from any thread, which allows decoding to be spread across several
+ * threads while buffers are created on one (see OALAudioData).
+ *
+ * @param url The URL of the file containing the audio data.
+ * @param reduceToMono If true, reduce the sample to mono
+ *        (stereo samples don't support panning or positional audio).
+ * @return The decoded audio data, or nil on error.
+ */
+- (OALAudioData*) audioDataFromUrl:(NSURL*) url reduceToMono:(bool) reduceToMono;
+
 /** Load an OpenAL buffer with the contents of an audio file asynchronously.
  * This method will schedule a request to have the buffer created and filled, and then call the
  * specified selector with the newly created buffer. <br>
@@ -228,6 +346,55 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OpenALManager);
 						  target:(id) target
 						selector:(SEL) selector;
 
+/** Load an OpenAL buffer with the contents of a URL asynchronously, with a priority. <br>
+ *
+ * At most maxAsyncLoads files are decoded at once, and queued loads are started
+ * in order of priority. If the same URL (with the same reduceToMono setting) is
+ * already queued or being decoded, this request shares that decode rather than
+ * starting another one, and raises its priority if this one is higher. <br>
+ *
+ * The selector is called on the main thread with the newly created buffer
+ * (or nil on error). The buffer's name will be the fully qualified URL.
+ *
+ * @param url The URL of the file containing the audio data.
+ * @param reduceToMono If true, reduce the sample to mono
+ *        (stereo samples don't support panning or positional audio).
+ * @param priority The priority of the load.
+ * @param target The target to call when the buffer is loaded.
+ * @param selector The selector to invoke when the buffer is loaded.
+ * @return A request that can be used to cancel the load.
+ */
+- (OALBufferLoadRequest*) loadBufferAsyncFromUrl:(NSURL*) url
+									reduceToMono:(bool) reduceToMono
+										priority:(OALBufferLoadPriority) priority
+										  target:(id) target
+										selector:(SEL) selector;
+
+
+#pragma mark Completions
+
+/** Call all completions that are waiting because completionMode is kOALCompletionModeDrain,
+ * in the order the loads finished. <br>
+ *
+ * Call this from one thread only (usually once per frame from your game loop).
+ * Completions queued after switching back to kOALCompletionModeMainThread still
+ * need one more drain.
+ *
+ * @return The number of completions called.
+ */
+- (NSUInteger) drainCompletions;
+
+#if NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS
+
+/** Run a block the way asynchronous load completions are run: on the main thread,
+ * or from drainCompletions, depending on completionMode. Safe to call from any thread.
+ *
+ * @param block The block to run.
+ */
+- (void) performCompletion:(void (^)(void)) block;
+
+#endif
+
 
 #pragma mark Utility
 
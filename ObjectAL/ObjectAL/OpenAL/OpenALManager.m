@@ -35,12 +35,52 @@
 #import "ALDevice.h"
 #import "OALAudioSession.h"
 #import "OALAudioFile.h"
+#import "OALDecodedAudioCache.h"
+#import "OALLoadTelemetry.h"
+#import "oal_completion_ring.h"
+
+
+/** The number of completions that can wait for drainCompletions. Any more are
+ * sent to the main thread instead.
+ */
+#define kCompletionRingCapacity 256
 
 
 #pragma mark -
 #pragma mark Asynchronous Operations
 
 /** \cond */
+/**
+ * (INTERNAL USE) Private methods for OALBufferLoadRequest.
+ */
+@interface OALBufferLoadRequest ()
+
+/** (INTERNAL USE) Set when the request is cancelled. */
+@property(nonatomic,readwrite,assign) bool cancelled;
+
+/** (INTERNAL USE) Initialize a request.
+ *
+ * @param url the URL containing the sound file.
+ * @param reduceToMono If true, reduce the sample to mono.
+ * @param priority The priority of the load.
+ * @param target the target to inform when the load completes.
+ * @param selector the selector to call when the load completes.
+ */
+- (id) initWithUrl:(NSURL*) url
+	  reduceToMono:(bool) reduceToMono
+		  priority:(OALBufferLoadPriority) priority
+			target:(id) target
+		  selector:(SEL) selector;
+
+/** (INTERNAL USE) Call the target with the loaded buffer, unless cancelled.
+ * Must be called on the main thread.
+ *
+ * @param buffer The loaded buffer.
+ */
+- (void) deliverBuffer:(ALBuffer*) buffer;
+
+@end
+
 /**
  * (INTERNAL USE) NSOperation for loading audio files asynchronously.
  */
@@ -50,55 +90,83 @@
 	NSURL* url;
 	/** If true, reduce the sample to mono */
 	bool reduceToMono;
-	/** The target to inform when the operation completes */
-	id target;
-	/** The selector to call when the operation completes */
-	SEL selector;
+	/** The requests waiting for this load (OALBufferLoadRequest) */
+	NSMutableArray* requests;
 }
 
+/** (INTERNAL USE) The requests waiting for this load. Only access while synchronized on pendingLoads. */
+@property(nonatomic,readonly,retain) NSMutableArray* requests;
+
 /** (INTERNAL USE) Create a new Asynchronous Operation.
  *
  * @param url the URL containing the sound file.
  * @param reduceToMono If true, reduce the sample to mono
  *        (stereo samples don't support panning or positional audio).
- * @param target the target to inform when the operation completes.
- * @param selector the selector to call when the operation completes.
  */ 
 + (id) operationWithUrl:(NSURL*) url
-		   reduceToMono:(bool) reduceToMono
-				 target:(id) target
-			   selector:(SEL) selector;
+		   reduceToMono:(bool) reduceToMono;
 
 /** (INTERNAL USE) Initialize an Asynchronous Operation.
  *
  * @param url the URL containing the sound file.
  * @param reduceToMono If true, reduce the sample to mono
  *        (stereo samples don't support panning or positional audio).
- * @param target the target to inform when the operation completes.
- * @param selector the selector to call when the operation completes.
  */ 
 - (id) initWithUrl:(NSURL*) url
-	  reduceToMono:(bool) reduceToMono
-			target:(id) target
-		  selector:(SEL) selector;
+	  reduceToMono:(bool) reduceToMono;
 
 @end
+/** \endcond */
 
-@implementation OAL_AsyncALBufferLoadOperation
 
-+ (id) operationWithUrl:(NSURL*) url
-		   reduceToMono:(bool) reduceToMono
-				 target:(id) target
-			   selector:(SEL) selector
-{
-	return as_autorelease([[self alloc] initWithUrl:url
-                                            reduceToMono:reduceToMono
-                                                  target:target
-                                                selector:selector]);
-}
+#pragma mark -
+#pragma mark Private Methods
+
+SYNTHESIZE_SINGLETON_FOR_CLASS_PROTOTYPE(OpenALManager);
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for OpenALManager.
+ */
+@interface OpenALManager ()
+
+/** (INTERNAL USE) Called by SuspendHandler.
+ */
+- (void) setSuspended:(bool) value;
+
+/** (INTERNAL USE) Real reference to the current context.
+ */
+@property(nonatomic,readwrite,assign) ALContext* realCurrentContext;
+
+/** (INTERNAL USE) The sample rate to convert loaded audio to, or 0 to leave it as is.
+ */
+- (ALsizei) loadFrequency;
+
+/** (INTERNAL USE) The key identifying loads of the same file in pendingLoads.
+ */
+- (NSString*) keyForAsyncLoadOfUrl:(NSURL*) url reduceToMono:(bool) reduceToMono;
+
+/** (INTERNAL USE) Called by OALBufferLoadRequest to cancel itself.
+ */
+- (void) cancelBufferLoad:(OALBufferLoadRequest*) request;
+
+/** (INTERNAL USE) Called by an operation when it has finished decoding,
+ * to hand the buffer to its requests.
+ */
+- (void) finishAsyncLoad:(OAL_AsyncALBufferLoadOperation*) operation buffer:(ALBuffer*) buffer;
+
+@end
+/** \endcond */
+
+
+#pragma mark -
+#pragma mark OALBufferLoadRequest
+
+@implementation OALBufferLoadRequest
 
 - (id) initWithUrl:(NSURL*) urlIn
 	  reduceToMono:(bool) reduceToMonoIn
+		  priority:(OALBufferLoadPriority) priorityIn
 			target:(id) targetIn
 		  selector:(SEL) selectorIn
 {
@@ -106,6 +174,7 @@
 	{
 		url = as_retain(urlIn);
 		reduceToMono = reduceToMonoIn;
+		priority = priorityIn;
 		target = targetIn;
 		selector = selectorIn;
 	}
@@ -118,32 +187,74 @@
 	as_superdealloc();
 }
 
-- (void)main
+- (NSString*) description
 {
-	ALBuffer* buffer = [OALAudioFile bufferFromUrl:url reduceToMono:reduceToMono];
-	[target performSelectorOnMainThread:selector withObject:buffer waitUntilDone:NO];
+	return [NSString stringWithFormat:@"<%@: %p: %@>", [self class], self, [url lastPathComponent]];
+}
+
+@synthesize url;
+@synthesize reduceToMono;
+@synthesize priority;
+@synthesize cancelled;
+
+- (void) cancel
+{
+	[[OpenALManager sharedInstance] cancelBufferLoad:self];
+}
+
+- (void) deliverBuffer:(ALBuffer*) buffer
+{
+	if(!cancelled)
+	{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Warc-performSelector-leaks"
+		[target performSelector:selector withObject:buffer];
+#pragma clang diagnostic pop
+	}
 }
 
 @end
 
 
-#pragma mark -
-#pragma mark Private Methods
+/** \cond */
+@implementation OAL_AsyncALBufferLoadOperation
 
-SYNTHESIZE_SINGLETON_FOR_CLASS_PROTOTYPE(OpenALManager);
++ (id) operationWithUrl:(NSURL*) url
+		   reduceToMono:(bool) reduceToMono
+{
+	return as_autorelease([[self alloc] initWithUrl:url reduceToMono:reduceToMono]);
+}
 
-/**
- * (INTERNAL USE) Private methods for OpenALManager.
- */
-@interface OpenALManager ()
+- (id) initWithUrl:(NSURL*) urlIn
+	  reduceToMono:(bool) reduceToMonoIn
+{
+	if(nil != (self = [super init]))
+	{
+		url = as_retain(urlIn);
+		reduceToMono = reduceToMonoIn;
+		requests = [[NSMutableArray alloc] initWithCapacity:1];
+	}
+	return self;
+}
 
-/** (INTERNAL USE) Called by SuspendHandler.
- */
-- (void) setSuspended:(bool) value;
+- (void) dealloc
+{
+	as_release(url);
+	as_release(requests);
+	as_superdealloc();
+}
 
-/** (INTERNAL USE) Real reference to the current context.
- */
-@property(nonatomic,readwrite,assign) ALContext* realCurrentContext;
+@synthesize requests;
+
+- (void)main
+{
+	if(self.isCancelled)
+	{
+		return;
+	}
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	[manager finishAsyncLoad:self buffer:[manager bufferFromUrl:url reduceToMono:reduceToMono]];
+}
 
 @end
 /** \endcond */
@@ -173,6 +284,15 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OpenALManager);
 		devices = [NSMutableArray newMutableArrayUsingWeakReferencesWithCapacity:5];
 
 		operationQueue = [[NSOperationQueue alloc] init];
+		operationQueue.maxConcurrentOperationCount = (NSInteger)[[NSProcessInfo processInfo] activeProcessorCount];
+		pendingLoads = [[NSMutableDictionary alloc] initWithCapacity:16];
+		completions = oal_completion_ring_create(kCompletionRingCapacity);
+		if(NULL == completions)
+		{
+			OAL_LOG_ERROR(@"%@: Could not allocate completion queue", self);
+		}
+
+		resampleQuality = kOALResampleQualityHigh;
 
 		[[OALAudioSession sharedInstance] addSuspendListener:self];
 	}
@@ -185,6 +305,8 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OpenALManager);
 	[[OALAudioSession sharedInstance] removeSuspendListener:self];
 
 	as_release(operationQueue);
+	as_release(pendingLoads);
+	oal_completion_ring_destroy(completions);
 	as_release(suspendHandler);
 	as_release(devices);
 	as_superdealloc();
@@ -261,6 +383,43 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OpenALManager);
 	}
 }
 
+@synthesize resampleOnLoad;
+
+@synthesize resampleQuality;
+
+- (NSUInteger) maxAsyncLoads
+{
+	return (NSUInteger)operationQueue.maxConcurrentOperationCount;
+}
+
+- (void) setMaxAsyncLoads:(NSUInteger) value
+{
+	operationQueue.maxConcurrentOperationCount = value > 0 ? (NSInteger)value : 1;
+}
+
+@synthesize completionMode;
+
+- (ALsizei) loadFrequency
+{
+	if(!resampleOnLoad)
+	{
+		return 0;
+	}
+
+	ALdouble mixerFrequency = self.mixerOutputFrequency;
+	if(mixerFrequency > 0)
+	{
+		return (ALsizei)mixerFrequency;
+	}
+
+	ALContext* context = self.currentContext;
+	if(nil != context)
+	{
+		return [ALWrapper getInteger:context.device.device attribute:ALC_FREQUENCY];
+	}
+	return 0;
+}
+
 - (ALint) renderingQuality
 {
 	OPTIONALLY_SYNCHRONIZED(self)
@@ -356,7 +515,41 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OpenALManager);
 {
 	OAL_LOG_DEBUG(@"Load buffer from %@", url);
 
-	return [OALAudioFile bufferFromUrl:url reduceToMono:reduceToMono];
+	OALLoadTelemetry* telemetry = [OALLoadTelemetry sharedInstance];
+	OALLoadRecord* record = [telemetry beginRecordForUrl:url];
+	ALBuffer* buffer;
+	ALsizei frequency = [self loadFrequency];
+	OALDecodedAudioCache* cache = [OALDecodedAudioCache sharedInstance];
+	if(cache.enabled)
+	{
+		buffer = [cache bufferFromUrl:url
+						 reduceToMono:reduceToMono
+					  outputFrequency:frequency
+							  quality:resampleQuality];
+	}
+	else
+	{
+		buffer = [OALAudioFile bufferFromUrl:url
+								reduceToMono:reduceToMono
+							 outputFrequency:frequency
+									 quality:resampleQuality];
+	}
+	[telemetry endRecord:record];
+	return buffer;
+}
+
+- (OALAudioData*) audioDataFromUrl:(NSURL*) url reduceToMono:(bool) reduceToMono
+{
+	OAL_LOG_DEBUG(@"Decode audio data from %@", url);
+
+	OALLoadTelemetry* telemetry = [OALLoadTelemetry sharedInstance];
+	OALLoadRecord* record = [telemetry beginRecordForUrl:url];
+	OALAudioData* audioData = [[OALDecodedAudioCache sharedInstance] audioDataFromUrl:url
+																		 reduceToMono:reduceToMono
+																	  outputFrequency:[self loadFrequency]
+																			  quality:resampleQuality];
+	[telemetry endRecord:record];
+	return audioData;
 }
 
 - (NSString*) bufferAsyncFromFile:(NSString*) filePath
@@ -395,17 +588,187 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OpenALManager);
 						  target:(id) target
 						selector:(SEL) selector
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	[self loadBufferAsyncFromUrl:url
+					reduceToMono:reduceToMono
+						priority:kOALBufferLoadPriorityNormal
+						  target:target
+						selector:selector];
+	return [url absoluteString];
+}
+
+/** Convert a load priority to an operation queue priority. */
+static NSOperationQueuePriority queuePriority(OALBufferLoadPriority priority)
+{
+	switch(priority)
 	{
-		[operationQueue addOperation:
-		 [OAL_AsyncALBufferLoadOperation operationWithUrl:url
-											 reduceToMono:reduceToMono
-												   target:target
-												 selector:selector]];
+		case kOALBufferLoadPriorityLow:
+			return NSOperationQueuePriorityLow;
+		case kOALBufferLoadPriorityHigh:
+			return NSOperationQueuePriorityVeryHigh;
+		default:
+			return NSOperationQueuePriorityNormal;
 	}
-	return [url absoluteString];
 }
 
+- (OALBufferLoadRequest*) loadBufferAsyncFromUrl:(NSURL*) url
+									reduceToMono:(bool) reduceToMono
+										priority:(OALBufferLoadPriority) priority
+										  target:(id) target
+										selector:(SEL) selector
+{
+	OALBufferLoadRequest* request = as_autorelease([[OALBufferLoadRequest alloc] initWithUrl:url
+																				reduceToMono:reduceToMono
+																					priority:priority
+																					  target:target
+																					selector:selector]);
+	NSString* key = [self keyForAsyncLoadOfUrl:url reduceToMono:reduceToMono];
+
+	// Must always be synchronized
+	@synchronized(pendingLoads)
+	{
+		OAL_AsyncALBufferLoadOperation* operation = [pendingLoads objectForKey:key];
+		if(nil != operation)
+		{
+			OAL_LOG_DEBUG(@"%@: Joining pending load of %@", self, url);
+			// Raising the priority only matters if it hasn't started yet.
+			if(queuePriority(priority) > operation.queuePriority)
+			{
+				operation.queuePriority = queuePriority(priority);
+			}
+			[operation.requests addObject:request];
+			return request;
+		}
+
+		operation = [OAL_AsyncALBufferLoadOperation operationWithUrl:url reduceToMono:reduceToMono];
+		operation.queuePriority = queuePriority(priority);
+		[operation.requests addObject:request];
+		[pendingLoads setObject:operation forKey:key];
+		[operationQueue addOperation:operation];
+	}
+	return request;
+}
+
+- (NSString*) keyForAsyncLoadOfUrl:(NSURL*) url reduceToMono:(bool) reduceToMono
+{
+	return [NSString stringWithFormat:@"%@%@", [url absoluteString], reduceToMono ? @"#mono" : @""];
+}
+
+- (void) cancelBufferLoad:(OALBufferLoadRequest*) request
+{
+	NSString* key = [self keyForAsyncLoadOfUrl:request.url reduceToMono:request.reduceToMono];
+
+	// Must always be synchronized
+	@synchronized(pendingLoads)
+	{
+		request.cancelled = YES;
+		OAL_AsyncALBufferLoadOperation* operation = [pendingLoads objectForKey:key];
+		if(nil == operation)
+		{
+			return;
+		}
+		[operation.requests removeObjectIdenticalTo:request];
+		if(0 == [operation.requests count] && !operation.isExecuting)
+		{
+			OAL_LOG_DEBUG(@"%@: Cancelled load of %@ before it started", self, request.url);
+			[operation cancel];
+			[pendingLoads removeObjectForKey:key];
+		}
+	}
+}
+
+/** Give up a reference to an object that was passed to the completion queue. */
+static void releaseCompletionObject(void* object)
+{
+	id released = as_autorelease((as_bridge_transfer id) object);
+	#pragma unused(released)
+}
+
+/** Completion that hands a loaded buffer to its request. */
+static void deliverBufferCompletion(void* context, void* argument)
+{
+	OALBufferLoadRequest* request = as_autorelease((as_bridge_transfer OALBufferLoadRequest*) context);
+	ALBuffer* buffer = as_autorelease((as_bridge_transfer ALBuffer*) argument);
+	[request deliverBuffer:buffer];
+}
+
+- (void) finishAsyncLoad:(OAL_AsyncALBufferLoadOperation*) operation buffer:(ALBuffer*) buffer
+{
+	NSArray* requests;
+
+	// Must always be synchronized
+	@synchronized(pendingLoads)
+	{
+		requests = [NSArray arrayWithArray:operation.requests];
+		[operation.requests removeAllObjects];
+		for(NSString* key in [pendingLoads allKeysForObject:operation])
+		{
+			[pendingLoads removeObjectForKey:key];
+		}
+	}
+
+	bool drain = kOALCompletionModeDrain == completionMode && NULL != completions;
+	for(OALBufferLoadRequest* request in requests)
+	{
+		if(drain)
+		{
+			void* context = (as_bridge_retained void*) as_retain(request);
+			void* argument = nil == buffer ? NULL : (as_bridge_retained void*) as_retain(buffer);
+			if(oal_completion_ring_push(completions, deliverBufferCompletion, context, argument))
+			{
+				continue;
+			}
+			releaseCompletionObject(context);
+			releaseCompletionObject(argument);
+			OAL_LOG_WARNING(@"%@: Completion queue is full. Delivering %@ on the main thread", self, request.url);
+		}
+		[request performSelectorOnMainThread:@selector(deliverBuffer:) withObject:buffer waitUntilDone:NO];
+	}
+}
+
+
+#pragma mark Completions
+
+- (NSUInteger) drainCompletions
+{
+	if(NULL == completions)
+	{
+		return 0;
+	}
+
+	NSUInteger count;
+	as_autoreleasepool_start(pool);
+	count = oal_completion_ring_drain(completions, 0);
+	as_autoreleasepool_end(pool);
+	return count;
+}
+
+#if NS_BLOCKS_AVAILABLE && OBJECTAL_CFG_USE_BLOCKS
+
+/** Completion that runs a block. */
+static void runBlockCompletion(void* context, void* argument)
+{
+	#pragma unused(argument)
+	void (^block)(void) = as_autorelease((as_bridge_transfer void (^)(void)) context);
+	block();
+}
+
+- (void) performCompletion:(void (^)(void)) block
+{
+	if(kOALCompletionModeDrain == completionMode && NULL != completions)
+	{
+		void* context = (as_bridge_retained void*) as_retain(as_autorelease([block copy]));
+		if(oal_completion_ring_push(completions, runBlockCompletion, context, NULL))
+		{
+			return;
+		}
+		releaseCompletionObject(context);
+		OAL_LOG_WARNING(@"%@: Completion queue is full. Running completion on the main thread", self);
+	}
+	dispatch_async(dispatch_get_main_queue(), block);
+}
+
+#endif
+
 
 #pragma mark Utility
 
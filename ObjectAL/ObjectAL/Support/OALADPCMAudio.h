@@ -0,0 +1,113 @@
+//
+//  OALADPCMAudio.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import <Foundation/Foundation.h>
+#import "ALBuffer.h"
+
+
+/**
+ * Audio data held in memory as IMA ADPCM, which takes a little over a quarter
+ * of the space of 16-bit PCM. <br>
+ *
+ * If the current context can play IMA ADPCM directly (AL_EXT_IMA4), the data can
+ * be handed to OpenAL as is. Otherwise it is decoded to a new PCM buffer whenever
+ * one is needed, so memory is only spent on the sounds actually playing.
+ */
+@interface OALADPCMAudio : NSObject
+{
+	NSString* name;
+	NSData* data;
+	ALint channels;
+	ALsizei frequency;
+	ALsizei frames;
+	ALint framesPerBlock;
+}
+
+
+#pragma mark Properties
+
+/** The name given to this audio upon creation. */
+@property(nonatomic,readwrite,retain) NSString* name;
+
+/** The encoded data. */
+@property(nonatomic,readonly,retain) NSData* data;
+
+/** The number of channels (1 or 2). */
+@property(nonatomic,readonly,assign) ALint channels;
+
+/** The sampling frequency in Hz. */
+@property(nonatomic,readonly,assign) ALsizei frequency;
+
+/** The number of frames of audio. */
+@property(nonatomic,readonly,assign) ALsizei frames;
+
+/** The number of frames in each encoded block. */
+@property(nonatomic,readonly,assign) ALint framesPerBlock;
+
+/** If YES, the current context can play this audio without decoding it first. */
+@property(nonatomic,readonly,assign) bool playsNatively;
+
+
+#pragma mark Object Management
+
+/** Encode the contents of a buffer as IMA ADPCM. The block size is chosen so that
+ * the current context can play the result directly, if it supports IMA ADPCM at all.
+ *
+ * @param buffer The buffer to encode. Must hold 16-bit mono or stereo data.
+ * @return New ADPCM audio, or nil if the buffer's format can't be encoded.
+ */
++ (OALADPCMAudio*) audioWithBuffer:(ALBuffer*) buffer;
+
+/** Initialize by encoding the contents of a buffer as IMA ADPCM.
+ *
+ * @param buffer The buffer to encode. Must hold 16-bit mono or stereo data.
+ * @return The initialized audio, or nil if the buffer's format can't be encoded.
+ */
+- (id) initWithBuffer:(ALBuffer*) buffer;
+
+
+#pragma mark Buffers
+
+/** Decode this audio into a new 16-bit PCM buffer.
+ *
+ * @param name The name to be given to the buffer.
+ * @return A new buffer, or nil on error.
+ */
+- (ALBuffer*) decodedBufferNamed:(NSString*) name;
+
+/** Create a new buffer that holds this audio without decoding it, if the current
+ * context supports it (see playsNatively).
+ *
+ * @param name The name to be given to the buffer.
+ * @return A new buffer, or nil if the context can't play IMA ADPCM.
+ */
+- (ALBuffer*) nativeBufferNamed:(NSString*) name;
+
+@end
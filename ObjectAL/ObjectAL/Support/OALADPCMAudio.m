@@ -0,0 +1,160 @@
+//
+//  OALADPCMAudio.m
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import "OALADPCMAudio.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+#import "oal_adpcm.h"
+
+
+/** The block size to use when the context doesn't constrain it.
+ * Large blocks have less header overhead (4.03 bits per sample).
+ */
+#define kPreferredFramesPerBlock 1017
+
+/** The only block size AL_EXT_IMA4 supports without AL_SOFT_block_alignment. */
+#define kIMA4FramesPerBlock 65
+
+
+@implementation OALADPCMAudio
+
+#pragma mark Object Management
+
++ (OALADPCMAudio*) audioWithBuffer:(ALBuffer*) buffer
+{
+	return as_autorelease([[self alloc] initWithBuffer:buffer]);
+}
+
+- (id) initWithBuffer:(ALBuffer*) buffer
+{
+	if(nil != (self = [super init]))
+	{
+		OAL_LOG_DEBUG(@"%@: Init with %@", self, buffer);
+		ALenum format = buffer.format;
+		if((AL_FORMAT_MONO16 != format && AL_FORMAT_STEREO16 != format) || NULL == buffer.data)
+		{
+			OAL_LOG_DEBUG(@"%@: Only 16-bit mono and stereo buffers can be encoded", self);
+			goto initFailed;
+		}
+
+		self.name = buffer.name;
+		channels = AL_FORMAT_MONO16 == format ? 1 : 2;
+		frequency = buffer.frequency;
+		frames = buffer.size / (channels * (ALsizei)sizeof(int16_t));
+
+		framesPerBlock = kPreferredFramesPerBlock;
+		if(![ALBuffer canPlayIMAWithFramesPerBlock:framesPerBlock] &&
+		   [ALBuffer canPlayIMAWithFramesPerBlock:kIMA4FramesPerBlock])
+		{
+			framesPerBlock = kIMA4FramesPerBlock;
+		}
+
+		size_t size = oal_adpcm_ima_encoded_size((uint32_t)channels, (uint32_t)frames, (uint32_t)framesPerBlock);
+		void* encoded = malloc(size);
+		if(NULL == encoded)
+		{
+			OAL_LOG_ERROR(@"%@: Could not allocate %lu bytes for encoded data", self, (unsigned long)size);
+			goto initFailed;
+		}
+		oal_adpcm_ima_encode(buffer.data, (uint32_t)channels, (uint32_t)frames, (uint32_t)framesPerBlock, encoded);
+		data = [[NSData alloc] initWithBytesNoCopy:encoded length:size freeWhenDone:YES];
+	}
+	return self;
+
+initFailed:
+	as_release(self);
+	return nil;
+}
+
+- (void) dealloc
+{
+	OAL_LOG_DEBUG(@"%@: Dealloc", self);
+	as_release(name);
+	as_release(data);
+	as_superdealloc();
+}
+
+- (NSString*) description
+{
+	NSString* nameStr = NSNotFound == [name rangeOfString:@"://"].location ? name : [name lastPathComponent];
+	return [NSString stringWithFormat:@"<%@: %p: %@>", [self class], self, nameStr];
+}
+
+
+#pragma mark Properties
+
+@synthesize name;
+@synthesize data;
+@synthesize channels;
+@synthesize frequency;
+@synthesize frames;
+@synthesize framesPerBlock;
+
+- (bool) playsNatively
+{
+	return [ALBuffer canPlayIMAWithFramesPerBlock:framesPerBlock];
+}
+
+
+#pragma mark Buffers
+
+- (ALBuffer*) decodedBufferNamed:(NSString*) bufferName
+{
+	ALsizei size = frames * channels * (ALsizei)sizeof(int16_t);
+	int16_t* decoded = malloc((size_t)size);
+	if(NULL == decoded)
+	{
+		OAL_LOG_ERROR(@"%@: Could not allocate %d bytes for decoded data", self, size);
+		return nil;
+	}
+	oal_adpcm_ima_decode([data bytes], (uint32_t)channels, (uint32_t)frames, (uint32_t)framesPerBlock, decoded);
+
+	return [ALBuffer bufferWithName:bufferName
+							   data:decoded
+							   size:size
+							 format:1 == channels ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16
+						  frequency:frequency];
+}
+
+- (ALBuffer*) nativeBufferNamed:(NSString*) bufferName
+{
+	if(!self.playsNatively)
+	{
+		return nil;
+	}
+	return [ALBuffer bufferWithName:bufferName
+							imaData:[data bytes]
+							   size:(ALsizei)[data length]
+						   channels:channels
+						  frequency:frequency
+					 framesPerBlock:framesPerBlock];
+}
+
+@end
@@ -0,0 +1,115 @@
+//
+//  OALAudioData.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import <Foundation/Foundation.h>
+#import "ALBuffer.h"
+
+
+/**
+ * Decoded audio data that has not been loaded into an OpenAL buffer yet. <br>
+ *
+ * Decoding doesn't touch OpenAL, so it can be done on any thread. Creating the
+ * buffer afterwards is quick, and can be left to the thread that owns the context.
+ */
+@interface OALAudioData : NSObject
+{
+	NSData* backingData;
+	NSUInteger offset;
+	ALsizei size;
+	ALenum format;
+	ALsizei frequency;
+}
+
+
+#pragma mark Properties
+
+/** The object that owns the audio data. */
+@property(nonatomic,readonly,retain) NSData* backingData;
+
+/** The offset in bytes where the audio data starts within backingData. */
+@property(nonatomic,readonly,assign) NSUInteger offset;
+
+/** The size of the audio data in bytes. */
+@property(nonatomic,readonly,assign) ALsizei size;
+
+/** The format of the audio data (see al.h, AL_FORMAT_XXX). */
+@property(nonatomic,readonly,assign) ALenum format;
+
+/** The sampling frequency in Hz. */
+@property(nonatomic,readonly,assign) ALsizei frequency;
+
+/** The audio data. */
+@property(nonatomic,readonly,assign) const void* bytes;
+
+
+#pragma mark Object Management
+
+/** Wrap audio data stored inside an NSData object.
+ *
+ * @param backingData The object containing the audio data.
+ * @param offset The offset in bytes where the audio data starts.
+ * @param size The size of the audio data in bytes.
+ * @param format The format of the data (see al.h, AL_FORMAT_XXX).
+ * @param frequency The sampling frequency in Hz.
+ * @return New audio data, or nil if backingData is too small.
+ */
++ (OALAudioData*) dataWithBackingData:(NSData*) backingData
+							   offset:(NSUInteger) offset
+								 size:(ALsizei) size
+							   format:(ALenum) format
+							frequency:(ALsizei) frequency;
+
+/** Initialize with audio data stored inside an NSData object.
+ *
+ * @param backingData The object containing the audio data.
+ * @param offset The offset in bytes where the audio data starts.
+ * @param size The size of the audio data in bytes.
+ * @param format The format of the data (see al.h, AL_FORMAT_XXX).
+ * @param frequency The sampling frequency in Hz.
+ * @return The initialized audio data, or nil if backingData is too small.
+ */
+- (id) initWithBackingData:(NSData*) backingData
+					offset:(NSUInteger) offset
+					  size:(ALsizei) size
+					format:(ALenum) format
+				 frequency:(ALsizei) frequency;
+
+
+#pragma mark Buffers
+
+/** Create an OpenAL buffer that plays this audio data. The data is not copied.
+ * Needs a current context.
+ *
+ * @param name The name to be given to the buffer.
+ * @return A new buffer, or nil on error.
+ */
+- (ALBuffer*) bufferNamed:(NSString*) name;
+
+@end
@@ -0,0 +1,109 @@
+//
+//  OALAudioData.m
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import "OALAudioData.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+
+
+@implementation OALAudioData
+
+#pragma mark Object Management
+
++ (OALAudioData*) dataWithBackingData:(NSData*) backingData
+							   offset:(NSUInteger) offset
+								 size:(ALsizei) size
+							   format:(ALenum) format
+							frequency:(ALsizei) frequency
+{
+	return as_autorelease([[self alloc] initWithBackingData:backingData
+													 offset:offset
+													   size:size
+													 format:format
+												  frequency:frequency]);
+}
+
+- (id) initWithBackingData:(NSData*) backingDataIn
+					offset:(NSUInteger) offsetIn
+					  size:(ALsizei) sizeIn
+					format:(ALenum) formatIn
+				 frequency:(ALsizei) frequencyIn
+{
+	if(nil != (self = [super init]))
+	{
+		if(nil == backingDataIn || sizeIn < 0 || offsetIn + (NSUInteger)sizeIn > [backingDataIn length])
+		{
+			OAL_LOG_ERROR(@"%@: Backing data is too small for offset %lu + size %d", self, (unsigned long)offsetIn, sizeIn);
+			as_release(self);
+			return nil;
+		}
+		backingData = as_retain(backingDataIn);
+		offset = offsetIn;
+		size = sizeIn;
+		format = formatIn;
+		frequency = frequencyIn;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	as_release(backingData);
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+@synthesize backingData;
+@synthesize offset;
+@synthesize size;
+@synthesize format;
+@synthesize frequency;
+
+- (const void*) bytes
+{
+	return (const char*)[backingData bytes] + offset;
+}
+
+
+#pragma mark Buffers
+
+- (ALBuffer*) bufferNamed:(NSString*) name
+{
+	return [ALBuffer bufferWithName:name
+						backingData:backingData
+							 offset:offset
+							   size:size
+							 format:format
+						  frequency:frequency];
+}
+
+@end
@@ -31,6 +31,17 @@
 #import <AudioToolbox/AudioToolbox.h>
 #import "ALBuffer.h"
 
+@class OALAudioData;
+struct oal_decoder;
+
+/** Sample rate conversion quality. Higher settings take longer but alias less. */
+typedef enum
+{
+	kOALResampleQualityLow,
+	kOALResampleQualityMedium,
+	kOALResampleQualityHigh,
+	kOALResampleQualityBest,
+} OALResampleQuality;
 
 /**
  * Maintains an open audio file and allows loading data from that file into
@@ -48,8 +59,24 @@
 	/** The OS specific file handle */
 	ExtAudioFileRef fileHandle;
 
+	/** The portable decoder, if it recognized the file (fileHandle is unused in that case) */
+	struct oal_decoder* decoder;
+
 	/** The actual number of channels in the audio data if not reducing to mono */
 	UInt32 originalChannelsPerFrame;
+
+	/** If YES, the file stores floating point samples. */
+	bool sourceIsFloat;
+
+	bool nativeFormats;
+
+	NSUInteger maxDecodeThreads;
+
+	ALsizei outputFrequency;
+	OALResampleQuality resampleQuality;
+
+	/** If YES, the decoder's seek table has been loaded or saved, so there's no need to save it. */
+	bool seekTableStored;
 }
 
 /** The URL of the audio file */
@@ -64,6 +91,58 @@
 /** If YES, reduce any stereo data to mono (stereo samples don't support panning or positional audio). */
 @property(nonatomic,readwrite,assign) bool reduceToMono;
 
+/** If YES, use float and multichannel buffer formats when the current context supports them
+ * (default YES). <br>
+ *
+ * Files that store 32-bit float samples are then read without converting them to 16-bit,
+ * and files with 4, 6, 7 or 8 channels keep all of their channels. Otherwise, the data is
+ * converted to 16-bit, and files with more than 2 channels are mixed down to stereo.
+ */
+@property(nonatomic,readwrite,assign) bool nativeFormats;
+
+/** The maximum number of threads to use when decoding large reads from this file.
+ * Each thread decodes its own range of frames, and the result is identical to
+ * decoding on one thread. Only some formats (such as WAV and FLAC) can be split up
+ * this way. Others are always decoded on the calling thread.
+ * 0 = one thread per CPU, 1 = don't decode in parallel (default 0).
+ */
+@property(nonatomic,readwrite,assign) NSUInteger maxDecodeThreads;
+
+/** The sample rate to convert audio data to when loading it with audioDataWithStartFrame:
+ * or bufferNamed: (default 0, meaning keep the file's own rate). <br>
+ *
+ * Setting this to the mixer's output rate means the conversion happens once at load time
+ * rather than every time the buffer is played. Data read with readFrames:intoBuffer: is
+ * never converted.
+ */
+@property(nonatomic,readwrite,assign) ALsizei outputFrequency;
+
+/** The quality of the sample rate conversion done for outputFrequency (default kOALResampleQualityHigh). */
+@property(nonatomic,readwrite,assign) OALResampleQuality resampleQuality;
+
+/** The OpenAL format (AL_FORMAT_XXX) of the audio data read from this file. */
+@property(nonatomic,readonly,assign) ALenum format;
+
+/** The directory where seek tables are saved (default nil, meaning they are not saved). <br>
+ *
+ * Seek tables are built on the first seek that needs one. When saved, the next time the
+ * file is opened seeking takes constant time right away. Saved tables are discarded if
+ * the audio file changes. <br>
+ *
+ * A seek table next to the audio file itself (named after the file with ".oalseek"
+ * appended, such as "music.flac.oalseek") is always used if present, so tables can be
+ * shipped with your app.
+ *
+ * @return The directory.
+ */
++ (NSString*) seekTableDirectory;
+
+/** Set the directory where seek tables are saved (nil = don't save).
+ *
+ * @param directory The directory.
+ */
++ (void) setSeekTableDirectory:(NSString*) directory;
+
 /** Open the audio file at the specified URL.
  *
  * @param url The URL to open the audio file from.
@@ -89,12 +168,41 @@
  * @param startFrame The starting audio frame to read data from.
  * @param numFrames The number of frames to read.
  * @param bufferSize On successful return, contains the size of the returned buffer, in bytes.
- * @return The audio data or nil on error.  You are responsible for calling free() on the data.
+ * @return The audio data (at outputFrequency, if set) or nil on error.
+ *         You are responsible for calling free() on the data.
  */
 - (void*) audioDataWithStartFrame:(SInt64) startFrame
 						numFrames:(SInt64) numFrames
 					   bufferSize:(UInt32*) bufferSize;
 
+/** Move the read position of this file.
+ * The next call to readFrames:intoBuffer: will start reading from this frame.
+ *
+ * @param frame The audio frame to seek to.
+ * @return TRUE if the operation was successful.
+ */
+- (bool) seekToFrame:(SInt64) frame;
+
+/** Read audio data from the current read position into a caller-supplied buffer.
+ * The buffer must be at least numFrames * streamDescription->mBytesPerFrame bytes long.
+ * The read position advances by the number of frames read.
+ *
+ * @param numFrames The maximum number of frames to read.
+ * @param buffer The buffer to read the audio data into.
+ * @return The number of frames actually read (0 at end of file or on error).
+ */
+- (UInt32) readFrames:(UInt32) numFrames intoBuffer:(void*) buffer;
+
+/** Build this file's seek table now, rather than on the first seek that needs it.
+ * Some compressed formats (such as FLAC) need a table of frame positions to seek in
+ * constant time. Formats that don't need one always succeed. <br>
+ *
+ * If seekTableDirectory is set, the table is saved there for next time.
+ *
+ * @return TRUE if seeking in this file now takes constant time.
+ */
+- (bool) buildSeekTable;
+
 /** Create a new ALBuffer with the contents of this file.
  *
  * @param name The name to be given to this ALBuffer.
@@ -116,4 +224,35 @@
 + (ALBuffer*) bufferFromUrl:(NSURL*) url
 			   reduceToMono:(bool) reduceToMono;
 
+/** Convenience method to load the entire contents of a URL into a new ALBuffer,
+ * converting it to a different sample rate.
+ *
+ * @param url The URL to open the audio file from.
+ * @param reduceToMono If YES, reduce any stereo track to mono
+                       (stereo samples don't support panning or positional audio).
+ * @param outputFrequency The sample rate to convert to (0 = keep the file's own rate).
+ * @param quality The quality of the conversion.
+ * @return an ALBuffer object.
+ */
++ (ALBuffer*) bufferFromUrl:(NSURL*) url
+			   reduceToMono:(bool) reduceToMono
+			outputFrequency:(ALsizei) outputFrequency
+					quality:(OALResampleQuality) quality;
+
+/** Convenience method to decode the entire contents of a URL without creating a buffer.
+ * Unlike the buffer loading methods, this can be called from any thread without
+ * involving the OpenAL context, other than to check which formats it supports.
+ *
+ * @param url The URL to open the audio file from.
+ * @param reduceToMono If YES, reduce any stereo track to mono
+                       (stereo samples don't support panning or positional audio).
+ * @param outputFrequency The sample rate to convert to (0 = keep the file's own rate).
+ * @param quality The quality of the conversion.
+ * @return The decoded audio data, or nil on error.
+ */
++ (OALAudioData*) audioDataFromUrl:(NSURL*) url
+					  reduceToMono:(bool) reduceToMono
+				   outputFrequency:(ALsizei) outputFrequency
+						   quality:(OALResampleQuality) quality;
+
 @end
@@ -30,10 +30,86 @@
 #import "OALAudioFile.h"
 #import "ObjectALMacros.h"
 #import "ARCSafe_MemMgmt.h"
+#import "OALAudioData.h"
+#import "OALLoadTelemetry.h"
+#import "oal_decoder.h"
+#import "oal_hash.h"
+#import "oal_resample.h"
+#import <mach/mach_time.h>
 
 
+/** The extension given to saved seek tables. */
+#define kSeekTableExtension @"oalseek"
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for OALAudioFile.
+ */
+@interface OALAudioFile (Private)
+
+/** (INTERNAL USE) Where this file's seek table is saved in seekTableDirectory.
+ */
+- (NSString*) seekTableCachePath;
+
+/** (INTERNAL USE) Load a previously saved seek table, if there is one.
+ */
+- (void) loadSeekTable;
+
+/** (INTERNAL USE) Save the decoder's seek table to seekTableDirectory if it has built one.
+ */
+- (void) saveSeekTable;
+
+/** (INTERNAL USE) Choose the format audio data is read in, based on reduceToMono,
+ * nativeFormats and what the current context supports, and apply it.
+ *
+ * @return TRUE if the operation was successful.
+ */
+- (bool) applyClientFormat;
+
+/** (INTERNAL USE) Convert audio data read from this file to outputFrequency.
+ *
+ * @param data The data to convert, which this method frees.
+ * @param frames The number of frames in data.
+ * @param bufferSize On successful return, contains the size of the converted data, in bytes.
+ * @return The converted data or nil on error.
+ */
+- (void*) resampleData:(void*) data
+				frames:(UInt32) frames
+			bufferSize:(UInt32*) bufferSize;
+
+@end
+/** \endcond */
+
+
+#pragma mark -
+#pragma mark OALAudioFile
+
 @implementation OALAudioFile
 
+static NSString* g_seekTableDirectory;
+
++ (NSString*) seekTableDirectory
+{
+	return g_seekTableDirectory;
+}
+
++ (void) setSeekTableDirectory:(NSString*) directory
+{
+	as_autorelease_noref(g_seekTableDirectory);
+	g_seekTableDirectory = as_retain(directory);
+	if(nil != directory)
+	{
+		[[NSFileManager defaultManager] createDirectoryAtPath:directory
+								  withIntermediateDirectories:YES
+												   attributes:nil
+														error:nil];
+	}
+}
+
 + (OALAudioFile*) fileWithUrl:(NSURL*) url
 				 reduceToMono:(bool) reduceToMono
 {
@@ -48,9 +124,12 @@
 	{
 		url = as_retain(urlIn);
 		reduceToMono = reduceToMonoIn;
+		resampleQuality = kOALResampleQualityHigh;
+		nativeFormats = YES;
 
 		OSStatus error = 0;
 		UInt32 size;
+		uint64_t openStart = mach_absolute_time();
 		
 		if(nil == url)
 		{
@@ -58,73 +137,82 @@
 			goto done;
 		}
 
-		// Open the file
-		if(noErr != (error = ExtAudioFileOpenURL((as_bridge CFURLRef)url, &fileHandle)))
+#if OBJECTAL_CFG_USE_NATIVE_DECODERS
+		if([url isFileURL])
 		{
-			REPORT_EXTAUDIO_CALL(error, @"Could not open url %@", url);
-			goto done;
+			decoder = oal_decoder_open([[url path] fileSystemRepresentation]);
+			if(nil != decoder && oal_decoder_total_frames(decoder) <= 0)
+			{
+				// Without a length, let the OS work it out.
+				oal_decoder_close(decoder);
+				decoder = nil;
+			}
 		}
+#endif
 
-		// Get some info about the file
-		size = sizeof(SInt64);
-		if(noErr != (error = ExtAudioFileGetProperty(fileHandle,
-													 kExtAudioFileProperty_FileLengthFrames,
-													 &size,
-													 &totalFrames)))
+		if(nil != decoder)
 		{
-			REPORT_EXTAUDIO_CALL(error, @"Could not get frame count for file (url = %@)", url);
-			goto done;
+			OAL_LOG_DEBUG(@"Using %s decoder for %@", oal_decoder_name(decoder), url);
+			[self loadSeekTable];
+			totalFrames = oal_decoder_total_frames(decoder);
+			memset(&streamDescription, 0, sizeof(streamDescription));
+			streamDescription.mSampleRate = oal_decoder_sample_rate(decoder);
+			streamDescription.mChannelsPerFrame = oal_decoder_channels(decoder);
+			sourceIsFloat = oal_decoder_is_float(decoder);
 		}
-		
-		
-		size = sizeof(AudioStreamBasicDescription);
-		if(noErr != (error = ExtAudioFileGetProperty(fileHandle,
-													 kExtAudioFileProperty_FileDataFormat,
-													 &size,
-													 &streamDescription)))
+		else
 		{
-			REPORT_EXTAUDIO_CALL(error, @"Could not get audio format for file (url = %@)", url);
-			goto done;
-		}
-		
-		// Specify the new audio format (anything not changed remains the same)
-		streamDescription.mFormatID = kAudioFormatLinearPCM;
-		streamDescription.mFormatFlags = kAudioFormatFlagsNativeEndian |
-		kAudioFormatFlagIsSignedInteger |
-		kAudioFormatFlagIsPacked;
-		// Force to 16 bit since iOS doesn't seem to like 8 bit.
-		streamDescription.mBitsPerChannel = 16;
+			// Open the file
+			if(noErr != (error = ExtAudioFileOpenURL((as_bridge CFURLRef)url, &fileHandle)))
+			{
+				REPORT_EXTAUDIO_CALL(error, @"Could not open url %@", url);
+				goto done;
+			}
 
-		originalChannelsPerFrame = streamDescription.mChannelsPerFrame > 2 ? 2 : streamDescription.mChannelsPerFrame;
-		if(reduceToMono)
-		{
-			streamDescription.mChannelsPerFrame = 1;
-		}
+			// Get some info about the file
+			size = sizeof(SInt64);
+			if(noErr != (error = ExtAudioFileGetProperty(fileHandle,
+														 kExtAudioFileProperty_FileLengthFrames,
+														 &size,
+														 &totalFrames)))
+			{
+				REPORT_EXTAUDIO_CALL(error, @"Could not get frame count for file (url = %@)", url);
+				goto done;
+			}
 		
-		if(streamDescription.mChannelsPerFrame > 2)
-		{
-			// Don't allow more than 2 channels (stereo)
-			OAL_LOG_WARNING(@"Audio stream in %@ contains %ld channels. Capping at 2",
-							url,
-							(long)streamDescription.mChannelsPerFrame);
-			streamDescription.mChannelsPerFrame = 2;
+		
+			size = sizeof(AudioStreamBasicDescription);
+			if(noErr != (error = ExtAudioFileGetProperty(fileHandle,
+														 kExtAudioFileProperty_FileDataFormat,
+														 &size,
+														 &streamDescription)))
+			{
+				REPORT_EXTAUDIO_CALL(error, @"Could not get audio format for file (url = %@)", url);
+				goto done;
+			}
+			sourceIsFloat = kAudioFormatLinearPCM == streamDescription.mFormatID &&
+				0 != (streamDescription.mFormatFlags & kAudioFormatFlagIsFloat);
 		}
 
-		streamDescription.mBytesPerFrame = streamDescription.mChannelsPerFrame * streamDescription.mBitsPerChannel / 8;
-		streamDescription.mFramesPerPacket = 1;
-		streamDescription.mBytesPerPacket = streamDescription.mBytesPerFrame * 1 /* streamDescription.mFramesPerPacket */;
-		
-		// Set the new audio format
-		if(noErr != (error = ExtAudioFileSetProperty(fileHandle,
-													 kExtAudioFileProperty_ClientDataFormat,
-													 sizeof(AudioStreamBasicDescription),
-													 &streamDescription)))
+		originalChannelsPerFrame = streamDescription.mChannelsPerFrame;
+		if(![self applyClientFormat])
 		{
-			REPORT_EXTAUDIO_CALL(error, @"Could not set new audio format for file (url = %@)", url);
+			error = kAudioFileUnspecifiedError;
 			goto done;
 		}
 		
 	done:
+		{
+			OALLoadRecord* record = [OALLoadRecord currentRecord];
+			if(nil != record)
+			{
+				[record addTimeSince:openStart toStage:kOALLoadStageOpen];
+				if([url isFileURL])
+				{
+					record.bytesIn += [[[NSFileManager defaultManager] attributesOfItemAtPath:[url path] error:nil] fileSize];
+				}
+			}
+		}
 		if(noErr != error)
 		{
 			as_release(self);
@@ -142,6 +230,11 @@
         REPORT_EXTAUDIO_CALL(ExtAudioFileDispose(fileHandle), @"Error closing file (url = %@)", url);
         fileHandle = nil;
     }
+	if(nil != decoder)
+	{
+		oal_decoder_close(decoder);
+		decoder = nil;
+	}
 
 	as_release(url);
 	as_superdealloc();
@@ -161,6 +254,12 @@
 
 @synthesize totalFrames;
 
+@synthesize maxDecodeThreads;
+
+@synthesize outputFrequency;
+
+@synthesize resampleQuality;
+
 - (bool) reduceToMono
 {
 	return reduceToMono;
@@ -172,37 +271,312 @@
 	{
 		if(value != reduceToMono)
 		{
-			OSStatus error;
 			reduceToMono = value;
-			streamDescription.mChannelsPerFrame = reduceToMono ? 1 : originalChannelsPerFrame;
-			if(noErr != (error = ExtAudioFileSetProperty(fileHandle,
-														 kExtAudioFileProperty_ClientDataFormat,
-														 sizeof(AudioStreamBasicDescription),
-														 &streamDescription)))
+			[self applyClientFormat];
+		}
+	}
+}
+
+- (bool) nativeFormats
+{
+	return nativeFormats;
+}
+
+- (void) setNativeFormats:(bool) value
+{
+	@synchronized(self)
+	{
+		if(value != nativeFormats)
+		{
+			nativeFormats = value;
+			[self applyClientFormat];
+		}
+	}
+}
+
+- (bool) applyClientFormat
+{
+	UInt32 channels = reduceToMono ? 1 : originalChannelsPerFrame;
+	bool useFloat = nativeFormats && sourceIsFloat;
+
+	if(channels > 2 &&
+	   (!nativeFormats || AL_NONE == [ALBuffer formatWithChannels:(ALint)channels bits:16 floatingPoint:NO]))
+	{
+		// Don't allow more than 2 channels (stereo) unless the device can play them.
+		OAL_LOG_WARNING(@"Audio stream in %@ contains %ld channels. Capping at 2",
+						url,
+						(long)channels);
+		channels = 2;
+	}
+	if(useFloat && AL_NONE == [ALBuffer formatWithChannels:(ALint)channels bits:32 floatingPoint:YES])
+	{
+		OAL_LOG_DEBUG(@"No float buffer support. Converting %@ to 16 bit", url);
+		useFloat = NO;
+	}
+
+	// Specify the new audio format (anything not changed remains the same)
+	streamDescription.mFormatID = kAudioFormatLinearPCM;
+	if(useFloat)
+	{
+		streamDescription.mFormatFlags = kAudioFormatFlagsNativeEndian |
+		kAudioFormatFlagIsFloat |
+		kAudioFormatFlagIsPacked;
+		streamDescription.mBitsPerChannel = 32;
+	}
+	else
+	{
+		streamDescription.mFormatFlags = kAudioFormatFlagsNativeEndian |
+		kAudioFormatFlagIsSignedInteger |
+		kAudioFormatFlagIsPacked;
+		// Force to 16 bit since iOS doesn't seem to like 8 bit.
+		streamDescription.mBitsPerChannel = 16;
+	}
+	streamDescription.mChannelsPerFrame = channels;
+	streamDescription.mBytesPerFrame = streamDescription.mChannelsPerFrame * streamDescription.mBitsPerChannel / 8;
+	streamDescription.mFramesPerPacket = 1;
+	streamDescription.mBytesPerPacket = streamDescription.mBytesPerFrame * 1 /* streamDescription.mFramesPerPacket */;
+
+	// Set the new audio format
+	if(nil != decoder)
+	{
+		return oal_decoder_set_output_channels(decoder, channels) &&
+			oal_decoder_set_output_float(decoder, useFloat);
+	}
+
+	OSStatus error;
+	if(noErr != (error = ExtAudioFileSetProperty(fileHandle,
+												 kExtAudioFileProperty_ClientDataFormat,
+												 sizeof(AudioStreamBasicDescription),
+												 &streamDescription)))
+	{
+		REPORT_EXTAUDIO_CALL(error, @"Could not set new audio format for file (url = %@)", url);
+		return NO;
+	}
+	return YES;
+}
+
+- (ALenum) format
+{
+	return [ALBuffer formatWithChannels:(ALint)streamDescription.mChannelsPerFrame
+								   bits:(ALint)streamDescription.mBitsPerChannel
+						  floatingPoint:0 != (streamDescription.mFormatFlags & kAudioFormatFlagIsFloat)];
+}
+
+- (bool) seekToFrame:(SInt64) frame
+{
+	@synchronized(self)
+	{
+		if(nil == fileHandle && nil == decoder)
+		{
+			OAL_LOG_ERROR(@"Attempted to seek in closed file (url = %@)", url);
+			return NO;
+		}
+
+		if(nil != decoder)
+		{
+			if(!oal_decoder_seek(decoder, frame))
+			{
+				OAL_LOG_ERROR(@"Could not seek to %lld in file (url = %@)", frame, url);
+				return NO;
+			}
+			[self saveSeekTable];
+			return YES;
+		}
+
+		OSStatus error;
+		if(noErr != (error = ExtAudioFileSeek(fileHandle, frame)))
+		{
+			REPORT_EXTAUDIO_CALL(error, @"Could not seek to %lld in file (url = %@)",
+								 frame,
+								 url);
+			return NO;
+		}
+		return YES;
+	}
+}
+
+- (UInt32) readFrames:(UInt32) numFrames intoBuffer:(void*) buffer
+{
+	@synchronized(self)
+	{
+		if(nil == fileHandle && nil == decoder)
+		{
+			OAL_LOG_ERROR(@"Attempted to read from closed file (url = %@)", url);
+			return 0;
+		}
+
+		if(nil != decoder)
+		{
+			return oal_decoder_read_parallel(decoder, buffer, numFrames, (uint32_t)maxDecodeThreads);
+		}
+
+		OSStatus error;
+		UInt32 numFramesRead;
+		UInt32 framesRead = 0;
+		AudioBufferList bufferList;
+
+		bufferList.mNumberBuffers = 1;
+		bufferList.mBuffers[0].mNumberChannels = streamDescription.mChannelsPerFrame;
+		for(UInt32 framesToRead = numFrames; framesToRead > 0; framesToRead -= numFramesRead)
+		{
+			bufferList.mBuffers[0].mDataByteSize = streamDescription.mBytesPerFrame * framesToRead;
+			bufferList.mBuffers[0].mData = (char*)buffer + streamDescription.mBytesPerFrame * framesRead;
+
+			numFramesRead = framesToRead;
+			if(noErr != (error = ExtAudioFileRead(fileHandle, &numFramesRead, &bufferList)))
+			{
+				REPORT_EXTAUDIO_CALL(error, @"Could not read audio data in file (url = %@)",
+									 url);
+				break;
+			}
+			framesRead += numFramesRead;
+			if(numFramesRead == 0)
 			{
-				REPORT_EXTAUDIO_CALL(error, @"Could not set new audio format for file (url = %@)", url);
+				// Sometimes the stream description was wrong and you hit an EOF prematurely
+				break;
 			}
 		}
+		return framesRead;
 	}
 }
 
+- (bool) buildSeekTable
+{
+	@synchronized(self)
+	{
+		if(nil == decoder)
+		{
+			// ExtAudioFile keeps its own packet tables.
+			return nil != fileHandle;
+		}
+		if(!oal_decoder_build_seek_table(decoder))
+		{
+			OAL_LOG_WARNING(@"Could not build seek table (url = %@)", url);
+			return NO;
+		}
+		[self saveSeekTable];
+		return YES;
+	}
+}
+
+- (NSString*) seekTableCachePath
+{
+	NSString* path = [url path];
+	const char* pathChars = [path fileSystemRepresentation];
+	NSString* file = [NSString stringWithFormat:@"%016llx-%@.%@",
+					  (unsigned long long)oal_hash64(pathChars, strlen(pathChars), 0),
+					  [path lastPathComponent],
+					  kSeekTableExtension];
+	return [g_seekTableDirectory stringByAppendingPathComponent:file];
+}
+
+- (void) loadSeekTable
+{
+	NSString* shippedPath = [[url path] stringByAppendingPathExtension:kSeekTableExtension];
+	if(oal_decoder_load_seek_table(decoder, [shippedPath fileSystemRepresentation]))
+	{
+		OAL_LOG_DEBUG(@"Loaded seek table %@", shippedPath);
+		seekTableStored = YES;
+		return;
+	}
+	if(nil != g_seekTableDirectory)
+	{
+		NSString* cachePath = [self seekTableCachePath];
+		if(oal_decoder_load_seek_table(decoder, [cachePath fileSystemRepresentation]))
+		{
+			OAL_LOG_DEBUG(@"Loaded seek table %@", cachePath);
+			seekTableStored = YES;
+		}
+	}
+}
+
+- (void) saveSeekTable
+{
+	if(seekTableStored || nil == g_seekTableDirectory)
+	{
+		return;
+	}
+
+	// Fails harmlessly until the decoder has actually built a table.
+	if(oal_decoder_save_seek_table(decoder, [[self seekTableCachePath] fileSystemRepresentation]))
+	{
+		OAL_LOG_DEBUG(@"Saved seek table for %@", url);
+		seekTableStored = YES;
+	}
+}
+
+- (void*) resampleData:(void*) data
+				frames:(UInt32) frames
+			bufferSize:(UInt32*) bufferSize
+{
+	size_t resampledFrames;
+	void* resampled = nil;
+	oal_resampler* resampler = oal_resampler_create((uint32_t)streamDescription.mSampleRate,
+													(uint32_t)outputFrequency,
+													streamDescription.mChannelsPerFrame,
+													(oal_resample_quality)resampleQuality);
+	if(nil == resampler)
+	{
+		OAL_LOG_ERROR(@"Could not create resampler for %.0f Hz to %d Hz (url = %@)",
+					  streamDescription.mSampleRate,
+					  outputFrequency,
+					  url);
+		goto done;
+	}
+
+	resampledFrames = oal_resampler_output_frames(resampler, frames);
+	resampled = malloc(resampledFrames * streamDescription.mBytesPerFrame);
+	if(nil == resampled)
+	{
+		OAL_LOG_ERROR(@"Could not allocate %ld bytes for resampled audio from file (url = %@)",
+					  (long)(resampledFrames * streamDescription.mBytesPerFrame),
+					  url);
+		goto done;
+	}
+
+	OAL_LOG_DEBUG(@"Resampling %@ from %.0f Hz to %d Hz", url, streamDescription.mSampleRate, outputFrequency);
+	if(streamDescription.mFormatFlags & kAudioFormatFlagIsFloat)
+	{
+		resampledFrames = oal_resampler_process_float(resampler, data, frames, resampled);
+	}
+	else
+	{
+		resampledFrames = oal_resampler_process(resampler, data, frames, resampled);
+	}
+	if(0 == resampledFrames && frames > 0)
+	{
+		OAL_LOG_ERROR(@"Could not resample audio data (url = %@)", url);
+		free(resampled);
+		resampled = nil;
+		goto done;
+	}
+
+	if(nil != bufferSize)
+	{
+		*bufferSize = (UInt32)(resampledFrames * streamDescription.mBytesPerFrame);
+	}
+
+done:
+	oal_resampler_destroy(resampler);
+	free(data);
+	return resampled;
+}
+
 - (void*) audioDataWithStartFrame:(SInt64) startFrame
 						numFrames:(SInt64) numFrames
 					   bufferSize:(UInt32*) bufferSize
 {
 	@synchronized(self)
 	{
-		if(nil == fileHandle)
+		if(nil == fileHandle && nil == decoder)
 		{
 			OAL_LOG_ERROR(@"Attempted to read from closed file. Returning nil (url = %@)", url);
 			return nil;
 		}
-		
-		OSStatus error;
-		UInt32 numFramesRead;
-        AudioBufferList bufferList;
-        UInt32 bufferOffset = 0;
 
+		UInt32 framesRead;
+		OALLoadRecord* record = [OALLoadRecord currentRecord];
+		uint64_t stageStart;
 		
 		// < 0 means read to the end of the file.
 		if(numFrames < 0)
@@ -221,42 +595,40 @@
 			goto onFail;
 		}
 		
-		if(noErr != (error = ExtAudioFileSeek(fileHandle, startFrame)))
+		if(![self seekToFrame:startFrame])
 		{
-			REPORT_EXTAUDIO_CALL(error, @"Could not seek to %lld in file (url = %@)",
-								 startFrame,
-								 url);
 			goto onFail;
 		}
+
+		stageStart = mach_absolute_time();
+		framesRead = [self readFrames:(UInt32)numFrames intoBuffer:streamData];
+		if(framesRead == 0 && numFrames > 0)
+		{
+			goto onFail;
+		}
+		[record addTimeSince:stageStart toStage:kOALLoadStageDecode];
 		
-        
-        bufferList.mNumberBuffers = 1;
-        bufferList.mBuffers[0].mNumberChannels = streamDescription.mChannelsPerFrame;
-        for(UInt32 framesToRead = (UInt32) numFrames; framesToRead > 0; framesToRead -= numFramesRead)
-        {
-            bufferList.mBuffers[0].mDataByteSize = streamDescription.mBytesPerFrame * framesToRead;
-            bufferList.mBuffers[0].mData = (char*)streamData + bufferOffset;
-            
-            numFramesRead = framesToRead;
-            if(noErr != (error = ExtAudioFileRead(fileHandle, &numFramesRead, &bufferList)))
-            {
-                REPORT_EXTAUDIO_CALL(error, @"Could not read audio data in file (url = %@)",
-                                     url);
-                goto onFail;
-            }
-            bufferOffset += streamDescription.mBytesPerFrame * numFramesRead;
-            if(numFramesRead == 0)
-            {
-                // Sometimes the stream description was wrong and you hit an EOF prematurely
-                break;
-            }
-        }
-		
+		if(outputFrequency > 0 && outputFrequency != (ALsizei)streamDescription.mSampleRate)
+		{
+			UInt32 resampledSize = 0;
+			stageStart = mach_absolute_time();
+			// resampleData frees the original data, even on failure.
+			void* resampled = [self resampleData:streamData frames:framesRead bufferSize:&resampledSize];
+			[record addTimeSince:stageStart toStage:kOALLoadStageConversion];
+			record.bytesOut += resampledSize;
+			if(nil != bufferSize)
+			{
+				*bufferSize = resampledSize;
+			}
+			return resampled;
+		}
+
 		if(nil != bufferSize)
 		{
             // Use however many bytes were actually read
-			*bufferSize = bufferOffset;
+			*bufferSize = framesRead * streamDescription.mBytesPerFrame;
 		}
+		record.bytesOut += framesRead * streamDescription.mBytesPerFrame;
 		
 		return streamData;
 		
@@ -276,7 +648,7 @@
 {
 	@synchronized(self)
 	{
-		if(nil == fileHandle)
+		if(nil == fileHandle && nil == decoder)
 		{
 			OAL_LOG_ERROR(@"Attempted to read from closed file. Returning nil (url = %@)", url);
 			return nil;
@@ -289,41 +661,30 @@
 			return nil;
 		}
 		
-		ALenum audioFormat;
-		if(1 == streamDescription.mChannelsPerFrame)
-		{
-			if(8 == streamDescription.mBitsPerChannel)
-			{
-				audioFormat = AL_FORMAT_MONO8;
-			}
-			else
-			{
-				audioFormat = AL_FORMAT_MONO16;
-			}
-		}
-		else
-		{
-			if(8 == streamDescription.mBitsPerChannel)
-			{
-				audioFormat = AL_FORMAT_STEREO8;
-			}
-			else
-			{
-				audioFormat = AL_FORMAT_STEREO16;
-			}
-		}
-		
 		return [ALBuffer bufferWithName:name
 								   data:streamData
 								   size:(ALsizei)bufferSize
-								 format:audioFormat
-							  frequency:(ALsizei)streamDescription.mSampleRate];
+								 format:self.format
+							  frequency:outputFrequency > 0 ? outputFrequency : (ALsizei)streamDescription.mSampleRate];
 	}
 }
 
 + (ALBuffer*) bufferFromUrl:(NSURL*) url reduceToMono:(bool) reduceToMono
 {
-	id file = [[self alloc] initWithUrl:url reduceToMono:reduceToMono];
+	return [self bufferFromUrl:url
+				  reduceToMono:reduceToMono
+			   outputFrequency:0
+					   quality:kOALResampleQualityHigh];
+}
+
++ (ALBuffer*) bufferFromUrl:(NSURL*) url
+			   reduceToMono:(bool) reduceToMono
+			outputFrequency:(ALsizei) outputFrequency
+					quality:(OALResampleQuality) quality
+{
+	OALAudioFile* file = [[self alloc] initWithUrl:url reduceToMono:reduceToMono];
+	file.outputFrequency = outputFrequency;
+	file.resampleQuality = quality;
 	ALBuffer* buffer = [file bufferNamed:[url description]
 							  startFrame:0
 							   numFrames:-1];
@@ -331,4 +692,30 @@
 	return buffer;
 }
 
++ (OALAudioData*) audioDataFromUrl:(NSURL*) url
+					  reduceToMono:(bool) reduceToMono
+				   outputFrequency:(ALsizei) outputFrequency
+						   quality:(OALResampleQuality) quality
+{
+	OALAudioFile* file = [[self alloc] initWithUrl:url reduceToMono:reduceToMono];
+	file.outputFrequency = outputFrequency;
+	file.resampleQuality = quality;
+
+	OALAudioData* audioData = nil;
+	UInt32 bufferSize;
+	void* data = [file audioDataWithStartFrame:0 numFrames:-1 bufferSize:&bufferSize];
+	if(nil != data)
+	{
+		NSData* backingData = [[NSData alloc] initWithBytesNoCopy:data length:bufferSize freeWhenDone:YES];
+		audioData = [OALAudioData dataWithBackingData:backingData
+											   offset:0
+												 size:(ALsizei)bufferSize
+											   format:file.format
+											frequency:outputFrequency > 0 ? outputFrequency : (ALsizei)file.streamDescription->mSampleRate];
+		as_release(backingData);
+	}
+	as_release(file);
+	return audioData;
+}
+
 @end
@@ -0,0 +1,154 @@
+//
+//  OALDecodedAudioCache.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import <Foundation/Foundation.h>
+#import "ALBuffer.h"
+#import "OALAudioFile.h"
+#import "SynthesizeSingleton.h"
+
+
+/**
+ * An on-disk cache of decoded audio data.
+ *
+ * Decoding compressed audio is expensive, and the result never changes between
+ * runs of your app. When enabled, the cache stores the decoded PCM data of every
+ * file loaded through OpenALManager (and by extension OALSimpleAudio), so that
+ * later loads can map the decoded data straight from disk instead. <br>
+ *
+ * Entries are keyed by a hash of the source file's contents plus the output
+ * format (channel layout, sample rate, and the float and multichannel formats the
+ * current context supports), so a modified source file never picks up an old entry,
+ * and an entry is never served to a context that can't play it. The cache is
+ * kept under maxSize by evicting the least recently used entries.
+ */
+@interface OALDecodedAudioCache : NSObject
+{
+	bool enabled;
+	NSString* directory;
+	unsigned long long maxSize;
+}
+
+
+#pragma mark Properties
+
+/** If YES, decoded audio is stored in and loaded from the cache (default NO). */
+@property(nonatomic,readwrite,assign) bool enabled;
+
+/** The directory where cache entries are stored
+ * (default: "ObjectAL/DecodedAudio" in the user's cache directory).
+ */
+@property(nonatomic,readwrite,retain) NSString* directory;
+
+/** The maximum size of the cache, in bytes (default 64 MB).
+ * When the cache grows past this size, the least recently used entries are removed.
+ */
+@property(nonatomic,readwrite,assign) unsigned long long maxSize;
+
+/** The current size of all entries in the cache, in bytes. */
+@property(nonatomic,readonly,assign) unsigned long long currentSize;
+
+
+#pragma mark Object Management
+
+/** Singleton implementation providing "sharedInstance" and "purgeSharedInstance" methods.
+ *
+ * <b>- (OALDecodedAudioCache*) sharedInstance</b>: Get the shared singleton instance. <br>
+ * <b>- (void) purgeSharedInstance</b>: Purge (deallocate) the shared instance.
+ */
+SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALDecodedAudioCache);
+
+
+#pragma mark Buffers
+
+/** Load the entire contents of a URL into a new ALBuffer, using the cached
+ * decoded data if available. On a cache miss, the file is decoded and the
+ * result is added to the cache. <br>
+ *
+ * Only file URLs are cached. If the cache is disabled, this is the same as
+ * calling [OALAudioFile bufferFromUrl:reduceToMono:].
+ *
+ * @param url The URL to open the audio file from.
+ * @param reduceToMono If YES, reduce any stereo track to mono
+ *                     (stereo samples don't support panning or positional audio).
+ * @return an ALBuffer object.
+ */
+- (ALBuffer*) bufferFromUrl:(NSURL*) url reduceToMono:(bool) reduceToMono;
+
+/** Load the entire contents of a URL into a new ALBuffer at a different sample rate,
+ * using the cached converted data if available. Entries are kept separately for each
+ * output frequency and quality. <br>
+ *
+ * If the cache is disabled, this is the same as calling
+ * [OALAudioFile bufferFromUrl:reduceToMono:outputFrequency:quality:].
+ *
+ * @param url The URL to open the audio file from.
+ * @param reduceToMono If YES, reduce any stereo track to mono
+ *                     (stereo samples don't support panning or positional audio).
+ * @param outputFrequency The sample rate to convert to (0 = keep the file's own rate).
+ * @param quality The quality of the conversion.
+ * @return an ALBuffer object.
+ */
+- (ALBuffer*) bufferFromUrl:(NSURL*) url
+			   reduceToMono:(bool) reduceToMono
+			outputFrequency:(ALsizei) outputFrequency
+					quality:(OALResampleQuality) quality;
+
+/** Decode the entire contents of a URL without creating a buffer, using the cached
+ * decoded data if available. Safe to call from any thread. <br>
+ *
+ * If the cache is disabled, this is the same as calling
+ * [OALAudioFile audioDataFromUrl:reduceToMono:outputFrequency:quality:].
+ *
+ * @param url The URL to open the audio file from.
+ * @param reduceToMono If YES, reduce any stereo track to mono
+ *                     (stereo samples don't support panning or positional audio).
+ * @param outputFrequency The sample rate to convert to (0 = keep the file's own rate).
+ * @param quality The quality of the conversion.
+ * @return The decoded audio data, or nil on error.
+ */
+- (OALAudioData*) audioDataFromUrl:(NSURL*) url
+					  reduceToMono:(bool) reduceToMono
+				   outputFrequency:(ALsizei) outputFrequency
+						   quality:(OALResampleQuality) quality;
+
+
+#pragma mark Maintenance
+
+/** Remove least recently used entries until the cache is no larger than the specified size.
+ *
+ * @param size The size to trim the cache to, in bytes.
+ */
+- (void) trimToSize:(unsigned long long) size;
+
+/** Remove all entries from the cache.
+ */
+- (void) removeAllEntries;
+
+@end
@@ -0,0 +1,490 @@
+//
+//  OALDecodedAudioCache.m
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#import "OALDecodedAudioCache.h"
+#import "OALAudioFile.h"
+#import "OALAudioData.h"
+#import "OALLoadTelemetry.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+#import "oal_hash.h"
+#include <stdio.h>
+#include <mach/mach_time.h>
+
+
+/** Identifies a cache entry file ("OALC"). */
+#define kEntryMagic 0x434c414f
+
+/** Bump this whenever the entry layout or decoder output changes. */
+#define kEntryVersion 3
+
+#define kEntryExtension @"oalpcm"
+
+#define kDefaultMaxSize (64ull * 1024 * 1024)
+
+/** The header at the start of each cache entry file. The PCM data follows it. */
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceHash;
+	uint64_t sourceSize;
+	uint32_t reduceToMono;
+	uint32_t format;
+	uint32_t frequency;
+	uint32_t reserved;
+	uint64_t dataSize;
+	/** Pad to 64 bytes so the PCM data stays well aligned. */
+	uint8_t padding[16];
+} OALDecodedAudioCacheEntryHeader;
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+SYNTHESIZE_SINGLETON_FOR_CLASS_PROTOTYPE(OALDecodedAudioCache);
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for OALDecodedAudioCache.
+ */
+@interface OALDecodedAudioCache (Private)
+
+/** (INTERNAL USE) The path of the entry for a source file and output format.
+ */
+- (NSString*) pathForSourceHash:(uint64_t) hash
+					 sourceSize:(uint64_t) size
+				   reduceToMono:(bool) reduceToMono
+				outputFrequency:(ALsizei) outputFrequency
+						quality:(OALResampleQuality) quality;
+
+/** (INTERNAL USE) Describe the sample formats the current context can play.
+ * Together with the source file, these decide the format that audio is decoded to.
+ */
+- (NSString*) sampleFormatKey;
+
+/** (INTERNAL USE) Check if the current context can play a format.
+ */
+- (bool) canPlayFormat:(ALenum) format;
+
+/** (INTERNAL USE) Map an entry's audio data.
+ * Invalid or stale entries, and entries the current context can't play, are deleted.
+ */
+- (OALAudioData*) audioDataFromEntryAtPath:(NSString*) path
+								sourceHash:(uint64_t) hash
+								sourceSize:(uint64_t) size
+							  reduceToMono:(bool) reduceToMono
+						   outputFrequency:(ALsizei) outputFrequency;
+
+/** (INTERNAL USE) Write audio data to a new entry.
+ */
+- (void) storeAudioData:(OALAudioData*) audioData
+				 atPath:(NSString*) path
+			 sourceHash:(uint64_t) hash
+			 sourceSize:(uint64_t) size
+		   reduceToMono:(bool) reduceToMono;
+
+@end
+/** \endcond */
+
+/** Orders cache entries (arrays of modification date, path, size) from least to most recently used. */
+static NSInteger compareEntryDates(id first, id second, void* context)
+{
+	#pragma unused(context)
+	return [[first objectAtIndex:0] compare:[second objectAtIndex:0]];
+}
+
+
+#pragma mark -
+#pragma mark OALDecodedAudioCache
+
+@implementation OALDecodedAudioCache
+
+#pragma mark Object Management
+
+SYNTHESIZE_SINGLETON_FOR_CLASS(OALDecodedAudioCache);
+
+- (id) init
+{
+	if(nil != (self = [super init]))
+	{
+		OAL_LOG_DEBUG(@"%@: Init", self);
+
+		NSArray* paths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES);
+		NSString* cachesDirectory = [paths count] > 0 ? [paths objectAtIndex:0] : NSTemporaryDirectory();
+		directory = as_retain([cachesDirectory stringByAppendingPathComponent:@"ObjectAL/DecodedAudio"]);
+		maxSize = kDefaultMaxSize;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	OAL_LOG_DEBUG(@"%@: Dealloc", self);
+	as_release(directory);
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+@synthesize enabled;
+
+- (NSString*) directory
+{
+	@synchronized(self)
+	{
+		return as_autorelease(as_retain(directory));
+	}
+}
+
+- (void) setDirectory:(NSString*) value
+{
+	@synchronized(self)
+	{
+		as_autorelease_noref(directory);
+		directory = as_retain(value);
+	}
+}
+
+- (unsigned long long) maxSize
+{
+	return maxSize;
+}
+
+- (void) setMaxSize:(unsigned long long) value
+{
+	@synchronized(self)
+	{
+		maxSize = value;
+		[self trimToSize:maxSize];
+	}
+}
+
+- (unsigned long long) currentSize
+{
+	@synchronized(self)
+	{
+		NSFileManager* fileManager = [NSFileManager defaultManager];
+		unsigned long long total = 0;
+		for(NSString* file in [fileManager contentsOfDirectoryAtPath:directory error:nil])
+		{
+			if([[file pathExtension] isEqualToString:kEntryExtension])
+			{
+				NSString* path = [directory stringByAppendingPathComponent:file];
+				total += [[fileManager attributesOfItemAtPath:path error:nil] fileSize];
+			}
+		}
+		return total;
+	}
+}
+
+
+#pragma mark Buffers
+
+- (ALBuffer*) bufferFromUrl:(NSURL*) url reduceToMono:(bool) reduceToMono
+{
+	return [self bufferFromUrl:url
+				  reduceToMono:reduceToMono
+			   outputFrequency:0
+					   quality:kOALResampleQualityHigh];
+}
+
+- (ALBuffer*) bufferFromUrl:(NSURL*) url
+			   reduceToMono:(bool) reduceToMono
+			outputFrequency:(ALsizei) outputFrequency
+					quality:(OALResampleQuality) quality
+{
+	if(!enabled || ![url isFileURL])
+	{
+		return [OALAudioFile bufferFromUrl:url
+							  reduceToMono:reduceToMono
+						   outputFrequency:outputFrequency
+								   quality:quality];
+	}
+
+	return [[self audioDataFromUrl:url
+					  reduceToMono:reduceToMono
+				   outputFrequency:outputFrequency
+						   quality:quality] bufferNamed:[url description]];
+}
+
+- (OALAudioData*) audioDataFromUrl:(NSURL*) url
+					  reduceToMono:(bool) reduceToMono
+				   outputFrequency:(ALsizei) outputFrequency
+						   quality:(OALResampleQuality) quality
+{
+	if(!enabled || ![url isFileURL])
+	{
+		return [OALAudioFile audioDataFromUrl:url
+								 reduceToMono:reduceToMono
+							  outputFrequency:outputFrequency
+									  quality:quality];
+	}
+
+	OALLoadRecord* record = [OALLoadRecord currentRecord];
+	uint64_t hashStart = mach_absolute_time();
+
+	// Mapping the source avoids copying it just to hash it.
+	NSError* error = nil;
+	NSData* source = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedIfSafe error:&error];
+	if(nil == source)
+	{
+		OAL_LOG_WARNING(@"%@: Could not read %@ (%@). Bypassing cache", self, url, error);
+		return [OALAudioFile audioDataFromUrl:url
+								 reduceToMono:reduceToMono
+							  outputFrequency:outputFrequency
+									  quality:quality];
+	}
+	uint64_t hash = oal_hash64([source bytes], [source length], 0);
+	uint64_t size = [source length];
+	[record addTimeSince:hashStart toStage:kOALLoadStageOpen];
+
+	NSString* path = [self pathForSourceHash:hash
+								  sourceSize:size
+								reduceToMono:reduceToMono
+							 outputFrequency:outputFrequency
+									 quality:quality];
+	OALAudioData* audioData = [self audioDataFromEntryAtPath:path
+												  sourceHash:hash
+												  sourceSize:size
+												reduceToMono:reduceToMono
+											 outputFrequency:outputFrequency];
+	if(nil != audioData)
+	{
+		OAL_LOG_DEBUG(@"%@: Loaded %@ from cache", self, url);
+		record.cacheResult = kOALLoadCacheHit;
+		record.bytesIn = [audioData.backingData length];
+		record.bytesOut = (unsigned long long)audioData.size;
+		return audioData;
+	}
+	record.cacheResult = kOALLoadCacheMiss;
+
+	audioData = [OALAudioFile audioDataFromUrl:url
+								  reduceToMono:reduceToMono
+							   outputFrequency:outputFrequency
+									   quality:quality];
+	if(nil != audioData)
+	{
+		[self storeAudioData:audioData atPath:path sourceHash:hash sourceSize:size reduceToMono:reduceToMono];
+	}
+	return audioData;
+}
+
+- (NSString*) pathForSourceHash:(uint64_t) hash
+					 sourceSize:(uint64_t) size
+				   reduceToMono:(bool) reduceToMono
+				outputFrequency:(ALsizei) outputFrequency
+						quality:(OALResampleQuality) quality
+{
+	NSString* rate = outputFrequency > 0 ? [NSString stringWithFormat:@"%dq%d", outputFrequency, quality] : @"native";
+	NSString* file = [NSString stringWithFormat:@"%016llx-%llx-%@-%@-%@.%@",
+					  (unsigned long long)hash,
+					  (unsigned long long)size,
+					  reduceToMono ? @"mono" : @"native",
+					  rate,
+					  [self sampleFormatKey],
+					  kEntryExtension];
+	return [self.directory stringByAppendingPathComponent:file];
+}
+
+- (NSString*) sampleFormatKey
+{
+	// Float files decode to 32-bit float only with AL_EXT_FLOAT32, and files with more
+	// than 2 channels keep them only with AL_EXT_MCFORMATS.
+	bool hasFloat = AL_NONE != [ALBuffer formatWithChannels:1 bits:32 floatingPoint:YES];
+	bool hasMultichannel = AL_NONE != [ALBuffer formatWithChannels:4 bits:16 floatingPoint:NO];
+	return [NSString stringWithFormat:@"%@%@", hasFloat ? @"f32" : @"s16", hasMultichannel ? @"mc" : @""];
+}
+
+- (bool) canPlayFormat:(ALenum) format
+{
+	static const ALint channelCounts[] = {1, 2, 4, 6, 7, 8};
+	for(size_t i = 0; i < sizeof(channelCounts) / sizeof(*channelCounts); i++)
+	{
+		if(format == [ALBuffer formatWithChannels:channelCounts[i] bits:16 floatingPoint:NO] ||
+		   format == [ALBuffer formatWithChannels:channelCounts[i] bits:32 floatingPoint:YES])
+		{
+			return AL_NONE != format;
+		}
+	}
+	return NO;
+}
+
+- (OALAudioData*) audioDataFromEntryAtPath:(NSString*) path
+								sourceHash:(uint64_t) hash
+								sourceSize:(uint64_t) size
+							  reduceToMono:(bool) reduceToMono
+						   outputFrequency:(ALsizei) outputFrequency
+{
+	NSFileManager* fileManager = [NSFileManager defaultManager];
+	if(![fileManager fileExistsAtPath:path])
+	{
+		return nil;
+	}
+
+	NSData* entry = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:nil];
+	const OALDecodedAudioCacheEntryHeader* header = [entry bytes];
+	if(nil == entry ||
+	   [entry length] < sizeof(*header) ||
+	   kEntryMagic != header->magic ||
+	   kEntryVersion != header->version ||
+	   hash != header->sourceHash ||
+	   size != header->sourceSize ||
+	   (reduceToMono ? 1 : 0) != header->reduceToMono ||
+	   (outputFrequency > 0 && (uint32_t)outputFrequency != header->frequency) ||
+	   [entry length] - sizeof(*header) != header->dataSize ||
+	   ![self canPlayFormat:(ALenum)header->format])
+	{
+		OAL_LOG_WARNING(@"%@: Removing stale cache entry %@", self, path);
+		[fileManager removeItemAtPath:path error:nil];
+		return nil;
+	}
+
+	// The modification date doubles as the last access time for eviction.
+	[fileManager setAttributes:[NSDictionary dictionaryWithObject:[NSDate date] forKey:NSFileModificationDate]
+				  ofItemAtPath:path
+						 error:nil];
+
+	return [OALAudioData dataWithBackingData:entry
+									  offset:sizeof(*header)
+										size:(ALsizei)header->dataSize
+									  format:(ALenum)header->format
+								   frequency:(ALsizei)header->frequency];
+}
+
+- (void) storeAudioData:(OALAudioData*) audioData
+				 atPath:(NSString*) path
+			 sourceHash:(uint64_t) hash
+			 sourceSize:(uint64_t) size
+		   reduceToMono:(bool) reduceToMono
+{
+	OALDecodedAudioCacheEntryHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = kEntryMagic;
+	header.version = kEntryVersion;
+	header.sourceHash = hash;
+	header.sourceSize = size;
+	header.reduceToMono = reduceToMono ? 1 : 0;
+	header.format = (uint32_t)audioData.format;
+	header.frequency = (uint32_t)audioData.frequency;
+	header.dataSize = (uint64_t)audioData.size;
+
+	@synchronized(self)
+	{
+		NSError* error = nil;
+		if(![[NSFileManager defaultManager] createDirectoryAtPath:directory
+									  withIntermediateDirectories:YES
+													   attributes:nil
+															error:&error])
+		{
+			OAL_LOG_WARNING(@"%@: Could not create cache directory %@: %@", self, directory, error);
+			return;
+		}
+
+		// Write to a temporary file and rename it so that a partial entry is never visible.
+		NSString* tempPath = [path stringByAppendingPathExtension:@"tmp"];
+		FILE* file = fopen([tempPath fileSystemRepresentation], "wb");
+		if(nil == file)
+		{
+			OAL_LOG_WARNING(@"%@: Could not create cache entry %@", self, tempPath);
+			return;
+		}
+		bool written = 1 == fwrite(&header, sizeof(header), 1, file) &&
+			header.dataSize == fwrite(audioData.bytes, 1, (size_t)header.dataSize, file);
+		written = 0 == fclose(file) && written;
+		if(!written || 0 != rename([tempPath fileSystemRepresentation], [path fileSystemRepresentation]))
+		{
+			OAL_LOG_WARNING(@"%@: Could not write cache entry %@", self, path);
+			remove([tempPath fileSystemRepresentation]);
+			return;
+		}
+
+		[self trimToSize:maxSize];
+	}
+}
+
+
+#pragma mark Maintenance
+
+- (void) trimToSize:(unsigned long long) size
+{
+	@synchronized(self)
+	{
+		NSFileManager* fileManager = [NSFileManager defaultManager];
+		NSMutableArray* entries = [NSMutableArray array];
+		unsigned long long total = 0;
+		for(NSString* file in [fileManager contentsOfDirectoryAtPath:directory error:nil])
+		{
+			if(![[file pathExtension] isEqualToString:kEntryExtension])
+			{
+				continue;
+			}
+			NSString* path = [directory stringByAppendingPathComponent:file];
+			NSDictionary* attributes = [fileManager attributesOfItemAtPath:path error:nil];
+			if(nil == attributes)
+			{
+				continue;
+			}
+			total += [attributes fileSize];
+			[entries addObject:[NSArray arrayWithObjects:
+								[attributes fileModificationDate],
+								path,
+								[NSNumber numberWithUnsignedLongLong:[attributes fileSize]],
+								nil]];
+		}
+
+		if(total <= size)
+		{
+			return;
+		}
+
+		[entries sortUsingFunction:compareEntryDates context:nil];
+		for(NSArray* entry in entries)
+		{
+			if(total <= size)
+			{
+				break;
+			}
+			OAL_LOG_DEBUG(@"%@: Evicting %@", self, [entry objectAtIndex:1]);
+			if([fileManager removeItemAtPath:[entry objectAtIndex:1] error:nil])
+			{
+				total -= [[entry objectAtIndex:2] unsignedLongLongValue];
+			}
+		}
+	}
+}
+
+- (void) removeAllEntries
+{
+	[self trimToSize:0];
+}
+
+@end
@@ -0,0 +1,255 @@
+//
+//  OALLoadTelemetry.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+#import <Foundation/Foundation.h>
+#import "SynthesizeSingleton.h"
+
+
+/** Whether a load used OALDecodedAudioCache. */
+typedef enum
+{
+	/** The cache was disabled, or the file couldn't be cached. */
+	kOALLoadCacheNotUsed,
+	/** The decoded audio came from the cache. */
+	kOALLoadCacheHit,
+	/** The file was decoded and stored in the cache. */
+	kOALLoadCacheMiss,
+} OALLoadCacheResult;
+
+/** The stages of a load that are timed separately. */
+typedef enum
+{
+	/** Opening the file and probing its format (and hashing it, when using OALDecodedAudioCache). */
+	kOALLoadStageOpen,
+	/** Reading and decoding the audio data. */
+	kOALLoadStageDecode,
+	/** Sample rate conversion. */
+	kOALLoadStageConversion,
+	/** Handing the data to OpenAL. */
+	kOALLoadStageUpload,
+} OALLoadStage;
+
+
+#pragma mark OALLoadRecord
+
+/**
+ * Timings and sizes of one audio file load (see OALLoadTelemetry).
+ * All times are in seconds.
+ */
+@interface OALLoadRecord : NSObject
+{
+	NSString* url;
+	NSTimeInterval timestamp;
+	unsigned int threadID;
+	bool mainThread;
+	uint64_t startTicks;
+	uint64_t endTicks;
+	uint64_t stageTicks[kOALLoadStageUpload + 1];
+	unsigned long long bytesIn;
+	unsigned long long bytesOut;
+	OALLoadCacheResult cacheResult;
+}
+
+/** The URL of the file that was loaded. */
+@property(nonatomic,readonly,retain) NSString* url;
+
+/** When the load started (seconds since the reference date, as NSDate uses). */
+@property(nonatomic,readonly,assign) NSTimeInterval timestamp;
+
+/** The Mach thread ID of the thread that decoded the file. */
+@property(nonatomic,readonly,assign) unsigned int threadID;
+
+/** If YES, the file was decoded on the main thread. */
+@property(nonatomic,readonly,assign) bool mainThread;
+
+/** Time spent opening the file and probing its format
+ * (and hashing it, when using OALDecodedAudioCache).
+ */
+@property(nonatomic,readonly,assign) NSTimeInterval openTime;
+
+/** Time spent reading and decoding audio data. */
+@property(nonatomic,readonly,assign) NSTimeInterval decodeTime;
+
+/** Time spent on sample rate conversion. */
+@property(nonatomic,readonly,assign) NSTimeInterval conversionTime;
+
+/** Time spent handing the data to OpenAL. */
+@property(nonatomic,readonly,assign) NSTimeInterval uploadTime;
+
+/** Time from the start of the load to the end, including anything not covered by
+ * the other times (such as hashing, cache lookups and waiting between threads).
+ */
+@property(nonatomic,readonly,assign) NSTimeInterval totalTime;
+
+/** The size of the source file in bytes (or of the cache entry, on a cache hit). */
+@property(nonatomic,readwrite,assign) unsigned long long bytesIn;
+
+/** The size of the decoded audio data in bytes. */
+@property(nonatomic,readwrite,assign) unsigned long long bytesOut;
+
+/** Decoded bytes produced per second of decoding and conversion (0 if not decoded). */
+@property(nonatomic,readonly,assign) double decodeThroughput;
+
+/** Whether the load used OALDecodedAudioCache. */
+@property(nonatomic,readwrite,assign) OALLoadCacheResult cacheResult;
+
+/** This record as a dictionary of JSON compatible values. */
+@property(nonatomic,readonly,retain) NSDictionary* dictionaryRepresentation;
+
+/** \cond */
+/** (INTERNAL USE) Get the record of the load in progress on the calling thread.
+ *
+ * @return The record, or nil if no load is being recorded.
+ */
++ (OALLoadRecord*) currentRecord;
+
+/** (INTERNAL USE) Add time to one stage of this load.
+ *
+ * @param startTicks The value of mach_absolute_time() when the stage began.
+ * @param stage The stage.
+ */
+- (void) addTimeSince:(uint64_t) startTicks toStage:(OALLoadStage) stage;
+/** \endcond */
+
+@end
+
+
+#pragma mark -
+#pragma mark OALLoadTelemetry
+
+/**
+ * Records how long each audio file loaded through OpenALManager or OALSimpleAudio
+ * took to open, decode, convert and hand to OpenAL. <br>
+ *
+ * Recording costs a few timer reads and one small object per file, so it can be
+ * left on in release builds. Only the most recent maxRecords loads are kept.
+ */
+@interface OALLoadTelemetry : NSObject
+{
+	bool enabled;
+	NSUInteger maxRecords;
+	/** Finished records, oldest first. */
+	NSMutableArray* records;
+}
+
+
+#pragma mark Properties
+
+/** If YES, loads are recorded (default YES). */
+@property(nonatomic,readwrite,assign) bool enabled;
+
+/** The most records to keep (default 256). When more loads finish, the oldest
+ * records are discarded.
+ */
+@property(nonatomic,readwrite,assign) NSUInteger maxRecords;
+
+/** All kept records (OALLoadRecord), oldest first. */
+@property(nonatomic,readonly,retain) NSArray* records;
+
+
+#pragma mark Object Management
+
+/** Singleton implementation providing "sharedInstance" and "purgeSharedInstance" methods.
+ *
+ * <b>- (OALLoadTelemetry*) sharedInstance</b>: Get the shared singleton instance. <br>
+ * <b>- (void) purgeSharedInstance</b>: Purge (deallocate) the shared instance.
+ */
+SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALLoadTelemetry);
+
+
+#pragma mark Queries
+
+/** Get the records of every kept load of a URL.
+ *
+ * @param url The URL.
+ * @return The records (OALLoadRecord), oldest first.
+ */
+- (NSArray*) recordsForUrl:(NSURL*) url;
+
+/** Get the records of the loads that took the longest.
+ *
+ * @param count The most records to return.
+ * @return The records (OALLoadRecord), longest totalTime first.
+ */
+- (NSArray*) slowestRecords:(NSUInteger) count;
+
+/** Discard all records. */
+- (void) clearRecords;
+
+
+#pragma mark Export
+
+/** All kept records as JSON: an array of objects, oldest first.
+ *
+ * @return The JSON data (UTF-8).
+ */
+- (NSData*) JSONData;
+
+/** Write all kept records to a file as JSON (see JSONData).
+ *
+ * @param path The path of the file to write.
+ * @return YES if the file was written.
+ */
+- (bool) writeJSONToFile:(NSString*) path;
+
+
+#pragma mark Internal Use
+
+/** \cond */
+/** (INTERNAL USE) Start recording a load on the calling thread.
+ * Nested loads (such as a preload that calls bufferFromUrl:) belong to the outermost record.
+ *
+ * @param url The URL being loaded.
+ * @return A new record, or nil if recording is disabled or this thread is already recording.
+ */
+- (OALLoadRecord*) beginRecordForUrl:(NSURL*) url;
+
+/** (INTERNAL USE) Finish recording a load and keep the record.
+ *
+ * @param record The record returned by beginRecordForUrl: (may be nil).
+ */
+- (void) endRecord:(OALLoadRecord*) record;
+
+/** (INTERNAL USE) Stop recording on the calling thread without finishing,
+ * so that the load can be continued on another thread with resumeRecord:.
+ *
+ * @param record The record (may be nil).
+ */
+- (void) suspendRecord:(OALLoadRecord*) record;
+
+/** (INTERNAL USE) Continue recording a suspended load on the calling thread.
+ *
+ * @param record The record (may be nil).
+ */
+- (void) resumeRecord:(OALLoadRecord*) record;
+/** \endcond */
+
+@end
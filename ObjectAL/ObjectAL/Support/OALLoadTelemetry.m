@@ -0,0 +1,396 @@
+//
+//  OALLoadTelemetry.m
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+#import "OALLoadTelemetry.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+#import "mach_timing.h"
+#import <pthread.h>
+
+
+/** By default, keep the records of the last 256 loads. */
+#define kDefaultMaxRecords 256
+
+
+/** Holds the record of the load in progress on each thread. It is not retained. */
+static pthread_key_t currentRecordKey;
+static pthread_once_t currentRecordKeyOnce = PTHREAD_ONCE_INIT;
+
+static void createCurrentRecordKey(void)
+{
+	pthread_key_create(&currentRecordKey, NULL);
+}
+
+static void setCurrentRecord(OALLoadRecord* record)
+{
+	pthread_once(&currentRecordKeyOnce, createCurrentRecordKey);
+	pthread_setspecific(currentRecordKey, (as_bridge void*)record);
+}
+
+/** Orders records from longest to shortest total time. */
+static NSInteger compareTotalTimes(id first, id second, void* context)
+{
+	#pragma unused(context)
+	NSTimeInterval firstTime = [(OALLoadRecord*)first totalTime];
+	NSTimeInterval secondTime = [(OALLoadRecord*)second totalTime];
+	if(firstTime > secondTime)
+	{
+		return NSOrderedAscending;
+	}
+	return firstTime < secondTime ? NSOrderedDescending : NSOrderedSame;
+}
+
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for OALLoadRecord.
+ */
+@interface OALLoadRecord (Private)
+
+/** (INTERNAL USE) Initialize a record for a load starting now on the calling thread.
+ *
+ * @param url The URL being loaded.
+ * @return The initialized record.
+ */
+- (id) initWithUrl:(NSURL*) url;
+
+/** (INTERNAL USE) Mark the end of the load. */
+- (void) finish;
+
+@end
+/** \endcond */
+
+
+#pragma mark -
+#pragma mark OALLoadRecord
+
+@implementation OALLoadRecord
+
++ (OALLoadRecord*) currentRecord
+{
+	pthread_once(&currentRecordKeyOnce, createCurrentRecordKey);
+	return (as_bridge OALLoadRecord*)pthread_getspecific(currentRecordKey);
+}
+
+- (id) initWithUrl:(NSURL*) urlIn
+{
+	if(nil != (self = [super init]))
+	{
+		url = as_retain([urlIn description]);
+		timestamp = [NSDate timeIntervalSinceReferenceDate];
+		threadID = pthread_mach_thread_np(pthread_self());
+		mainThread = [NSThread isMainThread];
+		startTicks = mach_absolute_time();
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	as_release(url);
+	as_superdealloc();
+}
+
+- (NSString*) description
+{
+	return [NSString stringWithFormat:@"<%@: %p: %@ (%.3fs)>", [self class], self, [url lastPathComponent], self.totalTime];
+}
+
+- (void) addTimeSince:(uint64_t) ticks toStage:(OALLoadStage) stage
+{
+	stageTicks[stage] += mach_absolute_time() - ticks;
+}
+
+- (void) finish
+{
+	endTicks = mach_absolute_time();
+}
+
+@synthesize url;
+@synthesize timestamp;
+@synthesize threadID;
+@synthesize mainThread;
+@synthesize bytesIn;
+@synthesize bytesOut;
+@synthesize cacheResult;
+
+- (NSTimeInterval) openTime
+{
+	return mach_absolute_difference_seconds(stageTicks[kOALLoadStageOpen], 0);
+}
+
+- (NSTimeInterval) decodeTime
+{
+	return mach_absolute_difference_seconds(stageTicks[kOALLoadStageDecode], 0);
+}
+
+- (NSTimeInterval) conversionTime
+{
+	return mach_absolute_difference_seconds(stageTicks[kOALLoadStageConversion], 0);
+}
+
+- (NSTimeInterval) uploadTime
+{
+	return mach_absolute_difference_seconds(stageTicks[kOALLoadStageUpload], 0);
+}
+
+- (NSTimeInterval) totalTime
+{
+	return 0 == endTicks ? 0 : mach_absolute_difference_seconds(endTicks, startTicks);
+}
+
+- (double) decodeThroughput
+{
+	NSTimeInterval time = self.decodeTime + self.conversionTime;
+	return time > 0 ? (double)bytesOut / time : 0;
+}
+
+- (NSDictionary*) dictionaryRepresentation
+{
+	NSString* cacheName = @"unused";
+	if(kOALLoadCacheHit == cacheResult)
+	{
+		cacheName = @"hit";
+	}
+	else if(kOALLoadCacheMiss == cacheResult)
+	{
+		cacheName = @"miss";
+	}
+
+	return [NSDictionary dictionaryWithObjectsAndKeys:
+			url, @"url",
+			[NSNumber numberWithDouble:timestamp], @"timestamp",
+			[NSNumber numberWithUnsignedInt:threadID], @"thread",
+			[NSNumber numberWithBool:mainThread], @"mainThread",
+			[NSNumber numberWithDouble:self.openTime], @"openTime",
+			[NSNumber numberWithDouble:self.decodeTime], @"decodeTime",
+			[NSNumber numberWithDouble:self.conversionTime], @"conversionTime",
+			[NSNumber numberWithDouble:self.uploadTime], @"uploadTime",
+			[NSNumber numberWithDouble:self.totalTime], @"totalTime",
+			[NSNumber numberWithUnsignedLongLong:bytesIn], @"bytesIn",
+			[NSNumber numberWithUnsignedLongLong:bytesOut], @"bytesOut",
+			[NSNumber numberWithDouble:self.decodeThroughput], @"decodeThroughput",
+			cacheName, @"cache",
+			nil];
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OALLoadTelemetry
+
+@implementation OALLoadTelemetry
+
+#pragma mark Object Management
+
+SYNTHESIZE_SINGLETON_FOR_CLASS(OALLoadTelemetry);
+
+- (id) init
+{
+	if(nil != (self = [super init]))
+	{
+		OAL_LOG_DEBUG(@"%@: Init", self);
+		enabled = YES;
+		maxRecords = kDefaultMaxRecords;
+		records = [[NSMutableArray alloc] initWithCapacity:kDefaultMaxRecords];
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	OAL_LOG_DEBUG(@"%@: Dealloc", self);
+	as_release(records);
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+@synthesize enabled;
+
+- (NSUInteger) maxRecords
+{
+	// Must always be synchronized
+	@synchronized(records)
+	{
+		return maxRecords;
+	}
+}
+
+- (void) setMaxRecords:(NSUInteger) value
+{
+	// Must always be synchronized
+	@synchronized(records)
+	{
+		maxRecords = value;
+		if([records count] > maxRecords)
+		{
+			[records removeObjectsInRange:NSMakeRange(0, [records count] - maxRecords)];
+		}
+	}
+}
+
+- (NSArray*) records
+{
+	// Must always be synchronized
+	@synchronized(records)
+	{
+		return [NSArray arrayWithArray:records];
+	}
+}
+
+
+#pragma mark Queries
+
+- (NSArray*) recordsForUrl:(NSURL*) url
+{
+	NSString* urlString = [url description];
+	NSMutableArray* matches = [NSMutableArray array];
+	for(OALLoadRecord* record in self.records)
+	{
+		if([record.url isEqualToString:urlString])
+		{
+			[matches addObject:record];
+		}
+	}
+	return matches;
+}
+
+- (NSArray*) slowestRecords:(NSUInteger) count
+{
+	NSArray* sorted = [self.records sortedArrayUsingFunction:compareTotalTimes context:nil];
+	if([sorted count] > count)
+	{
+		sorted = [sorted subarrayWithRange:NSMakeRange(0, count)];
+	}
+	return sorted;
+}
+
+- (void) clearRecords
+{
+	// Must always be synchronized
+	@synchronized(records)
+	{
+		[records removeAllObjects];
+	}
+}
+
+
+#pragma mark Export
+
+- (NSData*) JSONData
+{
+	NSArray* allRecords = self.records;
+	NSMutableArray* dictionaries = [NSMutableArray arrayWithCapacity:[allRecords count]];
+	for(OALLoadRecord* record in allRecords)
+	{
+		[dictionaries addObject:record.dictionaryRepresentation];
+	}
+
+	NSError* error = nil;
+	NSData* data = [NSJSONSerialization dataWithJSONObject:dictionaries options:0 error:&error];
+	if(nil == data)
+	{
+		OAL_LOG_ERROR(@"%@: Could not convert records to JSON: %@", self, error);
+	}
+	return data;
+}
+
+- (bool) writeJSONToFile:(NSString*) path
+{
+	NSData* data = [self JSONData];
+	if(nil == data || ![data writeToFile:path atomically:YES])
+	{
+		OAL_LOG_ERROR(@"%@: Could not write records to %@", self, path);
+		return NO;
+	}
+	return YES;
+}
+
+
+#pragma mark Internal Use
+
+- (OALLoadRecord*) beginRecordForUrl:(NSURL*) url
+{
+	if(!enabled || nil != [OALLoadRecord currentRecord])
+	{
+		return nil;
+	}
+	OALLoadRecord* record = as_autorelease([[OALLoadRecord alloc] initWithUrl:url]);
+	setCurrentRecord(record);
+	return record;
+}
+
+- (void) endRecord:(OALLoadRecord*) record
+{
+	if(nil == record)
+	{
+		return;
+	}
+	if(record == [OALLoadRecord currentRecord])
+	{
+		setCurrentRecord(nil);
+	}
+	[record finish];
+
+	// Must always be synchronized
+	@synchronized(records)
+	{
+		if(maxRecords > 0)
+		{
+			if([records count] >= maxRecords)
+			{
+				[records removeObjectAtIndex:0];
+			}
+			[records addObject:record];
+		}
+	}
+}
+
+- (void) suspendRecord:(OALLoadRecord*) record
+{
+	if(nil != record && record == [OALLoadRecord currentRecord])
+	{
+		setCurrentRecord(nil);
+	}
+}
+
+- (void) resumeRecord:(OALLoadRecord*) record
+{
+	if(nil != record && nil == [OALLoadRecord currentRecord])
+	{
+		setCurrentRecord(record);
+	}
+}
+
+@end
@@ -0,0 +1,180 @@
+//
+//  OALPreloadManifest.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+#import <Foundation/Foundation.h>
+
+
+/** How a manifest wants an effect held in memory. */
+typedef enum
+{
+	/** Decoded and ready to play, unless that would exceed the memory budget. */
+	kOALManifestResidencyPCM,
+	/** Held as IMA ADPCM (see kOALEffectResidencyADPCM). */
+	kOALManifestResidencyCompressed,
+	/** Not preloaded. The effect is meant to be streamed from its file when played. */
+	kOALManifestResidencyStreamed,
+} OALManifestResidency;
+
+
+#pragma mark OALPreloadManifestEntry
+
+/**
+ * A sound effect listed in an OALPreloadManifest.
+ */
+@interface OALPreloadManifestEntry : NSObject
+{
+	NSString* path;
+	NSInteger priority;
+	OALManifestResidency residency;
+	bool reduceToMono;
+	NSArray* groups;
+}
+
+/** The path of the file containing the sound data. */
+@property(nonatomic,readonly,retain) NSString* path;
+
+/** Effects with higher priority are loaded first, and are the last to be left
+ * compressed or deferred when memory runs short.
+ */
+@property(nonatomic,readonly,assign) NSInteger priority;
+
+/** How the effect should be held in memory. */
+@property(nonatomic,readonly,assign) OALManifestResidency residency;
+
+/** If YES, reduce the sample to mono
+ * (stereo samples don't support panning or positional audio).
+ */
+@property(nonatomic,readonly,assign) bool reduceToMono;
+
+/** The names of the groups this effect belongs to (NSString). */
+@property(nonatomic,readonly,retain) NSArray* groups;
+
+/** Make a new entry.
+ *
+ * @param path The path of the file containing the sound data.
+ * @param priority Effects with higher priority are loaded first.
+ * @param residency How the effect should be held in memory.
+ * @param reduceToMono If YES, reduce the sample to mono.
+ * @param groups The names of the groups this effect belongs to (NSString).
+ * @return A new entry.
+ */
++ (OALPreloadManifestEntry*) entryWithPath:(NSString*) path
+								  priority:(NSInteger) priority
+								 residency:(OALManifestResidency) residency
+							  reduceToMono:(bool) reduceToMono
+									groups:(NSArray*) groups;
+
+/** Initialize an entry.
+ *
+ * @param path The path of the file containing the sound data.
+ * @param priority Effects with higher priority are loaded first.
+ * @param residency How the effect should be held in memory.
+ * @param reduceToMono If YES, reduce the sample to mono.
+ * @param groups The names of the groups this effect belongs to (NSString).
+ * @return The initialized entry.
+ */
+- (id) initWithPath:(NSString*) path
+		   priority:(NSInteger) priority
+		  residency:(OALManifestResidency) residency
+	   reduceToMono:(bool) reduceToMono
+			 groups:(NSArray*) groups;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALPreloadManifest
+
+/**
+ * A list of the sound effects an app preloads, sorted into groups
+ * (see [OALSimpleAudio loadManifestGroup:fromManifest:memoryBudget:progressBlock:]). <br>
+ *
+ * Manifests can be loaded from JSON or from a property list (XML or binary),
+ * holding either an array of effects or a dictionary with an "effects" array.
+ * Each effect is a dictionary such as:
+ *
+ *     {"path": "Explosion.caf", "priority": 10, "residency": "compressed",
+ *      "reduceToMono": true, "groups": ["level1", "level2"]}
+ *
+ * Only "path" is required. "priority" defaults to 0, "residency" (one of "pcm",
+ * "compressed" or "streamed") to "pcm", "reduceToMono" to false, and "groups" to none.
+ */
+@interface OALPreloadManifest : NSObject
+{
+	NSArray* entries;
+	NSDictionary* groupEntries;
+}
+
+/** All entries (OALPreloadManifestEntry), highest priority first.
+ * Entries with the same priority keep their order in the manifest.
+ */
+@property(nonatomic,readonly,retain) NSArray* entries;
+
+/** The names of all groups used in this manifest (NSString). */
+@property(nonatomic,readonly,assign) NSArray* groupNames;
+
+/** Load a manifest from a file.
+ *
+ * @param path The path of the manifest file. Relative paths are looked up in the main bundle.
+ * @return A new manifest, or nil on error.
+ */
++ (OALPreloadManifest*) manifestWithContentsOfFile:(NSString*) path;
+
+/** Load a manifest from JSON or property list data.
+ *
+ * @param data The manifest data.
+ * @return A new manifest, or nil on error.
+ */
++ (OALPreloadManifest*) manifestWithData:(NSData*) data;
+
+/** Make a manifest from a list of entries.
+ *
+ * @param entries The entries (OALPreloadManifestEntry).
+ * @return A new manifest.
+ */
++ (OALPreloadManifest*) manifestWithEntries:(NSArray*) entries;
+
+/** Initialize a manifest with a list of entries.
+ *
+ * @param entries The entries (OALPreloadManifestEntry).
+ * @return The initialized manifest.
+ */
+- (id) initWithEntries:(NSArray*) entries;
+
+/** Get the entries that belong to a group. Takes constant time.
+ *
+ * @param group The group name.
+ * @return The group's entries (OALPreloadManifestEntry), highest priority first.
+ *         Empty if there is no such group.
+ */
+- (NSArray*) entriesInGroup:(NSString*) group;
+
+@end
@@ -0,0 +1,270 @@
+//
+//  OALPreloadManifest.m
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+#import "OALPreloadManifest.h"
+#import "ObjectALMacros.h"
+#import "ARCSafe_MemMgmt.h"
+#import "OALTools.h"
+
+
+/** \cond */
+/**
+ * (INTERNAL USE) Private methods for OALPreloadManifest.
+ */
+@interface OALPreloadManifest (Private)
+
+/** (INTERNAL USE) Make an entry from a manifest dictionary.
+ *
+ * @param description The dictionary describing the entry.
+ * @return A new entry, or nil if the dictionary is invalid.
+ */
++ (OALPreloadManifestEntry*) entryFromDescription:(id) description;
+
+@end
+/** \endcond */
+
+
+#pragma mark -
+#pragma mark OALPreloadManifestEntry
+
+@implementation OALPreloadManifestEntry
+
++ (OALPreloadManifestEntry*) entryWithPath:(NSString*) path
+								  priority:(NSInteger) priority
+								 residency:(OALManifestResidency) residency
+							  reduceToMono:(bool) reduceToMono
+									groups:(NSArray*) groups
+{
+	return as_autorelease([[self alloc] initWithPath:path
+											priority:priority
+										   residency:residency
+										reduceToMono:reduceToMono
+											  groups:groups]);
+}
+
+- (id) initWithPath:(NSString*) pathIn
+		   priority:(NSInteger) priorityIn
+		  residency:(OALManifestResidency) residencyIn
+	   reduceToMono:(bool) reduceToMonoIn
+			 groups:(NSArray*) groupsIn
+{
+	if(nil != (self = [super init]))
+	{
+		path = [pathIn copy];
+		priority = priorityIn;
+		residency = residencyIn;
+		reduceToMono = reduceToMonoIn;
+		groups = nil == groupsIn ? [[NSArray alloc] init] : [groupsIn copy];
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	as_release(path);
+	as_release(groups);
+	as_superdealloc();
+}
+
+- (NSString*) description
+{
+	return [NSString stringWithFormat:@"<%@: %p: %@ (priority %ld)>", [self class], self, path, (long)priority];
+}
+
+@synthesize path;
+@synthesize priority;
+@synthesize residency;
+@synthesize reduceToMono;
+@synthesize groups;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALPreloadManifest
+
+@implementation OALPreloadManifest
+
+#pragma mark Object Management
+
++ (OALPreloadManifest*) manifestWithContentsOfFile:(NSString*) path
+{
+	NSURL* url = [OALTools urlForPath:path];
+	NSData* data = nil == url ? nil : [NSData dataWithContentsOfURL:url];
+	if(nil == data)
+	{
+		OAL_LOG_ERROR(@"Could not read manifest %@", path);
+		return nil;
+	}
+	return [self manifestWithData:data];
+}
+
++ (OALPreloadManifest*) manifestWithData:(NSData*) data
+{
+	NSError* error = nil;
+	id contents = [NSPropertyListSerialization propertyListWithData:data
+															options:NSPropertyListImmutable
+															 format:NULL
+															  error:NULL];
+	if(nil == contents)
+	{
+		contents = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
+	}
+	if([contents isKindOfClass:[NSDictionary class]])
+	{
+		contents = [contents objectForKey:@"effects"];
+	}
+	if(![contents isKindOfClass:[NSArray class]])
+	{
+		OAL_LOG_ERROR(@"Manifest is not a list of effects (%@)", error);
+		return nil;
+	}
+
+	NSMutableArray* entries = [NSMutableArray arrayWithCapacity:[contents count]];
+	for(id description in contents)
+	{
+		OALPreloadManifestEntry* entry = [self entryFromDescription:description];
+		if(nil == entry)
+		{
+			OAL_LOG_ERROR(@"Invalid manifest entry: %@", description);
+			return nil;
+		}
+		[entries addObject:entry];
+	}
+	return [self manifestWithEntries:entries];
+}
+
++ (OALPreloadManifest*) manifestWithEntries:(NSArray*) entries
+{
+	return as_autorelease([[self alloc] initWithEntries:entries]);
+}
+
+- (id) initWithEntries:(NSArray*) entriesIn
+{
+	if(nil != (self = [super init]))
+	{
+		// Sort descriptors sort stably, so equal priorities keep their order.
+		NSSortDescriptor* byPriority = [NSSortDescriptor sortDescriptorWithKey:@"priority" ascending:NO];
+		entries = as_retain([entriesIn sortedArrayUsingDescriptors:[NSArray arrayWithObject:byPriority]]);
+
+		// Group each entry up front so that a whole group can be found in one lookup.
+		NSMutableDictionary* groupsIn = [NSMutableDictionary dictionary];
+		for(OALPreloadManifestEntry* entry in entries)
+		{
+			for(NSString* group in entry.groups)
+			{
+				NSMutableArray* groupList = [groupsIn objectForKey:group];
+				if(nil == groupList)
+				{
+					groupList = [NSMutableArray array];
+					[groupsIn setObject:groupList forKey:group];
+				}
+				[groupList addObject:entry];
+			}
+		}
+		groupEntries = [groupsIn copy];
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	as_release(entries);
+	as_release(groupEntries);
+	as_superdealloc();
+}
+
+
+#pragma mark Properties
+
+@synthesize entries;
+
+- (NSArray*) groupNames
+{
+	return [groupEntries allKeys];
+}
+
+
+#pragma mark Groups
+
+- (NSArray*) entriesInGroup:(NSString*) group
+{
+	NSArray* groupList = [groupEntries objectForKey:group];
+	return nil == groupList ? [NSArray array] : groupList;
+}
+
+
+#pragma mark Internal Use
+
++ (OALPreloadManifestEntry*) entryFromDescription:(id) description
+{
+	if(![description isKindOfClass:[NSDictionary class]])
+	{
+		return nil;
+	}
+	NSString* path = [description objectForKey:@"path"];
+	if(![path isKindOfClass:[NSString class]])
+	{
+		return nil;
+	}
+
+	OALManifestResidency residency = kOALManifestResidencyPCM;
+	NSString* residencyName = [description objectForKey:@"residency"];
+	if(nil != residencyName)
+	{
+		if([@"compressed" isEqual:residencyName])
+		{
+			residency = kOALManifestResidencyCompressed;
+		}
+		else if([@"streamed" isEqual:residencyName])
+		{
+			residency = kOALManifestResidencyStreamed;
+		}
+		else if(![@"pcm" isEqual:residencyName])
+		{
+			return nil;
+		}
+	}
+
+	NSArray* groups = [description objectForKey:@"groups"];
+	if(nil != groups && ![groups isKindOfClass:[NSArray class]])
+	{
+		return nil;
+	}
+
+	return [OALPreloadManifestEntry entryWithPath:path
+										 priority:[[description objectForKey:@"priority"] integerValue]
+										residency:residency
+									 reduceToMono:[[description objectForKey:@"reduceToMono"] boolValue]
+										   groups:groups];
+}
+
+@end
@@ -27,3 +27,22 @@ double mach_absolute_difference_seconds(uint64_t endTime, uint64_t startTime)
     
     return conversion * (double)difference;
 }
+
+uint64_t mach_absolute_from_seconds(double seconds)
+{
+    static double conversion = 0.0;
+    
+    if(0 == conversion)
+    {
+        mach_timebase_info_data_t info;
+        kern_return_t errorCode = mach_timebase_info(&info);
+		
+		//Convert seconds into the timebase
+        if(0 == errorCode)
+		{
+			conversion = 1e9 * (double)info.denom / (double)info.numer;
+		}
+    }
+    
+    return (uint64_t)(conversion * seconds);
+}
@@ -16,3 +16,10 @@
  * @return the time difference in seconds.
  */
 double mach_absolute_difference_seconds(uint64_t endTime, uint64_t startTime);
+
+/** Converts a number of seconds into a mach_absolute_time() interval.
+ *
+ * @param seconds the number of seconds.
+ * @return the equivalent interval in mach absolute time units.
+ */
+uint64_t mach_absolute_from_seconds(double seconds);
@@ -0,0 +1,619 @@
+//
+//  oal_adpcm.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+#include "oal_adpcm.h"
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+	#define OAL_ADPCM_X86 1
+	#include <emmintrin.h>
+	#if defined(__GNUC__) || defined(__clang__)
+		#define OAL_ADPCM_AVX2 1
+		#include <immintrin.h>
+	#endif
+#elif defined(__aarch64__) || defined(__arm64__)
+	#define OAL_ADPCM_NEON 1
+	#include <arm_neon.h>
+#endif
+
+
+/** Size of the per channel block header. */
+#define kHeaderSize 4
+
+/** Samples per channel in each 4 byte group of nibbles. */
+#define kGroupFrames 8
+
+#define kMaxIndex 88
+
+/** The number of channel blocks handed to the decode kernel at a time. */
+#define kJobBatch 64
+
+static const int32_t g_step_table[kMaxIndex + 1] =
+{
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+	19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+	50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+	130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+	337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+	876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+	2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+	5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+	15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int32_t g_index_table[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+/** One channel of one block, decoded by a kernel. */
+typedef struct
+{
+	/** The channel's block header. */
+	const uint8_t* header;
+	/** The channel's first group of nibbles. Later groups are every channels * 4 bytes. */
+	const uint8_t* data;
+	/** Where to write the channel's first sample. Later samples are every channels samples. */
+	int16_t* dst;
+} channel_job;
+
+typedef struct
+{
+	const char* name;
+	/** Decode complete blocks. */
+	void (*decode)(const channel_job* jobs, uint32_t count, uint32_t channels, uint32_t frames_per_block);
+} adpcm_kernels;
+
+static adpcm_kernels g_kernels;
+static pthread_once_t g_kernels_once = PTHREAD_ONCE_INIT;
+
+
+// Scalar
+
+static uint32_t read_le32(const uint8_t* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int32_t clamp_sample(int32_t value)
+{
+	return value > 32767 ? 32767 : value < -32768 ? -32768 : value;
+}
+
+static int32_t clamp_index(int32_t value)
+{
+	return value > kMaxIndex ? kMaxIndex : value < 0 ? 0 : value;
+}
+
+static int32_t header_predictor(const uint8_t* header)
+{
+	return (int16_t)(uint16_t)(header[0] | (header[1] << 8));
+}
+
+static int32_t header_index(const uint8_t* header)
+{
+	return clamp_index(header[2]);
+}
+
+static void decode_nibble(uint32_t nibble, int32_t* predictor, int32_t* index)
+{
+	int32_t step = g_step_table[*index];
+	int32_t delta = step >> 3;
+	if(nibble & 4)
+	{
+		delta += step;
+	}
+	if(nibble & 2)
+	{
+		delta += step >> 1;
+	}
+	if(nibble & 1)
+	{
+		delta += step >> 2;
+	}
+	*predictor = clamp_sample(nibble & 8 ? *predictor - delta : *predictor + delta);
+	*index = clamp_index(*index + g_index_table[nibble & 7]);
+}
+
+static uint32_t encode_sample(int32_t sample, int32_t* predictor, int32_t* index)
+{
+	int32_t step = g_step_table[*index];
+	int32_t diff = sample - *predictor;
+	uint32_t nibble = 0;
+	if(diff < 0)
+	{
+		nibble = 8;
+		diff = -diff;
+	}
+	if(diff >= step)
+	{
+		nibble |= 4;
+		diff -= step;
+	}
+	if(diff >= step >> 1)
+	{
+		nibble |= 2;
+		diff -= step >> 1;
+	}
+	if(diff >= step >> 2)
+	{
+		nibble |= 1;
+	}
+	// Track exactly what the decoder will reconstruct.
+	decode_nibble(nibble, predictor, index);
+	return nibble;
+}
+
+/** Decode the first frames of one channel of a block. */
+static void decode_channel(const channel_job* job, uint32_t channels, uint32_t frames)
+{
+	int32_t predictor = header_predictor(job->header);
+	int32_t index = header_index(job->header);
+	int16_t* dst = job->dst;
+	*dst = (int16_t)predictor;
+
+	for(uint32_t i = 1; i < frames; i += kGroupFrames)
+	{
+		uint32_t word = read_le32(job->data + (i - 1) / kGroupFrames * channels * 4);
+		uint32_t end = i + kGroupFrames < frames ? i + kGroupFrames : frames;
+		for(uint32_t j = i; j < end; j++, word >>= 4)
+		{
+			decode_nibble(word & 0xf, &predictor, &index);
+			dst[j * channels] = (int16_t)predictor;
+		}
+	}
+}
+
+static void scalar_decode(const channel_job* jobs, uint32_t count, uint32_t channels, uint32_t frames_per_block)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		decode_channel(&jobs[i], channels, frames_per_block);
+	}
+}
+
+
+// SSE2
+
+#if OAL_ADPCM_X86
+/** Decode 4 channel blocks at once, one per lane. */
+static void sse2_decode4(const channel_job* jobs, uint32_t channels, uint32_t frames_per_block)
+{
+	int32_t indices[4] __attribute__((aligned(16)));
+	int16_t out[kGroupFrames][8] __attribute__((aligned(16)));
+	const size_t stride = channels * 4;
+	const __m128i one = _mm_set1_epi32(1);
+	const __m128i two = _mm_set1_epi32(2);
+	const __m128i four = _mm_set1_epi32(4);
+	const __m128i eight = _mm_set1_epi32(8);
+	const __m128i three = _mm_set1_epi32(3);
+	const __m128i six = _mm_set1_epi32(6);
+	const __m128i seven = _mm_set1_epi32(7);
+	const __m128i nibble_mask = _mm_set1_epi32(0xf);
+	const __m128i max_index = _mm_set1_epi32(kMaxIndex);
+
+	__m128i predictor = _mm_set_epi32(header_predictor(jobs[3].header), header_predictor(jobs[2].header),
+									  header_predictor(jobs[1].header), header_predictor(jobs[0].header));
+	__m128i index = _mm_set_epi32(header_index(jobs[3].header), header_index(jobs[2].header),
+								  header_index(jobs[1].header), header_index(jobs[0].header));
+	for(int lane = 0; lane < 4; lane++)
+	{
+		*jobs[lane].dst = (int16_t)header_predictor(jobs[lane].header);
+	}
+
+	for(uint32_t frame = 1; frame < frames_per_block; frame += kGroupFrames)
+	{
+		size_t offset = (frame - 1) / kGroupFrames * stride;
+		__m128i words = _mm_set_epi32((int32_t)read_le32(jobs[3].data + offset), (int32_t)read_le32(jobs[2].data + offset),
+									  (int32_t)read_le32(jobs[1].data + offset), (int32_t)read_le32(jobs[0].data + offset));
+		for(int k = 0; k < kGroupFrames; k++)
+		{
+			__m128i nibble = _mm_and_si128(words, nibble_mask);
+			words = _mm_srli_epi32(words, 4);
+
+			// SSE2 has no gather, so the step table is read one lane at a time.
+			_mm_store_si128((__m128i*)indices, index);
+			__m128i step = _mm_set_epi32(g_step_table[indices[3]], g_step_table[indices[2]],
+										 g_step_table[indices[1]], g_step_table[indices[0]]);
+
+			__m128i delta = _mm_srai_epi32(step, 3);
+			delta = _mm_add_epi32(delta, _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(nibble, four), four), step));
+			delta = _mm_add_epi32(delta, _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(nibble, two), two),
+													   _mm_srai_epi32(step, 1)));
+			delta = _mm_add_epi32(delta, _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(nibble, one), one),
+													   _mm_srai_epi32(step, 2)));
+			__m128i negative = _mm_cmpeq_epi32(_mm_and_si128(nibble, eight), eight);
+			delta = _mm_sub_epi32(_mm_xor_si128(delta, negative), negative);
+
+			// Clamp to 16 bits by packing with saturation, then sign extend back.
+			__m128i packed = _mm_packs_epi32(_mm_add_epi32(predictor, delta), _mm_setzero_si128());
+			predictor = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+			_mm_storel_epi64((__m128i*)out[k], packed);
+
+			// Index adjustment is -1 for magnitudes 0-3, and (magnitude - 3) * 2 otherwise.
+			__m128i magnitude = _mm_and_si128(nibble, seven);
+			__m128i large = _mm_cmpgt_epi32(magnitude, three);
+			__m128i adjust = _mm_or_si128(_mm_and_si128(large, _mm_sub_epi32(_mm_add_epi32(magnitude, magnitude), six)),
+										  _mm_andnot_si128(large, _mm_set1_epi32(-1)));
+			index = _mm_add_epi32(index, adjust);
+			index = _mm_andnot_si128(_mm_cmpgt_epi32(_mm_setzero_si128(), index), index);
+			__m128i over = _mm_cmpgt_epi32(index, max_index);
+			index = _mm_or_si128(_mm_and_si128(over, max_index), _mm_andnot_si128(over, index));
+		}
+
+		for(int lane = 0; lane < 4; lane++)
+		{
+			int16_t* dst = jobs[lane].dst + frame * channels;
+			for(int k = 0; k < kGroupFrames; k++)
+			{
+				dst[k * channels] = out[k][lane];
+			}
+		}
+	}
+}
+
+static void sse2_decode(const channel_job* jobs, uint32_t count, uint32_t channels, uint32_t frames_per_block)
+{
+	uint32_t i = 0;
+	for(; i + 4 <= count; i += 4)
+	{
+		sse2_decode4(jobs + i, channels, frames_per_block);
+	}
+	scalar_decode(jobs + i, count - i, channels, frames_per_block);
+}
+#endif
+
+
+// AVX2
+
+#if OAL_ADPCM_AVX2
+/** Decode 8 channel blocks at once, one per lane. */
+__attribute__((target("avx2"))) static void avx2_decode8(const channel_job* jobs, uint32_t channels, uint32_t frames_per_block)
+{
+	int16_t out[kGroupFrames][16] __attribute__((aligned(32)));
+	const size_t stride = channels * 4;
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i two = _mm256_set1_epi32(2);
+	const __m256i four = _mm256_set1_epi32(4);
+	const __m256i eight = _mm256_set1_epi32(8);
+	const __m256i three = _mm256_set1_epi32(3);
+	const __m256i six = _mm256_set1_epi32(6);
+	const __m256i seven = _mm256_set1_epi32(7);
+	const __m256i nibble_mask = _mm256_set1_epi32(0xf);
+	const __m256i min_sample = _mm256_set1_epi32(-32768);
+	const __m256i max_sample = _mm256_set1_epi32(32767);
+	const __m256i max_index = _mm256_set1_epi32(kMaxIndex);
+
+	int32_t predictors[8];
+	int32_t indices[8];
+	for(int lane = 0; lane < 8; lane++)
+	{
+		predictors[lane] = header_predictor(jobs[lane].header);
+		indices[lane] = header_index(jobs[lane].header);
+		*jobs[lane].dst = (int16_t)predictors[lane];
+	}
+	__m256i predictor = _mm256_loadu_si256((const __m256i*)predictors);
+	__m256i index = _mm256_loadu_si256((const __m256i*)indices);
+
+	for(uint32_t frame = 1; frame < frames_per_block; frame += kGroupFrames)
+	{
+		size_t offset = (frame - 1) / kGroupFrames * stride;
+		__m256i words = _mm256_set_epi32((int32_t)read_le32(jobs[7].data + offset), (int32_t)read_le32(jobs[6].data + offset),
+										 (int32_t)read_le32(jobs[5].data + offset), (int32_t)read_le32(jobs[4].data + offset),
+										 (int32_t)read_le32(jobs[3].data + offset), (int32_t)read_le32(jobs[2].data + offset),
+										 (int32_t)read_le32(jobs[1].data + offset), (int32_t)read_le32(jobs[0].data + offset));
+		for(int k = 0; k < kGroupFrames; k++)
+		{
+			__m256i nibble = _mm256_and_si256(words, nibble_mask);
+			words = _mm256_srli_epi32(words, 4);
+
+			__m256i step = _mm256_i32gather_epi32(g_step_table, index, 4);
+			__m256i delta = _mm256_srai_epi32(step, 3);
+			delta = _mm256_add_epi32(delta, _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_and_si256(nibble, four), four), step));
+			delta = _mm256_add_epi32(delta, _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_and_si256(nibble, two), two),
+															 _mm256_srai_epi32(step, 1)));
+			delta = _mm256_add_epi32(delta, _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_and_si256(nibble, one), one),
+															 _mm256_srai_epi32(step, 2)));
+			__m256i negative = _mm256_cmpeq_epi32(_mm256_and_si256(nibble, eight), eight);
+			delta = _mm256_sub_epi32(_mm256_xor_si256(delta, negative), negative);
+			predictor = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(predictor, delta), min_sample), max_sample);
+
+			// Packing works within 128-bit halves, so lanes come out as 0-3, -, 4-7, -.
+			__m256i packed = _mm256_packs_epi32(predictor, _mm256_setzero_si256());
+			packed = _mm256_permute4x64_epi64(packed, 0x08);
+			_mm_store_si128((__m128i*)out[k], _mm256_castsi256_si128(packed));
+
+			__m256i magnitude = _mm256_and_si256(nibble, seven);
+			__m256i large = _mm256_cmpgt_epi32(magnitude, three);
+			__m256i adjust = _mm256_blendv_epi8(_mm256_set1_epi32(-1),
+												_mm256_sub_epi32(_mm256_add_epi32(magnitude, magnitude), six),
+												large);
+			index = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(index, adjust), _mm256_setzero_si256()), max_index);
+		}
+
+		for(int lane = 0; lane < 8; lane++)
+		{
+			int16_t* dst = jobs[lane].dst + frame * channels;
+			for(int k = 0; k < kGroupFrames; k++)
+			{
+				dst[k * channels] = out[k][lane];
+			}
+		}
+	}
+}
+
+__attribute__((target("avx2"))) static void avx2_decode(const channel_job* jobs, uint32_t count, uint32_t channels, uint32_t frames_per_block)
+{
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		avx2_decode8(jobs + i, channels, frames_per_block);
+	}
+	sse2_decode(jobs + i, count - i, channels, frames_per_block);
+}
+#endif
+
+
+// NEON
+
+#if OAL_ADPCM_NEON
+/** Decode 4 channel blocks at once, one per lane. */
+static void neon_decode4(const channel_job* jobs, uint32_t channels, uint32_t frames_per_block)
+{
+	int32_t lanes[4];
+	int16_t out[kGroupFrames][4];
+	const size_t stride = channels * 4;
+	const int32x4_t min_sample = vdupq_n_s32(-32768);
+	const int32x4_t max_sample = vdupq_n_s32(32767);
+	const int32x4_t max_index = vdupq_n_s32(kMaxIndex);
+	const int32x4_t zero = vdupq_n_s32(0);
+
+	for(int lane = 0; lane < 4; lane++)
+	{
+		lanes[lane] = header_predictor(jobs[lane].header);
+		*jobs[lane].dst = (int16_t)lanes[lane];
+	}
+	int32x4_t predictor = vld1q_s32(lanes);
+	for(int lane = 0; lane < 4; lane++)
+	{
+		lanes[lane] = header_index(jobs[lane].header);
+	}
+	int32x4_t index = vld1q_s32(lanes);
+
+	for(uint32_t frame = 1; frame < frames_per_block; frame += kGroupFrames)
+	{
+		size_t offset = (frame - 1) / kGroupFrames * stride;
+		for(int lane = 0; lane < 4; lane++)
+		{
+			lanes[lane] = (int32_t)read_le32(jobs[lane].data + offset);
+		}
+		uint32x4_t words = vreinterpretq_u32_s32(vld1q_s32(lanes));
+		for(int k = 0; k < kGroupFrames; k++)
+		{
+			int32x4_t nibble = vreinterpretq_s32_u32(vandq_u32(words, vdupq_n_u32(0xf)));
+			words = vshrq_n_u32(words, 4);
+
+			// NEON has no gather, so the step table is read one lane at a time.
+			vst1q_s32(lanes, index);
+			int32x4_t step = vdupq_n_s32(g_step_table[lanes[0]]);
+			step = vsetq_lane_s32(g_step_table[lanes[1]], step, 1);
+			step = vsetq_lane_s32(g_step_table[lanes[2]], step, 2);
+			step = vsetq_lane_s32(g_step_table[lanes[3]], step, 3);
+
+			int32x4_t delta = vshrq_n_s32(step, 3);
+			delta = vaddq_s32(delta, vandq_s32(vreinterpretq_s32_u32(vtstq_s32(nibble, vdupq_n_s32(4))), step));
+			delta = vaddq_s32(delta, vandq_s32(vreinterpretq_s32_u32(vtstq_s32(nibble, vdupq_n_s32(2))),
+											   vshrq_n_s32(step, 1)));
+			delta = vaddq_s32(delta, vandq_s32(vreinterpretq_s32_u32(vtstq_s32(nibble, vdupq_n_s32(1))),
+											   vshrq_n_s32(step, 2)));
+			uint32x4_t negative = vtstq_s32(nibble, vdupq_n_s32(8));
+			delta = vbslq_s32(negative, vnegq_s32(delta), delta);
+			predictor = vminq_s32(vmaxq_s32(vaddq_s32(predictor, delta), min_sample), max_sample);
+			vst1_s16(out[k], vmovn_s32(predictor));
+
+			int32x4_t magnitude = vandq_s32(nibble, vdupq_n_s32(7));
+			uint32x4_t large = vcgtq_s32(magnitude, vdupq_n_s32(3));
+			int32x4_t adjust = vbslq_s32(large, vsubq_s32(vaddq_s32(magnitude, magnitude), vdupq_n_s32(6)), vdupq_n_s32(-1));
+			index = vminq_s32(vmaxq_s32(vaddq_s32(index, adjust), zero), max_index);
+		}
+
+		for(int lane = 0; lane < 4; lane++)
+		{
+			int16_t* dst = jobs[lane].dst + frame * channels;
+			for(int k = 0; k < kGroupFrames; k++)
+			{
+				dst[k * channels] = out[k][lane];
+			}
+		}
+	}
+}
+
+static void neon_decode(const channel_job* jobs, uint32_t count, uint32_t channels, uint32_t frames_per_block)
+{
+	uint32_t i = 0;
+	for(; i + 4 <= count; i += 4)
+	{
+		neon_decode4(jobs + i, channels, frames_per_block);
+	}
+	scalar_decode(jobs + i, count - i, channels, frames_per_block);
+}
+#endif
+
+static void select_kernels(void)
+{
+	g_kernels = (adpcm_kernels){"scalar", scalar_decode};
+#if OAL_ADPCM_X86
+	g_kernels = (adpcm_kernels){"sse2", sse2_decode};
+#endif
+#if OAL_ADPCM_AVX2
+	if(__builtin_cpu_supports("avx2"))
+	{
+		g_kernels = (adpcm_kernels){"avx2", avx2_decode};
+	}
+#endif
+#if OAL_ADPCM_NEON
+	g_kernels = (adpcm_kernels){"neon", neon_decode};
+#endif
+}
+
+static const adpcm_kernels* kernels(void)
+{
+	pthread_once(&g_kernels_once, select_kernels);
+	return &g_kernels;
+}
+
+
+// API
+
+size_t oal_adpcm_ima_block_size(uint32_t channels, uint32_t frames_per_block)
+{
+	if(frames_per_block < 1 + kGroupFrames || 0 != (frames_per_block - 1) % kGroupFrames)
+	{
+		return 0;
+	}
+	return (size_t)channels * (kHeaderSize + (frames_per_block - 1) / 2);
+}
+
+size_t oal_adpcm_ima_encoded_size(uint32_t channels, uint32_t frames, uint32_t frames_per_block)
+{
+	size_t block_size = oal_adpcm_ima_block_size(channels, frames_per_block);
+	if(0 == block_size)
+	{
+		return 0;
+	}
+	return ((size_t)frames + frames_per_block - 1) / frames_per_block * block_size;
+}
+
+void oal_adpcm_ima_encode(const int16_t* src,
+						  uint32_t channels,
+						  uint32_t frames,
+						  uint32_t frames_per_block,
+						  uint8_t* dst)
+{
+	size_t block_size = oal_adpcm_ima_block_size(channels, frames_per_block);
+	if(0 == block_size || channels > 8)
+	{
+		return;
+	}
+
+	// The step index carries over from block to block so that each block starts well adapted.
+	int32_t indices[8] = {0};
+	int32_t predictors[8];
+
+	for(uint32_t start = 0; start < frames; start += frames_per_block, dst += block_size)
+	{
+		uint32_t block_frames = frames - start < frames_per_block ? frames - start : frames_per_block;
+		const int16_t* block = src + (size_t)start * channels;
+
+		for(uint32_t ch = 0; ch < channels; ch++)
+		{
+			uint8_t* header = dst + ch * kHeaderSize;
+			predictors[ch] = block[ch];
+			header[0] = (uint8_t)(predictors[ch] & 0xff);
+			header[1] = (uint8_t)((predictors[ch] >> 8) & 0xff);
+			header[2] = (uint8_t)indices[ch];
+			header[3] = 0;
+		}
+
+		uint8_t* data = dst + channels * kHeaderSize;
+		for(uint32_t frame = 1; frame < frames_per_block; frame += kGroupFrames)
+		{
+			for(uint32_t ch = 0; ch < channels; ch++, data += 4)
+			{
+				uint32_t word = 0;
+				for(uint32_t k = 0; k < kGroupFrames; k++)
+				{
+					// Pad the last block with silence.
+					int32_t sample = frame + k < block_frames ? block[(size_t)(frame + k) * channels + ch] : 0;
+					word |= encode_sample(sample, &predictors[ch], &indices[ch]) << (k * 4);
+				}
+				data[0] = (uint8_t)word;
+				data[1] = (uint8_t)(word >> 8);
+				data[2] = (uint8_t)(word >> 16);
+				data[3] = (uint8_t)(word >> 24);
+			}
+		}
+	}
+}
+
+void oal_adpcm_ima_decode(const uint8_t* src,
+						  uint32_t channels,
+						  uint32_t frames,
+						  uint32_t frames_per_block,
+						  int16_t* dst)
+{
+	size_t block_size = oal_adpcm_ima_block_size(channels, frames_per_block);
+	if(0 == block_size)
+	{
+		return;
+	}
+
+	const adpcm_kernels* k = kernels();
+	channel_job jobs[kJobBatch];
+	uint32_t count = 0;
+	uint32_t full_blocks = frames / frames_per_block;
+
+	for(uint32_t block = 0; block < full_blocks; block++)
+	{
+		const uint8_t* block_src = src + block * block_size;
+		for(uint32_t ch = 0; ch < channels; ch++)
+		{
+			jobs[count].header = block_src + ch * kHeaderSize;
+			jobs[count].data = block_src + (channels + ch) * kHeaderSize;
+			jobs[count].dst = dst + (size_t)block * frames_per_block * channels + ch;
+			if(++count == kJobBatch)
+			{
+				k->decode(jobs, count, channels, frames_per_block);
+				count = 0;
+			}
+		}
+	}
+	k->decode(jobs, count, channels, frames_per_block);
+
+	uint32_t remaining = frames - full_blocks * frames_per_block;
+	if(remaining > 0)
+	{
+		const uint8_t* block_src = src + full_blocks * block_size;
+		for(uint32_t ch = 0; ch < channels; ch++)
+		{
+			channel_job job =
+			{
+				block_src + ch * kHeaderSize,
+				block_src + (channels + ch) * kHeaderSize,
+				dst + (size_t)full_blocks * frames_per_block * channels + ch
+			};
+			decode_channel(&job, channels, remaining);
+		}
+	}
+}
+
+const char* oal_adpcm_isa(void)
+{
+	return kernels()->name;
+}
@@ -0,0 +1,103 @@
+//
+//  oal_adpcm.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+/* IMA ADPCM encoding and decoding.
+ *
+ * Data is laid out in the Microsoft IMA ADPCM block format, which is also what
+ * OpenAL's AL_EXT_IMA4 extension plays. Each block starts with a 4 byte header per
+ * channel (the first sample and the step index), followed by groups of 8 samples
+ * per channel packed 4 bits each. A block therefore holds 1 + 8n frames, and
+ * stores 16-bit audio in a little over a quarter of the space.
+ *
+ * Blocks decode independently of each other, so the decoder works on several
+ * blocks at once using SSE2, AVX2 (x86) or NEON (arm64) where available.
+ * All implementations produce identical results.
+ */
+
+#ifndef OAL_ADPCM_H
+#define OAL_ADPCM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The size in bytes of one IMA ADPCM block.
+ *
+ * @param channels The number of interleaved channels.
+ * @param frames_per_block The number of frames in a block (1 + a multiple of 8).
+ * @return The block size, or 0 if frames_per_block is not valid.
+ */
+size_t oal_adpcm_ima_block_size(uint32_t channels, uint32_t frames_per_block);
+
+/** The size in bytes needed to encode a number of frames.
+ * The last block is padded out with silence.
+ */
+size_t oal_adpcm_ima_encoded_size(uint32_t channels, uint32_t frames, uint32_t frames_per_block);
+
+/** Encode 16-bit audio as IMA ADPCM.
+ *
+ * @param src Interleaved native endian samples (frames * channels).
+ * @param channels The number of interleaved channels (1 to 8).
+ * @param frames The number of frames.
+ * @param frames_per_block The number of frames in a block (1 + a multiple of 8).
+ * @param dst Where to write the encoded data (oal_adpcm_ima_encoded_size() bytes).
+ */
+void oal_adpcm_ima_encode(const int16_t* src,
+						  uint32_t channels,
+						  uint32_t frames,
+						  uint32_t frames_per_block,
+						  uint8_t* dst);
+
+/** Decode IMA ADPCM to 16-bit audio.
+ *
+ * @param src The encoded data.
+ * @param channels The number of interleaved channels.
+ * @param frames The number of frames to decode.
+ * @param frames_per_block The number of frames in a block (as used for encoding).
+ * @param dst Where to write the interleaved native endian samples (frames * channels).
+ */
+void oal_adpcm_ima_decode(const uint8_t* src,
+						  uint32_t channels,
+						  uint32_t frames,
+						  uint32_t frames_per_block,
+						  int16_t* dst);
+
+/** The name of the instruction set the decoder is using ("avx2", "sse2", "neon" or "scalar"). */
+const char* oal_adpcm_isa(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_ADPCM_H */
@@ -0,0 +1,165 @@
+//
+//  oal_completion_ring.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+#include "oal_completion_ring.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+
+/** Keeps the producer and consumer positions on separate cache lines. */
+#define kCacheLineSize 64
+
+typedef struct
+{
+	/** Equals the slot's position when free, and position + 1 once filled. */
+	atomic_size_t sequence;
+	oal_completion_function function;
+	void* context;
+	void* argument;
+} completion_slot;
+
+struct oal_completion_ring
+{
+	_Alignas(kCacheLineSize) atomic_size_t push_position;
+	_Alignas(kCacheLineSize) size_t drain_position;
+	size_t mask;
+	completion_slot* slots;
+};
+
+
+oal_completion_ring* oal_completion_ring_create(uint32_t capacity)
+{
+	size_t size = 2;
+	while(size < capacity)
+	{
+		size <<= 1;
+	}
+
+	oal_completion_ring* ring;
+	if(0 != posix_memalign((void**)&ring, kCacheLineSize, sizeof(*ring)))
+	{
+		return NULL;
+	}
+	ring->slots = calloc(size, sizeof(*ring->slots));
+	if(NULL == ring->slots)
+	{
+		free(ring);
+		return NULL;
+	}
+	for(size_t i = 0; i < size; i++)
+	{
+		atomic_init(&ring->slots[i].sequence, i);
+	}
+	atomic_init(&ring->push_position, 0);
+	ring->drain_position = 0;
+	ring->mask = size - 1;
+	return ring;
+}
+
+void oal_completion_ring_destroy(oal_completion_ring* ring)
+{
+	if(NULL != ring)
+	{
+		free(ring->slots);
+		free(ring);
+	}
+}
+
+uint32_t oal_completion_ring_capacity(const oal_completion_ring* ring)
+{
+	return (uint32_t)(ring->mask + 1);
+}
+
+bool oal_completion_ring_push(oal_completion_ring* ring,
+							  oal_completion_function function,
+							  void* context,
+							  void* argument)
+{
+	size_t position = atomic_load_explicit(&ring->push_position, memory_order_relaxed);
+	for(;;)
+	{
+		completion_slot* slot = &ring->slots[position & ring->mask];
+		size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+		if(0 == difference)
+		{
+			// The slot is free. Claim it, unless another producer got there first.
+			if(atomic_compare_exchange_weak_explicit(&ring->push_position, &position, position + 1,
+													 memory_order_relaxed, memory_order_relaxed))
+			{
+				slot->function = function;
+				slot->context = context;
+				slot->argument = argument;
+				atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+				return true;
+			}
+		}
+		else if(difference < 0)
+		{
+			// The slot still holds the completion from one lap ago.
+			return false;
+		}
+		else
+		{
+			position = atomic_load_explicit(&ring->push_position, memory_order_relaxed);
+		}
+	}
+}
+
+size_t oal_completion_ring_drain(oal_completion_ring* ring, size_t maxCount)
+{
+	if(0 == maxCount)
+	{
+		maxCount = ring->mask + 1;
+	}
+
+	size_t count = 0;
+	while(count < maxCount)
+	{
+		size_t position = ring->drain_position;
+		completion_slot* slot = &ring->slots[position & ring->mask];
+		if(atomic_load_explicit(&slot->sequence, memory_order_acquire) != position + 1)
+		{
+			// Empty, or the next producer hasn't finished filling its slot.
+			break;
+		}
+		oal_completion_function function = slot->function;
+		void* context = slot->context;
+		void* argument = slot->argument;
+		// Free the slot before calling, so that the completion can push again.
+		atomic_store_explicit(&slot->sequence, position + ring->mask + 1, memory_order_release);
+		ring->drain_position = position + 1;
+
+		function(context, argument);
+		count++;
+	}
+	return count;
+}
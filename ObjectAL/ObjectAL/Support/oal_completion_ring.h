@@ -0,0 +1,111 @@
+//
+//  oal_completion_ring.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+/* Bounded lock-free queue of completion callbacks.
+ * Any number of threads may push, and one thread drains.
+ */
+
+#ifndef OAL_COMPLETION_RING_H
+#define OAL_COMPLETION_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** A completion callback.
+ *
+ * @param context The context passed to oal_completion_ring_push().
+ * @param argument The argument passed to oal_completion_ring_push().
+ */
+typedef void (*oal_completion_function)(void* context, void* argument);
+
+typedef struct oal_completion_ring oal_completion_ring;
+
+
+// Lifecycle
+
+/** Create a ring. All memory is allocated here, so pushing never allocates.
+ *
+ * @param capacity The number of completions it can hold (rounded up to a power of 2).
+ * @return The new ring, or NULL if it could not be allocated.
+ */
+oal_completion_ring* oal_completion_ring_create(uint32_t capacity);
+
+/** Destroy a ring. Completions still in it are dropped without being called.
+ *
+ * @param ring The ring (may be NULL).
+ */
+void oal_completion_ring_destroy(oal_completion_ring* ring);
+
+/** Get the number of completions a ring can hold.
+ *
+ * @param ring The ring.
+ * @return The capacity.
+ */
+uint32_t oal_completion_ring_capacity(const oal_completion_ring* ring);
+
+
+// Use
+
+/** Add a completion to a ring. Safe to call from any thread.
+ *
+ * @param ring The ring.
+ * @param function The function to call when the ring is drained.
+ * @param context The first argument to the function.
+ * @param argument The second argument to the function.
+ * @return false if the ring is full.
+ */
+bool oal_completion_ring_push(oal_completion_ring* ring,
+							  oal_completion_function function,
+							  void* context,
+							  void* argument);
+
+/** Call the completions in a ring in the order they were pushed, removing them.
+ * Only one thread may drain a ring at a time.
+ *
+ * Completions pushed while draining (including by the completions themselves)
+ * are left for the next drain once maxCount have been called.
+ *
+ * @param ring The ring.
+ * @param maxCount The most completions to call (0 = up to the ring's capacity).
+ * @return The number of completions called.
+ */
+size_t oal_completion_ring_drain(oal_completion_ring* ring, size_t maxCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_COMPLETION_RING_H */
@@ -0,0 +1,769 @@
+//
+//  oal_convert.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#include "oal_convert.h"
+#include <math.h>
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+	#define OAL_CONVERT_X86 1
+	#include <emmintrin.h>
+	#if defined(__GNUC__) || defined(__clang__)
+		#define OAL_CONVERT_AVX2 1
+		#include <immintrin.h>
+	#endif
+#elif defined(__aarch64__) || defined(__arm64__)
+	#define OAL_CONVERT_NEON 1
+	#include <arm_neon.h>
+#endif
+
+
+/** Dither noise is generated from 24 random bits per draw. */
+#define kDitherScale (1.0f / 16777216.0f)
+
+
+// Dispatch
+
+typedef struct
+{
+	const char* name;
+	void (*float_to_s16)(const float* src, int16_t* dst, size_t count, oal_dither* dither);
+	void (*s8_to_s16)(const int8_t* src, int16_t* dst, size_t count);
+	void (*u8_to_s16)(const uint8_t* src, int16_t* dst, size_t count);
+	void (*s32_to_s16)(const int32_t* src, int16_t* dst, size_t count);
+	void (*stereo_to_mono_s16)(const int16_t* src, int16_t* dst, size_t frames);
+	void (*swap_s16)(int16_t* samples, size_t count);
+} convert_kernels;
+
+static convert_kernels g_kernels;
+static pthread_once_t g_kernels_once = PTHREAD_ONCE_INIT;
+
+
+// Scalar
+
+static uint32_t xorshift32(uint32_t* state)
+{
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+/** Triangular noise in the range (-1, 1), in units of LSB. */
+static float tpdf_noise(uint32_t* state)
+{
+	float a = (float)(xorshift32(state) >> 8) * kDitherScale;
+	float b = (float)(xorshift32(state) >> 8) * kDitherScale;
+	return a - b;
+}
+
+static int16_t clamp_rint_s16(float value)
+{
+	if(value >= 32767.0f)
+	{
+		return 32767;
+	}
+	if(value <= -32768.0f)
+	{
+		return -32768;
+	}
+	return (int16_t)lrintf(value);
+}
+
+static void scalar_float_to_s16(const float* src, int16_t* dst, size_t count, oal_dither* dither)
+{
+	if(NULL == dither)
+	{
+		for(size_t i = 0; i < count; i++)
+		{
+			dst[i] = clamp_rint_s16(src[i] * 32768.0f);
+		}
+		return;
+	}
+	for(size_t i = 0; i < count; i++)
+	{
+		dst[i] = clamp_rint_s16(src[i] * 32768.0f + tpdf_noise(&dither->seeds[0]));
+	}
+}
+
+static void scalar_s8_to_s16(const int8_t* src, int16_t* dst, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		dst[i] = (int16_t)(src[i] * 256);
+	}
+}
+
+static void scalar_u8_to_s16(const uint8_t* src, int16_t* dst, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		dst[i] = (int16_t)(((int)src[i] - 128) * 256);
+	}
+}
+
+static void scalar_s32_to_s16(const int32_t* src, int16_t* dst, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		dst[i] = (int16_t)(src[i] >> 16);
+	}
+}
+
+static void scalar_stereo_to_mono_s16(const int16_t* src, int16_t* dst, size_t frames)
+{
+	for(size_t i = 0; i < frames; i++, src += 2)
+	{
+		int32_t sum = (int32_t)src[0] + src[1];
+		// Arithmetic shift rounds down, same as the vector versions.
+		dst[i] = (int16_t)(sum >> 1);
+	}
+}
+
+static void scalar_swap_s16(int16_t* samples, size_t count)
+{
+	uint16_t* p = (uint16_t*)samples;
+	for(size_t i = 0; i < count; i++)
+	{
+		p[i] = (uint16_t)((p[i] << 8) | (p[i] >> 8));
+	}
+}
+
+
+// SSE2
+
+#if OAL_CONVERT_X86
+
+static __m128i sse2_xorshift32(__m128i x)
+{
+	x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+	return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+}
+
+static __m128 sse2_uniform(__m128i x)
+{
+	return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(x, 8)), _mm_set1_ps(kDitherScale));
+}
+
+static void sse2_float_to_s16(const float* src, int16_t* dst, size_t count, oal_dither* dither)
+{
+	const __m128 scale = _mm_set1_ps(32768.0f);
+	const __m128 high = _mm_set1_ps(32767.0f);
+	const __m128 low = _mm_set1_ps(-32768.0f);
+	__m128i seeds = _mm_setzero_si128();
+	if(NULL != dither)
+	{
+		seeds = _mm_loadu_si128((const __m128i*)dither->seeds);
+	}
+
+	size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m128 a = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+		__m128 b = _mm_mul_ps(_mm_loadu_ps(src + i + 4), scale);
+		if(NULL != dither)
+		{
+			__m128i r1 = sse2_xorshift32(seeds);
+			__m128i r2 = sse2_xorshift32(r1);
+			__m128i r3 = sse2_xorshift32(r2);
+			seeds = sse2_xorshift32(r3);
+			a = _mm_add_ps(a, _mm_sub_ps(sse2_uniform(r1), sse2_uniform(r2)));
+			b = _mm_add_ps(b, _mm_sub_ps(sse2_uniform(r3), sse2_uniform(seeds)));
+		}
+		// Clamp first so that huge values don't convert to INT_MIN.
+		a = _mm_max_ps(_mm_min_ps(a, high), low);
+		b = _mm_max_ps(_mm_min_ps(b, high), low);
+		__m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+		_mm_storeu_si128((__m128i*)(dst + i), packed);
+	}
+
+	if(NULL != dither)
+	{
+		_mm_storeu_si128((__m128i*)dither->seeds, seeds);
+	}
+	scalar_float_to_s16(src + i, dst + i, count - i, dither);
+}
+
+static void sse2_s8_to_s16(const int8_t* src, int16_t* dst, size_t count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+		// Placing each byte in the high half of a 16-bit lane multiplies it by 256.
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(zero, v));
+		_mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi8(zero, v));
+	}
+	scalar_s8_to_s16(src + i, dst + i, count - i);
+}
+
+static void sse2_u8_to_s16(const uint8_t* src, int16_t* dst, size_t count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias = _mm_set1_epi8((char)0x80);
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src + i)), bias);
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(zero, v));
+		_mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi8(zero, v));
+	}
+	scalar_u8_to_s16(src + i, dst + i, count - i);
+}
+
+static void sse2_s32_to_s16(const int32_t* src, int16_t* dst, size_t count)
+{
+	size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m128i a = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(src + i)), 16);
+		__m128i b = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(src + i + 4)), 16);
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+	}
+	scalar_s32_to_s16(src + i, dst + i, count - i);
+}
+
+static void sse2_stereo_to_mono_s16(const int16_t* src, int16_t* dst, size_t frames)
+{
+	const __m128i ones = _mm_set1_epi16(1);
+	size_t i = 0;
+	for(; i + 8 <= frames; i += 8)
+	{
+		// madd sums each left/right pair into a 32-bit lane.
+		__m128i a = _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(src + i * 2)), ones);
+		__m128i b = _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(src + i * 2 + 8)), ones);
+		a = _mm_srai_epi32(a, 1);
+		b = _mm_srai_epi32(b, 1);
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+	}
+	scalar_stereo_to_mono_s16(src + i * 2, dst + i, frames - i);
+}
+
+static void sse2_swap_s16(int16_t* samples, size_t count)
+{
+	size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(samples + i));
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		_mm_storeu_si128((__m128i*)(samples + i), v);
+	}
+	scalar_swap_s16(samples + i, count - i);
+}
+
+#endif /* OAL_CONVERT_X86 */
+
+
+// AVX2
+
+#if OAL_CONVERT_AVX2
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+AVX2_TARGET static __m256i avx2_xorshift32(__m256i x)
+{
+	x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+	return _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+}
+
+AVX2_TARGET static __m256 avx2_uniform(__m256i x)
+{
+	return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(x, 8)), _mm256_set1_ps(kDitherScale));
+}
+
+/** Pack two vectors of 32-bit values to 16-bit, keeping them in order. */
+AVX2_TARGET static __m256i avx2_packs_ordered(__m256i a, __m256i b)
+{
+	// packs works within 128-bit lanes, leaving the quarters as a0 b0 a1 b1.
+	return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+AVX2_TARGET static void avx2_float_to_s16(const float* src, int16_t* dst, size_t count, oal_dither* dither)
+{
+	const __m256 scale = _mm256_set1_ps(32768.0f);
+	const __m256 high = _mm256_set1_ps(32767.0f);
+	const __m256 low = _mm256_set1_ps(-32768.0f);
+	__m256i seeds = _mm256_setzero_si256();
+	if(NULL != dither)
+	{
+		seeds = _mm256_loadu_si256((const __m256i*)dither->seeds);
+	}
+
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m256 a = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+		__m256 b = _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale);
+		if(NULL != dither)
+		{
+			__m256i r1 = avx2_xorshift32(seeds);
+			__m256i r2 = avx2_xorshift32(r1);
+			__m256i r3 = avx2_xorshift32(r2);
+			seeds = avx2_xorshift32(r3);
+			a = _mm256_add_ps(a, _mm256_sub_ps(avx2_uniform(r1), avx2_uniform(r2)));
+			b = _mm256_add_ps(b, _mm256_sub_ps(avx2_uniform(r3), avx2_uniform(seeds)));
+		}
+		a = _mm256_max_ps(_mm256_min_ps(a, high), low);
+		b = _mm256_max_ps(_mm256_min_ps(b, high), low);
+		__m256i packed = avx2_packs_ordered(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+		_mm256_storeu_si256((__m256i*)(dst + i), packed);
+	}
+
+	if(NULL != dither)
+	{
+		_mm256_storeu_si256((__m256i*)dither->seeds, seeds);
+	}
+	sse2_float_to_s16(src + i, dst + i, count - i, dither);
+}
+
+AVX2_TARGET static void avx2_s8_to_s16(const int8_t* src, int16_t* dst, size_t count)
+{
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m256i v = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(src + i)));
+		_mm256_storeu_si256((__m256i*)(dst + i), _mm256_slli_epi16(v, 8));
+	}
+	scalar_s8_to_s16(src + i, dst + i, count - i);
+}
+
+AVX2_TARGET static void avx2_u8_to_s16(const uint8_t* src, int16_t* dst, size_t count)
+{
+	const __m256i bias = _mm256_set1_epi16(128);
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(src + i)));
+		_mm256_storeu_si256((__m256i*)(dst + i), _mm256_slli_epi16(_mm256_sub_epi16(v, bias), 8));
+	}
+	scalar_u8_to_s16(src + i, dst + i, count - i);
+}
+
+AVX2_TARGET static void avx2_s32_to_s16(const int32_t* src, int16_t* dst, size_t count)
+{
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m256i a = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i*)(src + i)), 16);
+		__m256i b = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i*)(src + i + 8)), 16);
+		_mm256_storeu_si256((__m256i*)(dst + i), avx2_packs_ordered(a, b));
+	}
+	scalar_s32_to_s16(src + i, dst + i, count - i);
+}
+
+AVX2_TARGET static void avx2_stereo_to_mono_s16(const int16_t* src, int16_t* dst, size_t frames)
+{
+	const __m256i ones = _mm256_set1_epi16(1);
+	size_t i = 0;
+	for(; i + 16 <= frames; i += 16)
+	{
+		__m256i a = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(src + i * 2)), ones);
+		__m256i b = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(src + i * 2 + 16)), ones);
+		a = _mm256_srai_epi32(a, 1);
+		b = _mm256_srai_epi32(b, 1);
+		_mm256_storeu_si256((__m256i*)(dst + i), avx2_packs_ordered(a, b));
+	}
+	scalar_stereo_to_mono_s16(src + i * 2, dst + i, frames - i);
+}
+
+AVX2_TARGET static void avx2_swap_s16(int16_t* samples, size_t count)
+{
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i*)(samples + i));
+		v = _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+		_mm256_storeu_si256((__m256i*)(samples + i), v);
+	}
+	scalar_swap_s16(samples + i, count - i);
+}
+
+#endif /* OAL_CONVERT_AVX2 */
+
+
+// NEON
+
+#if OAL_CONVERT_NEON
+
+static uint32x4_t neon_xorshift32(uint32x4_t x)
+{
+	x = veorq_u32(x, vshlq_n_u32(x, 13));
+	x = veorq_u32(x, vshrq_n_u32(x, 17));
+	return veorq_u32(x, vshlq_n_u32(x, 5));
+}
+
+static float32x4_t neon_uniform(uint32x4_t x)
+{
+	return vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(x, 8)), kDitherScale);
+}
+
+static void neon_float_to_s16(const float* src, int16_t* dst, size_t count, oal_dither* dither)
+{
+	const float32x4_t high = vdupq_n_f32(32767.0f);
+	const float32x4_t low = vdupq_n_f32(-32768.0f);
+	uint32x4_t seeds = vdupq_n_u32(0);
+	if(NULL != dither)
+	{
+		seeds = vld1q_u32(dither->seeds);
+	}
+
+	size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		float32x4_t a = vmulq_n_f32(vld1q_f32(src + i), 32768.0f);
+		float32x4_t b = vmulq_n_f32(vld1q_f32(src + i + 4), 32768.0f);
+		if(NULL != dither)
+		{
+			uint32x4_t r1 = neon_xorshift32(seeds);
+			uint32x4_t r2 = neon_xorshift32(r1);
+			uint32x4_t r3 = neon_xorshift32(r2);
+			seeds = neon_xorshift32(r3);
+			a = vaddq_f32(a, vsubq_f32(neon_uniform(r1), neon_uniform(r2)));
+			b = vaddq_f32(b, vsubq_f32(neon_uniform(r3), neon_uniform(seeds)));
+		}
+		a = vmaxq_f32(vminq_f32(a, high), low);
+		b = vmaxq_f32(vminq_f32(b, high), low);
+		vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b))));
+	}
+
+	if(NULL != dither)
+	{
+		vst1q_u32(dither->seeds, seeds);
+	}
+	scalar_float_to_s16(src + i, dst + i, count - i, dither);
+}
+
+static void neon_s8_to_s16(const int8_t* src, int16_t* dst, size_t count)
+{
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		int8x16_t v = vld1q_s8(src + i);
+		vst1q_s16(dst + i, vshll_n_s8(vget_low_s8(v), 8));
+		vst1q_s16(dst + i + 8, vshll_n_s8(vget_high_s8(v), 8));
+	}
+	scalar_s8_to_s16(src + i, dst + i, count - i);
+}
+
+static void neon_u8_to_s16(const uint8_t* src, int16_t* dst, size_t count)
+{
+	size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		int8x16_t v = vreinterpretq_s8_u8(veorq_u8(vld1q_u8(src + i), vdupq_n_u8(0x80)));
+		vst1q_s16(dst + i, vshll_n_s8(vget_low_s8(v), 8));
+		vst1q_s16(dst + i + 8, vshll_n_s8(vget_high_s8(v), 8));
+	}
+	scalar_u8_to_s16(src + i, dst + i, count - i);
+}
+
+static void neon_s32_to_s16(const int32_t* src, int16_t* dst, size_t count)
+{
+	size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		int16x4_t a = vshrn_n_s32(vld1q_s32(src + i), 16);
+		int16x4_t b = vshrn_n_s32(vld1q_s32(src + i + 4), 16);
+		vst1q_s16(dst + i, vcombine_s16(a, b));
+	}
+	scalar_s32_to_s16(src + i, dst + i, count - i);
+}
+
+static void neon_stereo_to_mono_s16(const int16_t* src, int16_t* dst, size_t frames)
+{
+	size_t i = 0;
+	for(; i + 8 <= frames; i += 8)
+	{
+		int16x8x2_t v = vld2q_s16(src + i * 2);
+		// Halving add rounds down, same as the scalar version.
+		vst1q_s16(dst + i, vhaddq_s16(v.val[0], v.val[1]));
+	}
+	scalar_stereo_to_mono_s16(src + i * 2, dst + i, frames - i);
+}
+
+static void neon_swap_s16(int16_t* samples, size_t count)
+{
+	size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		uint8x16_t v = vreinterpretq_u8_s16(vld1q_s16(samples + i));
+		vst1q_s16(samples + i, vreinterpretq_s16_u8(vrev16q_u8(v)));
+	}
+	scalar_swap_s16(samples + i, count - i);
+}
+
+#endif /* OAL_CONVERT_NEON */
+
+
+static void select_kernels(void)
+{
+	g_kernels = (convert_kernels){"scalar",
+		scalar_float_to_s16,
+		scalar_s8_to_s16,
+		scalar_u8_to_s16,
+		scalar_s32_to_s16,
+		scalar_stereo_to_mono_s16,
+		scalar_swap_s16};
+
+#if OAL_CONVERT_X86
+	g_kernels = (convert_kernels){"sse2",
+		sse2_float_to_s16,
+		sse2_s8_to_s16,
+		sse2_u8_to_s16,
+		sse2_s32_to_s16,
+		sse2_stereo_to_mono_s16,
+		sse2_swap_s16};
+#endif
+#if OAL_CONVERT_AVX2
+	if(__builtin_cpu_supports("avx2"))
+	{
+		g_kernels = (convert_kernels){"avx2",
+			avx2_float_to_s16,
+			avx2_s8_to_s16,
+			avx2_u8_to_s16,
+			avx2_s32_to_s16,
+			avx2_stereo_to_mono_s16,
+			avx2_swap_s16};
+	}
+#endif
+#if OAL_CONVERT_NEON
+	g_kernels = (convert_kernels){"neon",
+		neon_float_to_s16,
+		neon_s8_to_s16,
+		neon_u8_to_s16,
+		neon_s32_to_s16,
+		neon_stereo_to_mono_s16,
+		neon_swap_s16};
+#endif
+}
+
+static const convert_kernels* kernels(void)
+{
+	pthread_once(&g_kernels_once, select_kernels);
+	return &g_kernels;
+}
+
+
+// Fold down
+
+/** Mix gains in 1.14 fixed point. */
+#define kGainFull 16384
+#define kGainHalfPower 11585
+#define kGainShift 14
+
+/** Build the stereo fold down matrix for a channel layout.
+ * Each output is normalized so that the sum of its gains is unity.
+ */
+static void fold_down_gains(uint32_t channels, int32_t left[8], int32_t right[8])
+{
+	// Which side each input channel goes to: 'L', 'R', 'C' (both) or 0 (dropped).
+	static const char* const layouts[] =
+	{
+		"LRC",       // 3: L R C
+		"LRLR",      // 4: L R BL BR
+		"LRCLR",     // 5: L R C BL BR
+		"LRC_LR",    // 6: L R C LFE BL BR
+		"LRC_CLR",   // 7: L R C LFE BC SL SR
+		"LRC_LRLR",  // 8: L R C LFE BL BR SL SR
+	};
+	const char* layout = layouts[channels - 3];
+	int32_t total = 0;
+
+	for(uint32_t ch = 0; ch < channels; ch++)
+	{
+		left[ch] = right[ch] = 0;
+		int32_t gain = ch < 2 ? kGainFull : kGainHalfPower;
+		switch(layout[ch])
+		{
+			case 'L':
+				left[ch] = gain;
+				total += gain;
+				break;
+			case 'R':
+				right[ch] = gain;
+				break;
+			case 'C':
+				left[ch] = right[ch] = gain;
+				total += gain;
+				break;
+		}
+	}
+
+	for(uint32_t ch = 0; ch < channels; ch++)
+	{
+		left[ch] = left[ch] * kGainFull / total;
+		right[ch] = right[ch] * kGainFull / total;
+	}
+}
+
+static int16_t clamp_s16(int32_t value)
+{
+	return value > 32767 ? 32767 : value < -32768 ? -32768 : (int16_t)value;
+}
+
+
+// API
+
+void oal_convert_dither_init(oal_dither* dither, uint32_t seed)
+{
+	uint32_t state = 0 == seed ? 0x9e3779b9u : seed;
+	for(int i = 0; i < 8; i++)
+	{
+		dither->seeds[i] = xorshift32(&state);
+	}
+}
+
+void oal_convert_float_to_s16(const float* src, int16_t* dst, size_t count, oal_dither* dither)
+{
+	kernels()->float_to_s16(src, dst, count, dither);
+}
+
+void oal_convert_s8_to_s16(const int8_t* src, int16_t* dst, size_t count)
+{
+	kernels()->s8_to_s16(src, dst, count);
+}
+
+void oal_convert_u8_to_s16(const uint8_t* src, int16_t* dst, size_t count)
+{
+	kernels()->u8_to_s16(src, dst, count);
+}
+
+void oal_convert_s24le_to_s16(const uint8_t* src, int16_t* dst, size_t count)
+{
+	// The top two bytes of each sample are the 16-bit result, so this is a
+	// plain gather which compilers vectorize well enough on their own.
+	for(size_t i = 0; i < count; i++, src += 3)
+	{
+		dst[i] = (int16_t)(uint16_t)(src[1] | (src[2] << 8));
+	}
+}
+
+void oal_convert_s32_to_s16(const int32_t* src, int16_t* dst, size_t count)
+{
+	kernels()->s32_to_s16(src, dst, count);
+}
+
+void oal_convert_stereo_to_mono_s16(const int16_t* src, int16_t* dst, size_t frames)
+{
+	kernels()->stereo_to_mono_s16(src, dst, frames);
+}
+
+void oal_convert_fold_down_s16(const int16_t* src, uint32_t channels, int16_t* dst, size_t frames)
+{
+	int32_t left[8];
+	int32_t right[8];
+
+	if(channels < 3 || channels > 8)
+	{
+		// Unknown layout. Keep the front pair.
+		for(size_t i = 0; i < frames; i++, src += channels, dst += 2)
+		{
+			dst[0] = src[0];
+			dst[1] = channels > 1 ? src[1] : src[0];
+		}
+		return;
+	}
+
+	fold_down_gains(channels, left, right);
+	for(size_t i = 0; i < frames; i++, src += channels, dst += 2)
+	{
+		int32_t l = 1 << (kGainShift - 1);
+		int32_t r = 1 << (kGainShift - 1);
+		for(uint32_t ch = 0; ch < channels; ch++)
+		{
+			l += src[ch] * left[ch];
+			r += src[ch] * right[ch];
+		}
+		dst[0] = clamp_s16(l >> kGainShift);
+		dst[1] = clamp_s16(r >> kGainShift);
+	}
+}
+
+void oal_convert_stereo_to_mono_f32(const float* src, float* dst, size_t frames)
+{
+	// Simple enough for compilers to vectorize.
+	for(size_t i = 0; i < frames; i++)
+	{
+		dst[i] = (src[i * 2] + src[i * 2 + 1]) * 0.5f;
+	}
+}
+
+void oal_convert_fold_down_f32(const float* src, uint32_t channels, float* dst, size_t frames)
+{
+	int32_t left[8];
+	int32_t right[8];
+	float left_gains[8];
+	float right_gains[8];
+
+	if(channels < 3 || channels > 8)
+	{
+		for(size_t i = 0; i < frames; i++, src += channels, dst += 2)
+		{
+			dst[0] = src[0];
+			dst[1] = channels > 1 ? src[1] : src[0];
+		}
+		return;
+	}
+
+	fold_down_gains(channels, left, right);
+	for(uint32_t ch = 0; ch < channels; ch++)
+	{
+		left_gains[ch] = (float)left[ch] / kGainFull;
+		right_gains[ch] = (float)right[ch] / kGainFull;
+	}
+	for(size_t i = 0; i < frames; i++, src += channels, dst += 2)
+	{
+		float l = 0;
+		float r = 0;
+		for(uint32_t ch = 0; ch < channels; ch++)
+		{
+			l += src[ch] * left_gains[ch];
+			r += src[ch] * right_gains[ch];
+		}
+		dst[0] = l;
+		dst[1] = r;
+	}
+}
+
+void oal_convert_swap_s16(int16_t* samples, size_t count)
+{
+	kernels()->swap_s16(samples, count);
+}
+
+const char* oal_convert_isa(void)
+{
+	return kernels()->name;
+}
@@ -0,0 +1,127 @@
+//
+//  oal_convert.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+/* Sample format conversion kernels used by the decoding pipeline.
+ *
+ * The per-sample kernels have SSE2, AVX2 (x86) and NEON (arm64) implementations
+ * along with a portable scalar fallback. The fastest one the CPU supports is chosen
+ * the first time a kernel is called. Apart from dither noise, all implementations
+ * produce identical results.
+ *
+ * 16-bit output is always native endian. Source and destination must not overlap
+ * unless stated otherwise.
+ */
+
+#ifndef OAL_CONVERT_H
+#define OAL_CONVERT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** State for the dither noise generator. Initialize with oal_convert_dither_init(). */
+typedef struct
+{
+	uint32_t seeds[8];
+} oal_dither;
+
+/** Initialize a dither noise generator.
+ *
+ * @param dither The generator.
+ * @param seed Any value other than 0.
+ */
+void oal_convert_dither_init(oal_dither* dither, uint32_t seed);
+
+/** Convert 32-bit float samples (nominally -1.0 to 1.0) to 16-bit, clipping out of range samples.
+ *
+ * @param src The samples to convert.
+ * @param dst Where to write the converted samples.
+ * @param count The number of samples.
+ * @param dither If not NULL, adds triangular (TPDF) dither noise of +-1 LSB before rounding.
+ */
+void oal_convert_float_to_s16(const float* src, int16_t* dst, size_t count, oal_dither* dither);
+
+/** Convert signed 8-bit samples to 16-bit. */
+void oal_convert_s8_to_s16(const int8_t* src, int16_t* dst, size_t count);
+
+/** Convert unsigned 8-bit samples (as used by WAV files) to 16-bit. */
+void oal_convert_u8_to_s16(const uint8_t* src, int16_t* dst, size_t count);
+
+/** Convert packed little endian 24-bit samples to 16-bit. src holds count * 3 bytes. */
+void oal_convert_s24le_to_s16(const uint8_t* src, int16_t* dst, size_t count);
+
+/** Convert native endian 32-bit samples to 16-bit. */
+void oal_convert_s32_to_s16(const int32_t* src, int16_t* dst, size_t count);
+
+/** Reduce interleaved stereo to mono by averaging the channels.
+ * dst may be the same as src.
+ *
+ * @param src Interleaved stereo frames (frames * 2 samples).
+ * @param dst Where to write the mono frames.
+ * @param frames The number of frames.
+ */
+void oal_convert_stereo_to_mono_s16(const int16_t* src, int16_t* dst, size_t frames);
+
+/** Fold interleaved multichannel audio down to stereo.
+ * Channels are assumed to be in WAV/FLAC order (L, R, C, LFE, rear/side...).
+ * Center and surround channels are mixed into both sides at -3dB, the LFE channel
+ * is dropped, and the result is scaled so that it can't clip.
+ *
+ * @param src Interleaved frames of 3 to 8 channels.
+ * @param channels The number of channels in src.
+ * @param dst Where to write the stereo frames (frames * 2 samples).
+ * @param frames The number of frames.
+ */
+void oal_convert_fold_down_s16(const int16_t* src, uint32_t channels, int16_t* dst, size_t frames);
+
+/** Reduce interleaved 32-bit float stereo to mono by averaging the channels.
+ * dst may be the same as src.
+ */
+void oal_convert_stereo_to_mono_f32(const float* src, float* dst, size_t frames);
+
+/** Fold interleaved 32-bit float multichannel audio down to stereo,
+ * using the same mix as oal_convert_fold_down_s16().
+ */
+void oal_convert_fold_down_f32(const float* src, uint32_t channels, float* dst, size_t frames);
+
+/** Swap the byte order of 16-bit samples in place. */
+void oal_convert_swap_s16(int16_t* samples, size_t count);
+
+/** The name of the instruction set the kernels are using ("avx2", "sse2", "neon" or "scalar"). */
+const char* oal_convert_isa(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_CONVERT_H */
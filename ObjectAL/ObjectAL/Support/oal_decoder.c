@@ -0,0 +1,606 @@
+//
+//  oal_decoder.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#include "oal_decoder.h"
+#include "oal_decoder_backend.h"
+#include "oal_convert.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/** Frames converted per pass when the output has fewer channels than the file. */
+#define kDownmixChunkFrames 1024
+
+/** Parallel decoding gives each thread at least this many frames. */
+#define kMinFramesPerThread 65536
+
+/** The most threads parallel decoding will use. */
+#define kMaxThreads 16
+
+/** Identifies a saved seek table file ("OALS"). */
+#define kSeekTableMagic 0x534c414f
+
+#define kSeekTableFileVersion 1
+
+/** All available backends, in probing order. */
+static const oal_decoder_backend* const g_backends[] =
+{
+	&oal_decoder_backend_wav,
+	&oal_decoder_backend_flac,
+#if OBJECTAL_CFG_USE_STB_VORBIS
+	&oal_decoder_backend_vorbis,
+#endif
+#if OBJECTAL_CFG_USE_OPUSFILE
+	&oal_decoder_backend_opus,
+#endif
+};
+
+struct oal_decoder
+{
+	const oal_decoder_backend* backend;
+	void* state;
+	char* path;
+	oal_decoder_info info;
+	uint32_t output_channels;
+	int64_t position;
+	bool output_float;
+	/** Holds full frames while reducing the channel count. Only allocated when needed.
+	 * Big enough for float samples, so switching output types doesn't need a new one.
+	 */
+	void* scratch;
+};
+
+
+oal_decoder* oal_decoder_open(const char* path)
+{
+	uint8_t header[OAL_DECODER_PROBE_SIZE];
+	size_t length;
+	FILE* file;
+
+	if(NULL == path || NULL == (file = fopen(path, "rb")))
+	{
+		return NULL;
+	}
+	length = fread(header, 1, sizeof(header), file);
+	fclose(file);
+
+	for(size_t i = 0; i < sizeof(g_backends) / sizeof(*g_backends); i++)
+	{
+		const oal_decoder_backend* backend = g_backends[i];
+		if(!backend->probe(header, length))
+		{
+			continue;
+		}
+
+		oal_decoder* decoder = calloc(1, sizeof(*decoder));
+		if(NULL == decoder)
+		{
+			return NULL;
+		}
+		decoder->backend = backend;
+		decoder->path = malloc(strlen(path) + 1);
+		if(NULL != decoder->path)
+		{
+			strcpy(decoder->path, path);
+		}
+		decoder->state = backend->open(path, &decoder->info);
+		if(NULL == decoder->state || NULL == decoder->path ||
+		   0 == decoder->info.channels || 0 == decoder->info.sample_rate)
+		{
+			if(NULL != decoder->state)
+			{
+				backend->close(decoder->state);
+			}
+			free(decoder->path);
+			free(decoder);
+			return NULL;
+		}
+		decoder->output_channels = decoder->info.channels;
+		return decoder;
+	}
+	return NULL;
+}
+
+void oal_decoder_close(oal_decoder* decoder)
+{
+	if(NULL != decoder)
+	{
+		decoder->backend->close(decoder->state);
+		free(decoder->path);
+		free(decoder->scratch);
+		free(decoder);
+	}
+}
+
+const char* oal_decoder_name(const oal_decoder* decoder)
+{
+	return decoder->backend->name;
+}
+
+uint32_t oal_decoder_sample_rate(const oal_decoder* decoder)
+{
+	return decoder->info.sample_rate;
+}
+
+uint32_t oal_decoder_channels(const oal_decoder* decoder)
+{
+	return decoder->info.channels;
+}
+
+int64_t oal_decoder_total_frames(const oal_decoder* decoder)
+{
+	return decoder->info.total_frames;
+}
+
+uint32_t oal_decoder_output_channels(const oal_decoder* decoder)
+{
+	return decoder->output_channels;
+}
+
+bool oal_decoder_set_output_channels(oal_decoder* decoder, uint32_t channels)
+{
+	if(channels < 1 || channels > decoder->info.channels)
+	{
+		return false;
+	}
+	if(channels != decoder->info.channels && NULL == decoder->scratch)
+	{
+		decoder->scratch = malloc(kDownmixChunkFrames * decoder->info.channels * sizeof(float));
+		if(NULL == decoder->scratch)
+		{
+			return false;
+		}
+	}
+	decoder->output_channels = channels;
+	return true;
+}
+
+bool oal_decoder_is_float(const oal_decoder* decoder)
+{
+	return decoder->info.is_float && NULL != decoder->backend->read_float;
+}
+
+bool oal_decoder_output_float(const oal_decoder* decoder)
+{
+	return decoder->output_float;
+}
+
+bool oal_decoder_set_output_float(oal_decoder* decoder, bool output_float)
+{
+	if(output_float && !oal_decoder_is_float(decoder))
+	{
+		return false;
+	}
+	decoder->output_float = output_float;
+	return true;
+}
+
+bool oal_decoder_seek(oal_decoder* decoder, int64_t frame)
+{
+	if(frame < 0 || (decoder->info.total_frames > 0 && frame > decoder->info.total_frames))
+	{
+		return false;
+	}
+	if(!decoder->backend->seek(decoder->state, frame))
+	{
+		return false;
+	}
+	decoder->position = frame;
+	return true;
+}
+
+/** Size in bytes of one output sample. */
+static size_t output_sample_size(const oal_decoder* decoder)
+{
+	return decoder->output_float ? sizeof(float) : sizeof(int16_t);
+}
+
+/** Decode full frames (all of the file's channels) in the output sample type. */
+static uint32_t backend_read(oal_decoder* decoder, void* dst, uint32_t frames)
+{
+	if(decoder->output_float)
+	{
+		return decoder->backend->read_float(decoder->state, dst, frames);
+	}
+	return decoder->backend->read(decoder->state, dst, frames);
+}
+
+static void downmix_s16(const int16_t* src, uint32_t in_channels, int16_t* out, uint32_t out_channels, uint32_t count)
+{
+	if(1 == out_channels && 2 == in_channels)
+	{
+		oal_convert_stereo_to_mono_s16(src, out, count);
+	}
+	else if(1 == out_channels)
+	{
+		for(uint32_t i = 0; i < count; i++, src += in_channels)
+		{
+			int32_t sum = 0;
+			for(uint32_t ch = 0; ch < in_channels; ch++)
+			{
+				sum += src[ch];
+			}
+			out[i] = (int16_t)(sum / (int32_t)in_channels);
+		}
+	}
+	else if(2 == out_channels)
+	{
+		oal_convert_fold_down_s16(src, in_channels, out, count);
+	}
+	else
+	{
+		for(uint32_t i = 0; i < count; i++, src += in_channels, out += out_channels)
+		{
+			memcpy(out, src, out_channels * sizeof(*out));
+		}
+	}
+}
+
+static void downmix_f32(const float* src, uint32_t in_channels, float* out, uint32_t out_channels, uint32_t count)
+{
+	if(1 == out_channels && 2 == in_channels)
+	{
+		oal_convert_stereo_to_mono_f32(src, out, count);
+	}
+	else if(1 == out_channels)
+	{
+		for(uint32_t i = 0; i < count; i++, src += in_channels)
+		{
+			float sum = 0;
+			for(uint32_t ch = 0; ch < in_channels; ch++)
+			{
+				sum += src[ch];
+			}
+			out[i] = sum / (float)in_channels;
+		}
+	}
+	else if(2 == out_channels)
+	{
+		oal_convert_fold_down_f32(src, in_channels, out, count);
+	}
+	else
+	{
+		for(uint32_t i = 0; i < count; i++, src += in_channels, out += out_channels)
+		{
+			memcpy(out, src, out_channels * sizeof(*out));
+		}
+	}
+}
+
+uint32_t oal_decoder_read(oal_decoder* decoder, void* dst, uint32_t frames)
+{
+	uint32_t in_channels = decoder->info.channels;
+	uint32_t out_channels = decoder->output_channels;
+	size_t out_frame_size = out_channels * output_sample_size(decoder);
+	uint32_t frames_read = 0;
+
+	if(out_channels == in_channels)
+	{
+		// Straight into the caller's buffer.
+		while(frames_read < frames)
+		{
+			uint32_t count = backend_read(decoder,
+										  (uint8_t*)dst + frames_read * out_frame_size,
+										  frames - frames_read);
+			if(0 == count)
+			{
+				break;
+			}
+			frames_read += count;
+		}
+		decoder->position += frames_read;
+		return frames_read;
+	}
+
+	while(frames_read < frames)
+	{
+		uint32_t wanted = frames - frames_read;
+		if(wanted > kDownmixChunkFrames)
+		{
+			wanted = kDownmixChunkFrames;
+		}
+		uint32_t count = backend_read(decoder, decoder->scratch, wanted);
+		if(0 == count)
+		{
+			break;
+		}
+
+		void* out = (uint8_t*)dst + frames_read * out_frame_size;
+		if(decoder->output_float)
+		{
+			downmix_f32(decoder->scratch, in_channels, out, out_channels, count);
+		}
+		else
+		{
+			downmix_s16(decoder->scratch, in_channels, out, out_channels, count);
+		}
+		frames_read += count;
+	}
+	decoder->position += frames_read;
+	return frames_read;
+}
+
+
+// Seek tables
+
+/** The header of a saved seek table. The backend's table data follows it. */
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	/** The backend name, so that a table is never given to the wrong decoder. */
+	char backend[16];
+	/** Size and modification time of the audio file, to detect changes. */
+	uint64_t source_size;
+	int64_t source_mtime;
+	uint64_t table_size;
+} seek_table_file_header;
+
+static bool fill_seek_table_header(const oal_decoder* decoder, seek_table_file_header* header)
+{
+	struct stat info;
+	if(0 != stat(decoder->path, &info))
+	{
+		return false;
+	}
+	memset(header, 0, sizeof(*header));
+	header->magic = kSeekTableMagic;
+	header->version = kSeekTableFileVersion;
+	strncpy(header->backend, decoder->backend->name, sizeof(header->backend) - 1);
+	header->source_size = (uint64_t)info.st_size;
+	header->source_mtime = (int64_t)info.st_mtime;
+	return true;
+}
+
+bool oal_decoder_build_seek_table(oal_decoder* decoder)
+{
+	if(NULL == decoder->backend->build_seek_table)
+	{
+		return true;
+	}
+	int64_t position = decoder->position;
+	bool built = decoder->backend->build_seek_table(decoder->state);
+	return oal_decoder_seek(decoder, position) && built;
+}
+
+bool oal_decoder_save_seek_table(oal_decoder* decoder, const char* path)
+{
+	seek_table_file_header header;
+	if(NULL == decoder->backend->export_seek_table)
+	{
+		return false;
+	}
+	uint64_t table_size = decoder->backend->export_seek_table(decoder->state, NULL, 0);
+	if(0 == table_size || !fill_seek_table_header(decoder, &header))
+	{
+		return false;
+	}
+	header.table_size = table_size;
+	void* table = malloc((size_t)header.table_size);
+	if(NULL == table)
+	{
+		return false;
+	}
+	decoder->backend->export_seek_table(decoder->state, table, (size_t)header.table_size);
+
+	// Write to a temporary file and rename it so that a partial table is never visible.
+	size_t path_length = strlen(path);
+	char* temp_path = malloc(path_length + 5);
+	FILE* file = NULL;
+	bool saved = false;
+	if(NULL != temp_path)
+	{
+		memcpy(temp_path, path, path_length);
+		memcpy(temp_path + path_length, ".tmp", 5);
+		file = fopen(temp_path, "wb");
+	}
+	if(NULL != file)
+	{
+		saved = 1 == fwrite(&header, sizeof(header), 1, file) &&
+			1 == fwrite(table, (size_t)header.table_size, 1, file);
+		saved = 0 == fclose(file) && saved;
+		saved = saved && 0 == rename(temp_path, path);
+		if(!saved)
+		{
+			remove(temp_path);
+		}
+	}
+	free(temp_path);
+	free(table);
+	return saved;
+}
+
+bool oal_decoder_load_seek_table(oal_decoder* decoder, const char* path)
+{
+	seek_table_file_header expected;
+	seek_table_file_header header;
+	if(NULL == decoder->backend->import_seek_table || !fill_seek_table_header(decoder, &expected))
+	{
+		return false;
+	}
+
+	FILE* file = fopen(path, "rb");
+	if(NULL == file)
+	{
+		return false;
+	}
+	bool loaded = false;
+	void* table = NULL;
+	if(1 == fread(&header, sizeof(header), 1, file) &&
+	   expected.magic == header.magic &&
+	   expected.version == header.version &&
+	   0 == memcmp(expected.backend, header.backend, sizeof(header.backend)) &&
+	   expected.source_size == header.source_size &&
+	   expected.source_mtime == header.source_mtime &&
+	   header.table_size > 0 &&
+	   NULL != (table = malloc((size_t)header.table_size)) &&
+	   1 == fread(table, (size_t)header.table_size, 1, file))
+	{
+		loaded = decoder->backend->import_seek_table(decoder->state, table, (size_t)header.table_size);
+	}
+	free(table);
+	fclose(file);
+	return loaded;
+}
+
+
+// Parallel decoding
+
+typedef struct
+{
+	const oal_decoder* parent;
+	const void* seek_table;
+	size_t seek_table_size;
+	int64_t start;
+	uint32_t frames;
+	void* dst;
+	uint32_t frames_read;
+} decode_job;
+
+static void* decode_job_main(void* arg)
+{
+	decode_job* job = arg;
+	oal_decoder* decoder = oal_decoder_open(job->parent->path);
+	if(NULL != decoder && NULL != job->seek_table)
+	{
+		// Use the parent's table rather than scanning the whole file again on the first seek.
+		decoder->backend->import_seek_table(decoder->state, job->seek_table, job->seek_table_size);
+	}
+	if(NULL != decoder &&
+	   oal_decoder_set_output_channels(decoder, job->parent->output_channels) &&
+	   oal_decoder_set_output_float(decoder, job->parent->output_float) &&
+	   oal_decoder_seek(decoder, job->start))
+	{
+		job->frames_read = oal_decoder_read(decoder, job->dst, job->frames);
+	}
+	oal_decoder_close(decoder);
+	return NULL;
+}
+
+static uint32_t processor_count(void)
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (uint32_t)count : 1;
+}
+
+uint32_t oal_decoder_read_parallel(oal_decoder* decoder, void* dst, uint32_t frames, uint32_t max_threads)
+{
+	decode_job jobs[kMaxThreads];
+	pthread_t threads[kMaxThreads];
+	bool started[kMaxThreads];
+
+	if(0 == max_threads)
+	{
+		max_threads = processor_count();
+	}
+	if(max_threads > kMaxThreads)
+	{
+		max_threads = kMaxThreads;
+	}
+	uint32_t num_jobs = frames / kMinFramesPerThread;
+	if(num_jobs > max_threads)
+	{
+		num_jobs = max_threads;
+	}
+	if(num_jobs < 2 || !decoder->backend->independent_ranges)
+	{
+		return oal_decoder_read(decoder, dst, frames);
+	}
+
+	// Build the seek table once here, and hand a copy to every thread.
+	void* seek_table = NULL;
+	size_t seek_table_size = 0;
+	if(NULL != decoder->backend->export_seek_table &&
+	   NULL != decoder->backend->import_seek_table &&
+	   oal_decoder_build_seek_table(decoder))
+	{
+		seek_table_size = decoder->backend->export_seek_table(decoder->state, NULL, 0);
+		if(seek_table_size > 0 && NULL != (seek_table = malloc(seek_table_size)))
+		{
+			decoder->backend->export_seek_table(decoder->state, seek_table, seek_table_size);
+		}
+	}
+
+	int64_t start = decoder->position;
+	uint32_t frames_per_job = frames / num_jobs;
+	for(uint32_t i = 0; i < num_jobs; i++)
+	{
+		jobs[i].parent = decoder;
+		jobs[i].seek_table = seek_table;
+		jobs[i].seek_table_size = seek_table_size;
+		jobs[i].start = start + (int64_t)i * frames_per_job;
+		jobs[i].frames = i == num_jobs - 1 ? frames - i * frames_per_job : frames_per_job;
+		jobs[i].dst = (uint8_t*)dst + (size_t)i * frames_per_job * decoder->output_channels * output_sample_size(decoder);
+		jobs[i].frames_read = 0;
+	}
+
+	// The calling thread takes the first range using the decoder that's already positioned there.
+	for(uint32_t i = 1; i < num_jobs; i++)
+	{
+		started[i] = 0 == pthread_create(&threads[i], NULL, decode_job_main, &jobs[i]);
+		if(!started[i])
+		{
+			decode_job_main(&jobs[i]);
+		}
+	}
+	jobs[0].frames_read = oal_decoder_read(decoder, jobs[0].dst, jobs[0].frames);
+	for(uint32_t i = 1; i < num_jobs; i++)
+	{
+		if(started[i])
+		{
+			pthread_join(threads[i], NULL);
+		}
+	}
+	free(seek_table);
+
+	// Only the last range may come up short (at the end of the stream).
+	uint32_t frames_read = 0;
+	for(uint32_t i = 0; i < num_jobs; i++)
+	{
+		frames_read += jobs[i].frames_read;
+		if(jobs[i].frames_read != jobs[i].frames && i != num_jobs - 1)
+		{
+			// Something went wrong. Do it the slow way.
+			if(!oal_decoder_seek(decoder, start))
+			{
+				return 0;
+			}
+			return oal_decoder_read(decoder, dst, frames);
+		}
+	}
+
+	// Leave the read position just after the decoded data, as oal_decoder_read() would.
+	oal_decoder_seek(decoder, start + frames_read);
+	return frames_read;
+}
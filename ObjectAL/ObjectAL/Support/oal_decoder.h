@@ -0,0 +1,172 @@
+//
+//  oal_decoder.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+/* Portable audio decoding.
+ *
+ * A small C interface over a set of container/codec backends, used by
+ * OALAudioFile in place of ExtAudioFile where possible. Nothing in here
+ * depends on Apple frameworks, so it can be built and exercised on any
+ * platform with a C99 compiler.
+ *
+ * Decoders produce interleaved, native endian, signed 16-bit PCM, written
+ * directly into the caller's buffer. Files that store floating point samples
+ * can also be decoded to 32-bit float without losing precision.
+ */
+
+#ifndef OAL_DECODER_H
+#define OAL_DECODER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** An open decoder. */
+typedef struct oal_decoder oal_decoder;
+
+/** Open an audio file, choosing a backend by probing the file's header.
+ *
+ * @param path The file system path of the file to open.
+ * @return A new decoder, or NULL if no backend recognizes the file.
+ */
+oal_decoder* oal_decoder_open(const char* path);
+
+/** Close a decoder and free all of its resources.
+ *
+ * @param decoder The decoder to close (may be NULL).
+ */
+void oal_decoder_close(oal_decoder* decoder);
+
+/** The name of the backend decoding this file ("wav", "flac", ...). */
+const char* oal_decoder_name(const oal_decoder* decoder);
+
+/** The sample rate of the audio data, in Hz. */
+uint32_t oal_decoder_sample_rate(const oal_decoder* decoder);
+
+/** The number of channels stored in the file. */
+uint32_t oal_decoder_channels(const oal_decoder* decoder);
+
+/** The total number of frames in the file, or 0 if unknown. */
+int64_t oal_decoder_total_frames(const oal_decoder* decoder);
+
+/** The number of channels per frame returned by oal_decoder_read(). */
+uint32_t oal_decoder_output_channels(const oal_decoder* decoder);
+
+/** Set the number of channels per frame returned by oal_decoder_read().
+ * Reducing to 1 channel averages all channels, and reducing to 2 channels
+ * folds surround channels into the front pair. Any other reduction keeps
+ * the leading channels. The default is the number of channels in the file.
+ *
+ * @param decoder The decoder.
+ * @param channels The number of output channels (1 to the number of channels in the file).
+ * @return true if the setting was accepted.
+ */
+bool oal_decoder_set_output_channels(oal_decoder* decoder, uint32_t channels);
+
+/** True if the file stores floating point samples, which can be decoded to float. */
+bool oal_decoder_is_float(const oal_decoder* decoder);
+
+/** True if oal_decoder_read() produces 32-bit float rather than 16-bit samples. */
+bool oal_decoder_output_float(const oal_decoder* decoder);
+
+/** Choose between 16-bit (the default) and 32-bit float output.
+ *
+ * @param decoder The decoder.
+ * @param output_float true for float output. Only possible if oal_decoder_is_float() is true.
+ * @return true if the setting was accepted.
+ */
+bool oal_decoder_set_output_float(oal_decoder* decoder, bool output_float);
+
+/** Move the read position.
+ *
+ * @param decoder The decoder.
+ * @param frame The frame to read from next.
+ * @return true if the operation was successful.
+ */
+bool oal_decoder_seek(oal_decoder* decoder, int64_t frame);
+
+/** Decode audio frames from the current read position.
+ *
+ * @param decoder The decoder.
+ * @param dst Where to write the frames. Must hold frames * output channels samples,
+ *            which are int16_t, or float if oal_decoder_output_float() is true.
+ * @param frames The maximum number of frames to decode.
+ * @return The number of frames decoded (0 at end of stream or on error).
+ */
+uint32_t oal_decoder_read(oal_decoder* decoder, void* dst, uint32_t frames);
+
+/** Build the seek table now, rather than on the first seek that needs it.
+ * Formats that seek in constant time anyway have no seek table, and always succeed.
+ * The read position is preserved.
+ *
+ * @param decoder The decoder.
+ * @return true if the decoder can now seek in constant time.
+ */
+bool oal_decoder_build_seek_table(oal_decoder* decoder);
+
+/** Save the decoder's seek table so it can be loaded the next time the file is opened.
+ *
+ * @param decoder The decoder.
+ * @param path Where to save the table.
+ * @return true if a table was saved (false if the decoder has not built one).
+ */
+bool oal_decoder_save_seek_table(oal_decoder* decoder, const char* path);
+
+/** Load a seek table saved by oal_decoder_save_seek_table().
+ * The table is rejected if the audio file has been modified since it was saved.
+ *
+ * @param decoder The decoder.
+ * @param path The saved table.
+ * @return true if the table was loaded.
+ */
+bool oal_decoder_load_seek_table(oal_decoder* decoder, const char* path);
+
+/** Decode audio frames from the current read position using several threads.
+ * Each thread opens the file separately and decodes its own range straight into
+ * dst. The seek table is built (or loaded) once and shared with every thread.
+ * The result is identical to oal_decoder_read(). Formats that can't be split
+ * (or requests too small to benefit) are decoded on the calling thread.
+ *
+ * @param decoder The decoder.
+ * @param dst Where to write the frames. Must hold frames * output channels samples.
+ * @param frames The maximum number of frames to decode.
+ * @param max_threads The maximum number of threads to use (0 = one per CPU).
+ * @return The number of frames decoded (0 at end of stream or on error).
+ */
+uint32_t oal_decoder_read_parallel(oal_decoder* decoder, void* dst, uint32_t frames, uint32_t max_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_DECODER_H */
@@ -0,0 +1,113 @@
+//
+//  oal_decoder_backend.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+/* (INTERNAL USE) The interface implemented by each decoder backend. */
+
+#ifndef OAL_DECODER_BACKEND_H
+#define OAL_DECODER_BACKEND_H
+
+#include "oal_decoder.h"
+#include "ObjectALConfig.h"
+
+/** (INTERNAL USE) Basic properties of an opened stream, filled in by a backend. */
+typedef struct
+{
+	uint32_t sample_rate;
+	uint32_t channels;
+	/** 0 if unknown. */
+	int64_t total_frames;
+	/** True if the file stores floating point samples (the backend must implement read_float). */
+	bool is_float;
+} oal_decoder_info;
+
+/** (INTERNAL USE) A decoder backend. */
+typedef struct
+{
+	/** A short name for the format. */
+	const char* name;
+
+	/** Check if a file header belongs to this format.
+	 * header contains the first length bytes of the file.
+	 */
+	bool (*probe)(const uint8_t* header, size_t length);
+
+	/** Open a file, filling in info.
+	 * Returns backend state, or NULL on failure.
+	 */
+	void* (*open)(const char* path, oal_decoder_info* info);
+
+	/** Decode up to frames frames of interleaved 16-bit PCM (all channels) into dst.
+	 * Returns the number of frames decoded, 0 at end of stream.
+	 */
+	uint32_t (*read)(void* state, int16_t* dst, uint32_t frames);
+
+	/** Move the read position to frame. */
+	bool (*seek)(void* state, int64_t frame);
+
+	/** Free all resources held by state. */
+	void (*close)(void* state);
+
+	/** True if seeking is sample exact and cheap, so that ranges of a file
+	 * can be decoded independently and joined.
+	 */
+	bool independent_ranges;
+
+	/** Build a seek table for constant time seeking. Optional (NULL if not needed).
+	 * May leave the read position anywhere.
+	 */
+	bool (*build_seek_table)(void* state);
+
+	/** Copy the seek table into dst if it fits in capacity bytes. Optional.
+	 * Returns the size of the table in bytes, or 0 if there is no table.
+	 */
+	size_t (*export_seek_table)(void* state, void* dst, size_t capacity);
+
+	/** Replace the seek table with one exported earlier. Optional. */
+	bool (*import_seek_table)(void* state, const void* src, size_t size);
+
+	/** Same as read, but decoding to interleaved 32-bit float PCM.
+	 * Optional (NULL if the backend never sets info->is_float).
+	 */
+	uint32_t (*read_float)(void* state, float* dst, uint32_t frames);
+} oal_decoder_backend;
+
+/** The number of header bytes passed to the probe functions. */
+#define OAL_DECODER_PROBE_SIZE 64
+
+extern const oal_decoder_backend oal_decoder_backend_wav;
+extern const oal_decoder_backend oal_decoder_backend_flac;
+#if OBJECTAL_CFG_USE_STB_VORBIS
+extern const oal_decoder_backend oal_decoder_backend_vorbis;
+#endif
+#if OBJECTAL_CFG_USE_OPUSFILE
+extern const oal_decoder_backend oal_decoder_backend_opus;
+#endif
+
+#endif /* OAL_DECODER_BACKEND_H */
@@ -0,0 +1,1018 @@
+//
+//  oal_decoder_flac.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+/* Native FLAC decoder.
+ *
+ * Supports everything the FLAC format allows for up to 8 channels and
+ * 32 bits per sample. Checksums are not verified.
+ */
+
+#include "oal_decoder_backend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/** Size of the file read buffer. */
+#define kReadBufferSize 16384
+
+/** The largest block size permitted by the format. */
+#define kMaxBlockSize 65535
+
+#define kMaxChannels 8
+
+#define kMaxLPCOrder 32
+
+#define kMetadataStreamInfo 0
+
+/** Seeking stops bisecting the file once the search range is this small (in bytes). */
+#define kSeekLinearRange 32768
+
+/** The number of frames between seek table entries. */
+#define kSeekTableSpacing 8192
+
+/** Identifies exported seek tables. */
+#define kSeekTableVersion 1
+
+/** Seeks up to this many blocks ahead just decode forward. */
+#define kSeekDecodeAheadBlocks 4
+
+enum
+{
+	kChannelsIndependent = 0,
+	kChannelsLeftSide = 8,
+	kChannelsRightSide = 9,
+	kChannelsMidSide = 10,
+};
+
+typedef struct
+{
+	FILE* file;
+	uint8_t buffer[kReadBufferSize];
+	size_t position;
+	size_t length;
+	/** Unread bits, left aligned. */
+	uint64_t cache;
+	int bits;
+	bool error;
+} bit_reader;
+
+typedef struct
+{
+	bit_reader reader;
+	long first_frame_offset;
+	long file_size;
+
+	uint32_t channels;
+	uint32_t bits_per_sample;
+	uint32_t sample_rate;
+	uint32_t min_block_size;
+	uint32_t max_block_size;
+	int64_t total_frames;
+
+	/** Decoded samples of the current block, one run of max_block_size per channel. */
+	int32_t* samples;
+	/** The frame number of the first frame in the current block. */
+	int64_t block_start;
+	uint32_t block_size;
+	/** Frames of the current block already returned. */
+	uint32_t block_position;
+
+	/** Entry i holds the file offset of the frame containing frame i * kSeekTableSpacing.
+	 * Built on the first seek that needs it.
+	 */
+	uint64_t* seek_table;
+	size_t seek_table_length;
+	bool seek_table_failed;
+} flac_state;
+
+typedef struct
+{
+	int64_t first_sample;
+	uint32_t block_size;
+	uint32_t assignment;
+	uint32_t bits_per_sample;
+} frame_header;
+
+
+// Bit reader
+
+static void reader_reset(bit_reader* reader)
+{
+	reader->position = reader->length = 0;
+	reader->cache = 0;
+	reader->bits = 0;
+	reader->error = false;
+}
+
+static void reader_refill(bit_reader* reader)
+{
+	while(reader->bits <= 56)
+	{
+		if(reader->position == reader->length)
+		{
+			reader->length = fread(reader->buffer, 1, sizeof(reader->buffer), reader->file);
+			reader->position = 0;
+			if(0 == reader->length)
+			{
+				return;
+			}
+		}
+		reader->cache |= (uint64_t)reader->buffer[reader->position++] << (56 - reader->bits);
+		reader->bits += 8;
+	}
+}
+
+static uint32_t read_bits(bit_reader* reader, int count)
+{
+	if(0 == count)
+	{
+		return 0;
+	}
+	if(reader->bits < count)
+	{
+		reader_refill(reader);
+		if(reader->bits < count)
+		{
+			reader->error = true;
+			reader->bits = 0;
+			reader->cache = 0;
+			return 0;
+		}
+	}
+	uint32_t value = (uint32_t)(reader->cache >> (64 - count));
+	reader->cache <<= count;
+	reader->bits -= count;
+	return value;
+}
+
+static int32_t read_signed_bits(bit_reader* reader, int count)
+{
+	if(0 == count)
+	{
+		return 0;
+	}
+	uint32_t value = read_bits(reader, count);
+	// Sign extend.
+	uint32_t sign = 1u << (count - 1);
+	return (int32_t)((value ^ sign) - sign);
+}
+
+static int count_leading_zeros(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_clzll(value);
+#else
+	int count = 0;
+	while(!(value & 0x8000000000000000ull))
+	{
+		value <<= 1;
+		count++;
+	}
+	return count;
+#endif
+}
+
+static uint32_t read_unary(bit_reader* reader)
+{
+	uint32_t count = 0;
+	for(;;)
+	{
+		if(0 == reader->bits)
+		{
+			reader_refill(reader);
+			if(0 == reader->bits)
+			{
+				reader->error = true;
+				return count;
+			}
+		}
+		if(0 == reader->cache)
+		{
+			// All buffered bits are zero.
+			count += (uint32_t)reader->bits;
+			reader->bits = 0;
+			continue;
+		}
+		int zeros = count_leading_zeros(reader->cache);
+		count += (uint32_t)zeros;
+		reader->cache = zeros >= 63 ? 0 : reader->cache << (zeros + 1);
+		reader->bits -= zeros + 1;
+		return count;
+	}
+}
+
+static void align_to_byte(bit_reader* reader)
+{
+	int extra = reader->bits % 8;
+	reader->cache <<= extra;
+	reader->bits -= extra;
+}
+
+
+// Frame decoding
+
+static bool decode_residual(bit_reader* reader, int32_t* residual, uint32_t block_size, uint32_t order)
+{
+	uint32_t method = read_bits(reader, 2);
+	if(method > 1)
+	{
+		return false;
+	}
+	int param_bits = 0 == method ? 4 : 5;
+	uint32_t escape = 0 == method ? 15 : 31;
+	uint32_t partition_order = read_bits(reader, 4);
+	uint32_t partitions = 1u << partition_order;
+	uint32_t partition_size = block_size >> partition_order;
+	if(partition_size < order || partition_size << partition_order != block_size)
+	{
+		return false;
+	}
+
+	int32_t* out = residual;
+	for(uint32_t partition = 0; partition < partitions; partition++)
+	{
+		uint32_t count = 0 == partition ? partition_size - order : partition_size;
+		uint32_t param = read_bits(reader, param_bits);
+		if(escape == param)
+		{
+			int raw_bits = (int)read_bits(reader, 5);
+			for(uint32_t i = 0; i < count; i++)
+			{
+				*out++ = read_signed_bits(reader, raw_bits);
+			}
+		}
+		else
+		{
+			for(uint32_t i = 0; i < count; i++)
+			{
+				uint32_t value = (read_unary(reader) << param) | read_bits(reader, (int)param);
+				*out++ = (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+			}
+		}
+		if(reader->error)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool decode_subframe(bit_reader* reader, int32_t* samples, uint32_t block_size, uint32_t bits_per_sample)
+{
+	static const int32_t fixed_coefficients[5][4] =
+	{
+		{0, 0, 0, 0},
+		{1, 0, 0, 0},
+		{2, -1, 0, 0},
+		{3, -3, 1, 0},
+		{4, -6, 4, -1},
+	};
+	int32_t coefficients[kMaxLPCOrder];
+	int shift = 0;
+	uint32_t order;
+
+	if(0 != read_bits(reader, 1))
+	{
+		return false;
+	}
+	uint32_t type = read_bits(reader, 6);
+	uint32_t wasted_bits = 0;
+	if(read_bits(reader, 1))
+	{
+		wasted_bits = read_unary(reader) + 1;
+		if(wasted_bits >= bits_per_sample)
+		{
+			return false;
+		}
+		bits_per_sample -= wasted_bits;
+	}
+
+	if(bits_per_sample > 32)
+	{
+		return false;
+	}
+
+	if(0 == type)
+	{
+		int32_t value = read_signed_bits(reader, (int)bits_per_sample);
+		for(uint32_t i = 0; i < block_size; i++)
+		{
+			samples[i] = value;
+		}
+	}
+	else if(1 == type)
+	{
+		for(uint32_t i = 0; i < block_size; i++)
+		{
+			samples[i] = read_signed_bits(reader, (int)bits_per_sample);
+		}
+	}
+	else
+	{
+		if(type >= 8 && type <= 12)
+		{
+			order = type - 8;
+			for(uint32_t i = 0; i < order; i++)
+			{
+				coefficients[i] = fixed_coefficients[order][i];
+			}
+		}
+		else if(type >= 32)
+		{
+			order = type - 31;
+		}
+		else
+		{
+			return false;
+		}
+		if(order > block_size)
+		{
+			return false;
+		}
+
+		for(uint32_t i = 0; i < order; i++)
+		{
+			samples[i] = read_signed_bits(reader, (int)bits_per_sample);
+		}
+		if(type >= 32)
+		{
+			uint32_t precision = read_bits(reader, 4) + 1;
+			if(16 == precision)
+			{
+				return false;
+			}
+			shift = read_signed_bits(reader, 5);
+			if(shift < 0)
+			{
+				return false;
+			}
+			for(uint32_t i = 0; i < order; i++)
+			{
+				coefficients[i] = read_signed_bits(reader, (int)precision);
+			}
+		}
+		if(!decode_residual(reader, samples + order, block_size, order))
+		{
+			return false;
+		}
+
+		// Restore the signal from the prediction residual.
+		for(uint32_t i = order; i < block_size; i++)
+		{
+			int64_t prediction = 0;
+			for(uint32_t j = 0; j < order; j++)
+			{
+				prediction += (int64_t)coefficients[j] * samples[i - j - 1];
+			}
+			samples[i] += (int32_t)(prediction >> shift);
+		}
+	}
+
+	if(wasted_bits > 0)
+	{
+		for(uint32_t i = 0; i < block_size; i++)
+		{
+			samples[i] = (int32_t)((uint32_t)samples[i] << wasted_bits);
+		}
+	}
+	return !reader->error;
+}
+
+static uint8_t crc8(const uint8_t* data, size_t length)
+{
+	uint8_t crc = 0;
+	while(length-- > 0)
+	{
+		crc ^= *data++;
+		for(int i = 0; i < 8; i++)
+		{
+			crc = (uint8_t)((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+		}
+	}
+	return crc;
+}
+
+/** The byte offset in the file of the next unread byte. Only valid when byte aligned. */
+static long reader_tell(bit_reader* reader)
+{
+	return ftell(reader->file) - (long)(reader->length - reader->position) - reader->bits / 8;
+}
+
+static bool reader_seek(bit_reader* reader, long offset)
+{
+	reader_reset(reader);
+	return 0 == fseek(reader->file, offset, SEEK_SET);
+}
+
+/** Find the next frame sync code, leaving the reader just past it.
+ * Returns the second sync byte, or 0 at end of stream.
+ */
+static uint32_t find_sync(bit_reader* reader)
+{
+	align_to_byte(reader);
+	uint32_t previous = read_bits(reader, 8);
+	while(!reader->error)
+	{
+		uint32_t current = read_bits(reader, 8);
+		if(0xff == previous && 0xf8 == (current & 0xfe))
+		{
+			return current;
+		}
+		previous = current;
+	}
+	return 0;
+}
+
+/** Read and validate the rest of a frame header following a sync code. */
+static bool read_frame_header(flac_state* flac, uint32_t sync, frame_header* header)
+{
+	static const uint32_t sample_sizes[8] = {0, 8, 12, 0, 16, 20, 24, 32};
+	bit_reader* reader = &flac->reader;
+	uint8_t bytes[16];
+	size_t length = 0;
+
+	bytes[length++] = 0xff;
+	bytes[length++] = (uint8_t)sync;
+	bytes[length++] = (uint8_t)read_bits(reader, 8);
+	bytes[length++] = (uint8_t)read_bits(reader, 8);
+	uint32_t block_size_code = bytes[2] >> 4;
+	uint32_t sample_rate_code = bytes[2] & 0x0f;
+	uint32_t sample_size_code = (bytes[3] >> 1) & 0x07;
+	header->assignment = bytes[3] >> 4;
+
+	// Frame or sample number, UTF-8 style.
+	uint32_t first = read_bits(reader, 8);
+	bytes[length++] = (uint8_t)first;
+	int extra_bytes = 0;
+	while(extra_bytes < 8 && (first & (0x80u >> extra_bytes)))
+	{
+		extra_bytes++;
+	}
+	if(1 == extra_bytes || 8 == extra_bytes)
+	{
+		return false;
+	}
+	extra_bytes = extra_bytes > 0 ? extra_bytes - 1 : 0;
+	uint64_t number = first & (0x7fu >> (extra_bytes > 0 ? extra_bytes + 1 : 0));
+	for(int i = 0; i < extra_bytes; i++)
+	{
+		uint32_t next = read_bits(reader, 8);
+		if(0x80 != (next & 0xc0))
+		{
+			return false;
+		}
+		bytes[length++] = (uint8_t)next;
+		number = (number << 6) | (next & 0x3f);
+	}
+
+	if(0 == block_size_code)
+	{
+		return false;
+	}
+	else if(1 == block_size_code)
+	{
+		header->block_size = 192;
+	}
+	else if(block_size_code <= 5)
+	{
+		header->block_size = 576u << (block_size_code - 2);
+	}
+	else if(6 == block_size_code)
+	{
+		bytes[length++] = (uint8_t)read_bits(reader, 8);
+		header->block_size = bytes[length - 1] + 1u;
+	}
+	else if(7 == block_size_code)
+	{
+		bytes[length++] = (uint8_t)read_bits(reader, 8);
+		bytes[length++] = (uint8_t)read_bits(reader, 8);
+		header->block_size = (((uint32_t)bytes[length - 2] << 8) | bytes[length - 1]) + 1u;
+	}
+	else
+	{
+		header->block_size = 256u << (block_size_code - 8);
+	}
+
+	if(12 == sample_rate_code)
+	{
+		bytes[length++] = (uint8_t)read_bits(reader, 8);
+	}
+	else if(13 == sample_rate_code || 14 == sample_rate_code)
+	{
+		bytes[length++] = (uint8_t)read_bits(reader, 8);
+		bytes[length++] = (uint8_t)read_bits(reader, 8);
+	}
+	else if(15 == sample_rate_code)
+	{
+		return false;
+	}
+
+	if(read_bits(reader, 8) != crc8(bytes, length) || reader->error)
+	{
+		return false;
+	}
+
+	// Fixed block size streams count frames instead of samples.
+	bool variable_block_size = sync & 1;
+	header->first_sample = (int64_t)(variable_block_size ? number : number * flac->min_block_size);
+	header->bits_per_sample = 0 == sample_size_code ? flac->bits_per_sample : sample_sizes[sample_size_code];
+	uint32_t channels = header->assignment < kChannelsLeftSide ? header->assignment + 1 : 2;
+	return 0 != header->bits_per_sample &&
+		header->assignment <= kChannelsMidSide &&
+		channels == flac->channels &&
+		header->block_size <= flac->max_block_size;
+}
+
+/** Find the next valid frame header, returning the file offset of its start (or -1 at end of stream). */
+static long next_frame_header(flac_state* flac, frame_header* header)
+{
+	bit_reader* reader = &flac->reader;
+	for(;;)
+	{
+		uint32_t sync = find_sync(reader);
+		if(0 == sync)
+		{
+			return -1;
+		}
+		long offset = reader_tell(reader) - 2;
+		if(read_frame_header(flac, sync, header))
+		{
+			return offset;
+		}
+		// A false sync. Resume the search just after it.
+		if(!reader_seek(reader, offset + 1))
+		{
+			return -1;
+		}
+	}
+}
+
+static bool decode_frame(flac_state* flac)
+{
+	bit_reader* reader = &flac->reader;
+	frame_header header;
+
+	if(next_frame_header(flac, &header) < 0)
+	{
+		return false;
+	}
+
+	uint32_t assignment = header.assignment;
+	uint32_t block_size = header.block_size;
+	uint32_t bits_per_sample = header.bits_per_sample;
+	uint32_t channels = flac->channels;
+
+	for(uint32_t ch = 0; ch < channels; ch++)
+	{
+		// The side channel needs an extra bit.
+		uint32_t channel_bits = bits_per_sample;
+		if((kChannelsLeftSide == assignment && 1 == ch) ||
+		   (kChannelsRightSide == assignment && 0 == ch) ||
+		   (kChannelsMidSide == assignment && 1 == ch))
+		{
+			channel_bits++;
+		}
+		if(!decode_subframe(reader, flac->samples + ch * flac->max_block_size, block_size, channel_bits))
+		{
+			return false;
+		}
+	}
+
+	// Padding and CRC-16
+	align_to_byte(reader);
+	read_bits(reader, 16);
+
+	int32_t* left = flac->samples;
+	int32_t* right = flac->samples + flac->max_block_size;
+	switch(assignment)
+	{
+		case kChannelsLeftSide:
+			for(uint32_t i = 0; i < block_size; i++)
+			{
+				right[i] = left[i] - right[i];
+			}
+			break;
+		case kChannelsRightSide:
+			for(uint32_t i = 0; i < block_size; i++)
+			{
+				left[i] += right[i];
+			}
+			break;
+		case kChannelsMidSide:
+			for(uint32_t i = 0; i < block_size; i++)
+			{
+				int32_t side = right[i];
+				int32_t mid = (int32_t)((uint32_t)left[i] << 1) | (side & 1);
+				left[i] = (mid + side) >> 1;
+				right[i] = (mid - side) >> 1;
+			}
+			break;
+	}
+
+	flac->block_start = header.first_sample;
+	flac->block_size = block_size;
+	flac->block_position = 0;
+	return true;
+}
+
+
+// Backend
+
+static bool flac_probe(const uint8_t* header, size_t length)
+{
+	return length >= 4 && 0 == memcmp(header, "fLaC", 4);
+}
+
+static void flac_close(void* state)
+{
+	flac_state* flac = state;
+	if(NULL != flac->reader.file)
+	{
+		fclose(flac->reader.file);
+	}
+	free(flac->samples);
+	free(flac->seek_table);
+	free(flac);
+}
+
+static void* flac_open(const char* path, oal_decoder_info* info)
+{
+	uint8_t marker[4];
+	uint8_t header[4];
+	uint8_t stream_info[34];
+	bool have_stream_info = false;
+
+	flac_state* flac = calloc(1, sizeof(*flac));
+	if(NULL == flac)
+	{
+		return NULL;
+	}
+	FILE* file = flac->reader.file = fopen(path, "rb");
+	if(NULL == file || 1 != fread(marker, sizeof(marker), 1, file))
+	{
+		goto fail;
+	}
+
+	for(bool last = false; !last;)
+	{
+		if(1 != fread(header, sizeof(header), 1, file))
+		{
+			goto fail;
+		}
+		last = 0 != (header[0] & 0x80);
+		uint32_t type = header[0] & 0x7f;
+		long length = ((long)header[1] << 16) | ((long)header[2] << 8) | header[3];
+		if(kMetadataStreamInfo == type && length >= (long)sizeof(stream_info))
+		{
+			if(1 != fread(stream_info, sizeof(stream_info), 1, file))
+			{
+				goto fail;
+			}
+			length -= (long)sizeof(stream_info);
+			have_stream_info = true;
+		}
+		if(0 != fseek(file, length, SEEK_CUR))
+		{
+			goto fail;
+		}
+	}
+	if(!have_stream_info)
+	{
+		goto fail;
+	}
+
+	flac->min_block_size = ((uint32_t)stream_info[0] << 8) | stream_info[1];
+	flac->max_block_size = ((uint32_t)stream_info[2] << 8) | stream_info[3];
+	flac->sample_rate = ((uint32_t)stream_info[10] << 12) | ((uint32_t)stream_info[11] << 4) | (stream_info[12] >> 4);
+	flac->channels = ((stream_info[12] >> 1) & 0x07) + 1;
+	flac->bits_per_sample = (((uint32_t)(stream_info[12] & 0x01) << 4) | (stream_info[13] >> 4)) + 1;
+	flac->total_frames = ((int64_t)(stream_info[13] & 0x0f) << 32) |
+		((int64_t)stream_info[14] << 24) |
+		((int64_t)stream_info[15] << 16) |
+		((int64_t)stream_info[16] << 8) |
+		stream_info[17];
+	if(flac->max_block_size < 16)
+	{
+		flac->max_block_size = kMaxBlockSize;
+	}
+	if(flac->channels > kMaxChannels || flac->bits_per_sample < 4)
+	{
+		goto fail;
+	}
+
+	flac->samples = malloc((size_t)flac->max_block_size * flac->channels * sizeof(*flac->samples));
+	if(NULL == flac->samples)
+	{
+		goto fail;
+	}
+	flac->first_frame_offset = ftell(file);
+	if(0 != fseek(file, 0, SEEK_END))
+	{
+		goto fail;
+	}
+	flac->file_size = ftell(file);
+	if(!reader_seek(&flac->reader, flac->first_frame_offset))
+	{
+		goto fail;
+	}
+
+	info->sample_rate = flac->sample_rate;
+	info->channels = flac->channels;
+	info->total_frames = flac->total_frames;
+	return flac;
+
+fail:
+	flac_close(flac);
+	return NULL;
+}
+
+static uint32_t flac_read(void* state, int16_t* dst, uint32_t frames)
+{
+	flac_state* flac = state;
+	uint32_t channels = flac->channels;
+	int down_shift = flac->bits_per_sample > 16 ? (int)flac->bits_per_sample - 16 : 0;
+	int up_shift = flac->bits_per_sample < 16 ? 16 - (int)flac->bits_per_sample : 0;
+	uint32_t frames_read = 0;
+
+	while(frames_read < frames)
+	{
+		if(flac->block_position == flac->block_size)
+		{
+			if(!decode_frame(flac))
+			{
+				break;
+			}
+		}
+
+		uint32_t count = flac->block_size - flac->block_position;
+		if(count > frames - frames_read)
+		{
+			count = frames - frames_read;
+		}
+		for(uint32_t ch = 0; ch < channels; ch++)
+		{
+			const int32_t* src = flac->samples + ch * flac->max_block_size + flac->block_position;
+			int16_t* out = dst + frames_read * channels + ch;
+			for(uint32_t i = 0; i < count; i++, out += channels)
+			{
+				*out = (int16_t)((src[i] >> down_shift) * (1 << up_shift));
+			}
+		}
+		flac->block_position += count;
+		frames_read += count;
+	}
+	return frames_read;
+}
+
+/** Start decoding from a file offset. */
+static bool restart_at(flac_state* flac, long offset)
+{
+	if(!reader_seek(&flac->reader, offset))
+	{
+		return false;
+	}
+	flac->block_start = 0;
+	flac->block_size = 0;
+	flac->block_position = 0;
+	return true;
+}
+
+/** Position the reader at a frame starting at or before the target, as close to it as is cheap to find.
+ * Bisects the file on frame header sample numbers, so only a small stretch needs decoding afterwards.
+ */
+static bool locate_frame(flac_state* flac, int64_t frame)
+{
+	bit_reader* reader = &flac->reader;
+	frame_header header;
+	long low = flac->first_frame_offset;
+	long high = flac->file_size;
+
+	while(high - low > kSeekLinearRange)
+	{
+		long middle = low + (high - low) / 2;
+		if(!reader_seek(reader, middle))
+		{
+			return false;
+		}
+		long offset = next_frame_header(flac, &header);
+		if(offset < 0 || offset >= high || header.first_sample > frame)
+		{
+			high = middle;
+		}
+		else
+		{
+			low = offset;
+			if(frame < header.first_sample + header.block_size)
+			{
+				break;
+			}
+		}
+	}
+
+	return restart_at(flac, low);
+}
+
+/** Scan the frame headers of the whole file to build the seek table.
+ * This reads the file but decodes nothing, so it's far cheaper than a decode pass.
+ * Leaves the read position undefined.
+ */
+static bool flac_build_seek_table(void* state)
+{
+	flac_state* flac = state;
+	frame_header header;
+
+	if(NULL != flac->seek_table)
+	{
+		return true;
+	}
+	if(flac->seek_table_failed || flac->total_frames <= 0)
+	{
+		return false;
+	}
+
+	size_t length = (size_t)((flac->total_frames - 1) / kSeekTableSpacing) + 1;
+	uint64_t* table = malloc(length * sizeof(*table));
+	if(NULL == table || !restart_at(flac, flac->first_frame_offset))
+	{
+		free(table);
+		return false;
+	}
+
+	size_t filled = 0;
+	int64_t expected = 0;
+	while(filled < length)
+	{
+		long offset = next_frame_header(flac, &header);
+		if(offset < 0)
+		{
+			break;
+		}
+		if(header.first_sample != expected)
+		{
+			// A sync code inside frame data that happened to pass the header checks.
+			if(!reader_seek(&flac->reader, offset + 1))
+			{
+				break;
+			}
+			continue;
+		}
+		expected += header.block_size;
+		while(filled < length && (int64_t)filled * kSeekTableSpacing < expected)
+		{
+			table[filled++] = (uint64_t)offset;
+		}
+	}
+	restart_at(flac, flac->first_frame_offset);
+
+	if(filled < length)
+	{
+		// Don't try again on every seek.
+		flac->seek_table_failed = true;
+		free(table);
+		return false;
+	}
+	flac->seek_table = table;
+	flac->seek_table_length = length;
+	return true;
+}
+
+static size_t flac_export_seek_table(void* state, void* dst, size_t capacity)
+{
+	flac_state* flac = state;
+	if(NULL == flac->seek_table)
+	{
+		return 0;
+	}
+	uint32_t fields[2] = {kSeekTableVersion, kSeekTableSpacing};
+	size_t size = sizeof(fields) + flac->seek_table_length * sizeof(*flac->seek_table);
+	if(NULL != dst && capacity >= size)
+	{
+		memcpy(dst, fields, sizeof(fields));
+		memcpy((uint8_t*)dst + sizeof(fields), flac->seek_table, size - sizeof(fields));
+	}
+	return size;
+}
+
+static bool flac_import_seek_table(void* state, const void* src, size_t size)
+{
+	flac_state* flac = state;
+	uint32_t fields[2];
+	if(flac->total_frames <= 0 || size < sizeof(fields))
+	{
+		return false;
+	}
+	memcpy(fields, src, sizeof(fields));
+	size_t length = (size_t)((flac->total_frames - 1) / kSeekTableSpacing) + 1;
+	if(kSeekTableVersion != fields[0] ||
+	   kSeekTableSpacing != fields[1] ||
+	   size != sizeof(fields) + length * sizeof(*flac->seek_table))
+	{
+		return false;
+	}
+
+	uint64_t* table = malloc(length * sizeof(*table));
+	if(NULL == table)
+	{
+		return false;
+	}
+	memcpy(table, (const uint8_t*)src + sizeof(fields), length * sizeof(*table));
+	for(size_t i = 0; i < length; i++)
+	{
+		if(table[i] < (uint64_t)flac->first_frame_offset || table[i] >= (uint64_t)flac->file_size)
+		{
+			free(table);
+			return false;
+		}
+	}
+	free(flac->seek_table);
+	flac->seek_table = table;
+	flac->seek_table_length = length;
+	return true;
+}
+
+static bool flac_seek(void* state, int64_t frame)
+{
+	flac_state* flac = state;
+
+	// Decode forward if the target is close by, otherwise jump.
+	int64_t block_end = flac->block_start + flac->block_size;
+	if(frame < flac->block_start || frame > block_end + (int64_t)flac->max_block_size * kSeekDecodeAheadBlocks)
+	{
+		if(flac_build_seek_table(flac))
+		{
+			size_t index = (size_t)(frame / kSeekTableSpacing);
+			if(index >= flac->seek_table_length)
+			{
+				index = flac->seek_table_length - 1;
+			}
+			if(!restart_at(flac, (long)flac->seek_table[index]))
+			{
+				return false;
+			}
+		}
+		else if(!locate_frame(flac, frame))
+		{
+			return false;
+		}
+	}
+
+	while(frame >= flac->block_start + flac->block_size)
+	{
+		if(!decode_frame(flac))
+		{
+			// Seeking to the very end is fine.
+			if(frame == flac->block_start + flac->block_size)
+			{
+				flac->block_position = flac->block_size;
+				return true;
+			}
+			return false;
+		}
+	}
+	flac->block_position = (uint32_t)(frame - flac->block_start);
+	return true;
+}
+
+
+const oal_decoder_backend oal_decoder_backend_flac =
+{
+	"flac",
+	flac_probe,
+	flac_open,
+	flac_read,
+	flac_seek,
+	flac_close,
+	true,
+	flac_build_seek_table,
+	flac_export_seek_table,
+	flac_import_seek_table,
+	NULL,
+};
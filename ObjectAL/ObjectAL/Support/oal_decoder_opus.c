@@ -0,0 +1,134 @@
+//
+//  oal_decoder_opus.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+/* Ogg Opus decoder, backed by libopusfile (https://opus-codec.org).
+ * Only built when OBJECTAL_CFG_USE_OPUSFILE is enabled.
+ */
+
+#include "oal_decoder_backend.h"
+
+#if OBJECTAL_CFG_USE_OPUSFILE
+
+#include <stdlib.h>
+#include <string.h>
+#include <opus/opusfile.h>
+
+
+/** Offset of the first packet in an Ogg stream's first page. */
+#define kOggFirstPacketOffset 28
+
+/** Opus always decodes at 48kHz. */
+#define kOpusSampleRate 48000
+
+typedef struct
+{
+	OggOpusFile* opus;
+	uint32_t channels;
+} opus_state;
+
+
+static bool opus_probe(const uint8_t* header, size_t length)
+{
+	return length >= kOggFirstPacketOffset + 8 &&
+		0 == memcmp(header, "OggS", 4) &&
+		0 == memcmp(header + kOggFirstPacketOffset, "OpusHead", 8);
+}
+
+static void opus_close(void* state)
+{
+	opus_state* opus = state;
+	if(NULL != opus->opus)
+	{
+		op_free(opus->opus);
+	}
+	free(opus);
+}
+
+static void* opus_open(const char* path, oal_decoder_info* info)
+{
+	int error = 0;
+	opus_state* opus = calloc(1, sizeof(*opus));
+	if(NULL == opus)
+	{
+		return NULL;
+	}
+	opus->opus = op_open_file(path, &error);
+	if(NULL == opus->opus)
+	{
+		opus_close(opus);
+		return NULL;
+	}
+
+	opus->channels = (uint32_t)op_channel_count(opus->opus, -1);
+	info->channels = opus->channels;
+	info->sample_rate = kOpusSampleRate;
+	ogg_int64_t total = op_pcm_total(opus->opus, -1);
+	info->total_frames = total > 0 ? total : 0;
+	return opus;
+}
+
+static uint32_t opus_read(void* state, int16_t* dst, uint32_t frames)
+{
+	opus_state* opus = state;
+	for(;;)
+	{
+		int count = op_read(opus->opus, dst, (int)(frames * opus->channels), NULL);
+		if(OP_HOLE != count)
+		{
+			return count > 0 ? (uint32_t)count : 0;
+		}
+		// A gap in the stream. Skip over it.
+	}
+}
+
+static bool opus_seek(void* state, int64_t frame)
+{
+	opus_state* opus = state;
+	return 0 == op_pcm_seek(opus->opus, frame);
+}
+
+
+const oal_decoder_backend oal_decoder_backend_opus =
+{
+	"opus",
+	opus_probe,
+	opus_open,
+	opus_read,
+	opus_seek,
+	opus_close,
+	// Decoding resumes after a seek with pre-roll, which is not bit exact with continuous decoding.
+	false,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+};
+
+#endif /* OBJECTAL_CFG_USE_OPUSFILE */
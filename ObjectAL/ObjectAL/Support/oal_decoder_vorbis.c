@@ -0,0 +1,127 @@
+//
+//  oal_decoder_vorbis.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+/* Ogg Vorbis decoder, backed by stb_vorbis (https://github.com/nothings/stb).
+ * Only built when OBJECTAL_CFG_USE_STB_VORBIS is enabled.
+ */
+
+#include "oal_decoder_backend.h"
+
+#if OBJECTAL_CFG_USE_STB_VORBIS
+
+#include <string.h>
+
+#define STB_VORBIS_HEADER_ONLY
+#include "stb_vorbis.c"
+
+
+/** Offset of the first packet in an Ogg stream's first page. */
+#define kOggFirstPacketOffset 28
+
+typedef struct
+{
+	stb_vorbis* vorbis;
+	uint32_t channels;
+} vorbis_state;
+
+
+static bool vorbis_probe(const uint8_t* header, size_t length)
+{
+	return length >= kOggFirstPacketOffset + 7 &&
+		0 == memcmp(header, "OggS", 4) &&
+		0 == memcmp(header + kOggFirstPacketOffset, "\x01vorbis", 7);
+}
+
+static void vorbis_close(void* state)
+{
+	vorbis_state* vorbis = state;
+	if(NULL != vorbis->vorbis)
+	{
+		stb_vorbis_close(vorbis->vorbis);
+	}
+	free(vorbis);
+}
+
+static void* vorbis_open(const char* path, oal_decoder_info* info)
+{
+	int error = 0;
+	vorbis_state* vorbis = calloc(1, sizeof(*vorbis));
+	if(NULL == vorbis)
+	{
+		return NULL;
+	}
+	vorbis->vorbis = stb_vorbis_open_filename(path, &error, NULL);
+	if(NULL == vorbis->vorbis)
+	{
+		vorbis_close(vorbis);
+		return NULL;
+	}
+
+	stb_vorbis_info vorbis_info = stb_vorbis_get_info(vorbis->vorbis);
+	vorbis->channels = (uint32_t)vorbis_info.channels;
+	info->channels = vorbis->channels;
+	info->sample_rate = vorbis_info.sample_rate;
+	info->total_frames = stb_vorbis_stream_length_in_samples(vorbis->vorbis);
+	return vorbis;
+}
+
+static uint32_t vorbis_read(void* state, int16_t* dst, uint32_t frames)
+{
+	vorbis_state* vorbis = state;
+	int count = stb_vorbis_get_samples_short_interleaved(vorbis->vorbis,
+														 (int)vorbis->channels,
+														 dst,
+														 (int)(frames * vorbis->channels));
+	return count > 0 ? (uint32_t)count : 0;
+}
+
+static bool vorbis_seek(void* state, int64_t frame)
+{
+	vorbis_state* vorbis = state;
+	return 0 != stb_vorbis_seek(vorbis->vorbis, (unsigned int)frame);
+}
+
+
+const oal_decoder_backend oal_decoder_backend_vorbis =
+{
+	"vorbis",
+	vorbis_probe,
+	vorbis_open,
+	vorbis_read,
+	vorbis_seek,
+	vorbis_close,
+	true,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+};
+
+#endif /* OBJECTAL_CFG_USE_STB_VORBIS */
@@ -0,0 +1,413 @@
+//
+//  oal_decoder_wav.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+/* RIFF WAVE decoder for uncompressed integer and floating point PCM. */
+
+#include "oal_decoder_backend.h"
+#include "oal_convert.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define kFormatPCM        0x0001
+#define kFormatFloat      0x0003
+#define kFormatExtensible 0xfffe
+
+/** Size of the raw read buffer used when samples must be converted. */
+#define kRawBufferSize 8192
+
+typedef struct
+{
+	FILE* file;
+	long data_offset;
+	int64_t total_frames;
+	int64_t position;
+	uint32_t channels;
+	uint32_t bytes_per_sample;
+	bool is_float;
+	/** Aligned so that it can be read as 32-bit samples. */
+	uint8_t raw[kRawBufferSize] __attribute__((aligned(16)));
+} wav_state;
+
+
+static uint32_t read_le16(const uint8_t* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static uint32_t read_le32(const uint8_t* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool is_little_endian_host(void)
+{
+	const uint16_t value = 1;
+	return 1 == *(const uint8_t*)&value;
+}
+
+static int16_t clamp_float_sample(float value)
+{
+	value *= 32768.0f;
+	if(value >= 32767.0f)
+	{
+		return 32767;
+	}
+	if(value <= -32768.0f)
+	{
+		return -32768;
+	}
+	return (int16_t)value;
+}
+
+/** Convert little endian samples of any supported type to native 16-bit. */
+static void convert_samples(const wav_state* wav, const uint8_t* src, int16_t* dst, size_t count)
+{
+	switch(wav->bytes_per_sample)
+	{
+		case 1:
+			// 8-bit WAV data is unsigned.
+			oal_convert_u8_to_s16(src, dst, count);
+			break;
+		case 2:
+			memcpy(dst, src, count * sizeof(*dst));
+			if(!is_little_endian_host())
+			{
+				oal_convert_swap_s16(dst, count);
+			}
+			break;
+		case 3:
+			oal_convert_s24le_to_s16(src, dst, count);
+			break;
+		case 4:
+			if(is_little_endian_host())
+			{
+				if(wav->is_float)
+				{
+					// No dither, so that any range decodes the same way regardless of where reading started.
+					oal_convert_float_to_s16((const float*)src, dst, count, NULL);
+				}
+				else
+				{
+					oal_convert_s32_to_s16((const int32_t*)src, dst, count);
+				}
+				break;
+			}
+			for(size_t i = 0; i < count; i++, src += 4)
+			{
+				uint32_t bits = read_le32(src);
+				if(wav->is_float)
+				{
+					float value;
+					memcpy(&value, &bits, sizeof(value));
+					dst[i] = clamp_float_sample(value);
+				}
+				else
+				{
+					dst[i] = (int16_t)(bits >> 16);
+				}
+			}
+			break;
+		case 8:
+			for(size_t i = 0; i < count; i++, src += 8)
+			{
+				uint64_t bits = read_le32(src) | ((uint64_t)read_le32(src + 4) << 32);
+				double value;
+				memcpy(&value, &bits, sizeof(value));
+				dst[i] = clamp_float_sample((float)value);
+			}
+			break;
+	}
+}
+
+
+static bool wav_probe(const uint8_t* header, size_t length)
+{
+	return length >= 12 && 0 == memcmp(header, "RIFF", 4) && 0 == memcmp(header + 8, "WAVE", 4);
+}
+
+static void wav_close(void* state)
+{
+	wav_state* wav = state;
+	if(NULL != wav->file)
+	{
+		fclose(wav->file);
+	}
+	free(wav);
+}
+
+static void* wav_open(const char* path, oal_decoder_info* info)
+{
+	uint8_t header[12];
+	uint8_t chunk[8];
+	uint8_t fmt[40];
+	bool have_format = false;
+	uint32_t format_tag = 0;
+	uint32_t bits_per_sample = 0;
+	uint32_t block_align = 0;
+
+	wav_state* wav = calloc(1, sizeof(*wav));
+	if(NULL == wav)
+	{
+		return NULL;
+	}
+	if(NULL == (wav->file = fopen(path, "rb")) ||
+	   1 != fread(header, sizeof(header), 1, wav->file))
+	{
+		goto fail;
+	}
+
+	for(;;)
+	{
+		if(1 != fread(chunk, sizeof(chunk), 1, wav->file))
+		{
+			goto fail;
+		}
+		uint32_t chunk_size = read_le32(chunk + 4);
+
+		if(0 == memcmp(chunk, "fmt ", 4))
+		{
+			if(chunk_size < 16)
+			{
+				goto fail;
+			}
+			size_t fmt_size = chunk_size < sizeof(fmt) ? chunk_size : sizeof(fmt);
+			memset(fmt, 0, sizeof(fmt));
+			if(1 != fread(fmt, fmt_size, 1, wav->file) ||
+			   0 != fseek(wav->file, (long)(chunk_size - fmt_size + (chunk_size & 1)), SEEK_CUR))
+			{
+				goto fail;
+			}
+			format_tag = read_le16(fmt);
+			info->channels = read_le16(fmt + 2);
+			info->sample_rate = read_le32(fmt + 4);
+			block_align = read_le16(fmt + 12);
+			bits_per_sample = read_le16(fmt + 14);
+			if(kFormatExtensible == format_tag && fmt_size >= 26)
+			{
+				// The first two bytes of the sub-format GUID hold the real format tag.
+				format_tag = read_le16(fmt + 24);
+			}
+			have_format = true;
+		}
+		else if(0 == memcmp(chunk, "data", 4))
+		{
+			if(!have_format)
+			{
+				goto fail;
+			}
+			wav->data_offset = ftell(wav->file);
+			break;
+		}
+		else if(0 != fseek(wav->file, (long)(chunk_size + (chunk_size & 1)), SEEK_CUR))
+		{
+			goto fail;
+		}
+	}
+
+	wav->channels = info->channels;
+	if(0 == wav->channels || 0 == bits_per_sample || 0 != block_align % wav->channels)
+	{
+		goto fail;
+	}
+	// Samples may be padded out to a larger container (such as 20 bits in 3 bytes).
+	wav->bytes_per_sample = block_align / wav->channels;
+	wav->is_float = kFormatFloat == format_tag;
+	info->is_float = wav->is_float;
+	if(kFormatPCM == format_tag)
+	{
+		if(wav->bytes_per_sample < 1 || wav->bytes_per_sample > 4)
+		{
+			goto fail;
+		}
+	}
+	else if(kFormatFloat == format_tag)
+	{
+		if(4 != wav->bytes_per_sample && 8 != wav->bytes_per_sample)
+		{
+			goto fail;
+		}
+	}
+	else
+	{
+		// Compressed formats are left to the OS.
+		goto fail;
+	}
+
+	// The data chunk size is unreliable in files that were never finalized, so trust the file size.
+	uint32_t data_size = read_le32(chunk + 4);
+	if(0 != fseek(wav->file, 0, SEEK_END))
+	{
+		goto fail;
+	}
+	long available = ftell(wav->file) - wav->data_offset;
+	if(available < 0 || 0 != fseek(wav->file, wav->data_offset, SEEK_SET))
+	{
+		goto fail;
+	}
+	if(0 == data_size || data_size > (uint32_t)available)
+	{
+		data_size = (uint32_t)available;
+	}
+	wav->total_frames = data_size / block_align;
+	info->total_frames = wav->total_frames;
+	return wav;
+
+fail:
+	wav_close(wav);
+	return NULL;
+}
+
+/** Convert little endian floating point samples to native 32-bit float. */
+static void convert_float_samples(const uint8_t* src, float* dst, size_t count, uint32_t bytes_per_sample)
+{
+	for(size_t i = 0; i < count; i++, src += bytes_per_sample)
+	{
+		if(8 == bytes_per_sample)
+		{
+			uint64_t bits = read_le32(src) | ((uint64_t)read_le32(src + 4) << 32);
+			double value;
+			memcpy(&value, &bits, sizeof(value));
+			dst[i] = (float)value;
+		}
+		else
+		{
+			uint32_t bits = read_le32(src);
+			memcpy(&dst[i], &bits, sizeof(bits));
+		}
+	}
+}
+
+/** Read frames through the raw buffer, converting them to 16-bit or float output. */
+static uint32_t read_converted(wav_state* wav, void* dst, uint32_t frames, bool to_float)
+{
+	size_t frame_size = wav->channels * wav->bytes_per_sample;
+	uint32_t frames_read = 0;
+	size_t frames_per_pass = sizeof(wav->raw) / frame_size;
+	while(frames_read < frames)
+	{
+		size_t wanted = frames - frames_read;
+		if(wanted > frames_per_pass)
+		{
+			wanted = frames_per_pass;
+		}
+		size_t count = fread(wav->raw, frame_size, wanted, wav->file);
+		if(0 == count)
+		{
+			break;
+		}
+		size_t offset = (size_t)frames_read * wav->channels;
+		if(to_float)
+		{
+			convert_float_samples(wav->raw, (float*)dst + offset, count * wav->channels, wav->bytes_per_sample);
+		}
+		else
+		{
+			convert_samples(wav, wav->raw, (int16_t*)dst + offset, count * wav->channels);
+		}
+		frames_read += (uint32_t)count;
+	}
+	wav->position += frames_read;
+	return frames_read;
+}
+
+/** Limit a read to the frames remaining in the file. */
+static uint32_t frames_available(const wav_state* wav, uint32_t frames)
+{
+	int64_t remaining = wav->total_frames - wav->position;
+	return frames > remaining ? (uint32_t)remaining : frames;
+}
+
+static uint32_t wav_read(void* state, int16_t* dst, uint32_t frames)
+{
+	wav_state* wav = state;
+	frames = frames_available(wav, frames);
+	if(0 == frames)
+	{
+		return 0;
+	}
+
+	if(2 == wav->bytes_per_sample && is_little_endian_host())
+	{
+		// Already in the output format.
+		size_t count = fread(dst, wav->channels * wav->bytes_per_sample, frames, wav->file);
+		wav->position += (int64_t)count;
+		return (uint32_t)count;
+	}
+	return read_converted(wav, dst, frames, false);
+}
+
+static uint32_t wav_read_float(void* state, float* dst, uint32_t frames)
+{
+	wav_state* wav = state;
+	frames = frames_available(wav, frames);
+	if(0 == frames)
+	{
+		return 0;
+	}
+
+	if(wav->is_float && 4 == wav->bytes_per_sample && is_little_endian_host())
+	{
+		// Already in the output format.
+		size_t count = fread(dst, wav->channels * wav->bytes_per_sample, frames, wav->file);
+		wav->position += (int64_t)count;
+		return (uint32_t)count;
+	}
+	return read_converted(wav, dst, frames, true);
+}
+
+static bool wav_seek(void* state, int64_t frame)
+{
+	wav_state* wav = state;
+	long offset = wav->data_offset + (long)(frame * wav->channels * wav->bytes_per_sample);
+	if(0 != fseek(wav->file, offset, SEEK_SET))
+	{
+		return false;
+	}
+	wav->position = frame;
+	return true;
+}
+
+
+const oal_decoder_backend oal_decoder_backend_wav =
+{
+	"wav",
+	wav_probe,
+	wav_open,
+	wav_read,
+	wav_seek,
+	wav_close,
+	true,
+	NULL,
+	NULL,
+	NULL,
+	wav_read_float,
+};
@@ -0,0 +1,456 @@
+//
+//  oal_ease.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+
+#include "oal_ease.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/** The number of intervals in a lookup table. Linear interpolation between points
+ * this close together is within 3e-7 of every built-in curve.
+ */
+#define kTableSize 4096
+
+/** Overshoot of the back curves. */
+#define kBackOvershoot 1.70158f
+#define kBackOvershootInOut (kBackOvershoot * 1.525f)
+
+struct oal_ease_table
+{
+	float samples[kTableSize + 1];
+};
+
+
+// Exact Curves
+
+float oal_ease_linear(float x)
+{
+	return x;
+}
+
+float oal_ease_sine_in(float x)
+{
+	return 1.0f - cosf(x * (float)M_PI_2);
+}
+
+float oal_ease_sine_out(float x)
+{
+	return sinf(x * (float)M_PI_2);
+}
+
+float oal_ease_sine_in_out(float x)
+{
+	return -0.5f * (cosf(x * (float)M_PI) - 1);
+}
+
+float oal_ease_exponential_in(float x)
+{
+	if(x == 0)
+	{
+		return 0;
+	}
+	return powf(2, 10 * (x - 1));
+}
+
+float oal_ease_exponential_out(float x)
+{
+	if(x == 1)
+	{
+		return 1;
+	}
+	return 1 - powf(2, -10 * x);
+}
+
+float oal_ease_exponential_in_out(float x)
+{
+	if(x < 0.5)
+	{
+		if(x == 0)
+		{
+			return 0;
+		}
+		return powf(2, (12 * (x - 0.86f))) * 10;
+	}
+	if(x == 1)
+	{
+		return 1;
+	}
+	return 1 - powf(2, (-12 * (x - 0.4165f)));
+}
+
+float oal_ease_cubic_in(float x)
+{
+	return x * x * x;
+}
+
+float oal_ease_cubic_out(float x)
+{
+	float inverse = 1 - x;
+	return 1 - inverse * inverse * inverse;
+}
+
+float oal_ease_cubic_in_out(float x)
+{
+	if(x < 0.5f)
+	{
+		return 4 * x * x * x;
+	}
+	float inverse = 2 - 2 * x;
+	return 1 - inverse * inverse * inverse * 0.5f;
+}
+
+float oal_ease_quartic_in(float x)
+{
+	return x * x * x * x;
+}
+
+float oal_ease_quartic_out(float x)
+{
+	float inverse = 1 - x;
+	return 1 - inverse * inverse * inverse * inverse;
+}
+
+float oal_ease_quartic_in_out(float x)
+{
+	if(x < 0.5f)
+	{
+		return 8 * x * x * x * x;
+	}
+	float inverse = 2 - 2 * x;
+	return 1 - inverse * inverse * inverse * inverse * 0.5f;
+}
+
+float oal_ease_back_in(float x)
+{
+	return x * x * ((kBackOvershoot + 1) * x - kBackOvershoot);
+}
+
+float oal_ease_back_out(float x)
+{
+	float t = x - 1;
+	return 1 + t * t * ((kBackOvershoot + 1) * t + kBackOvershoot);
+}
+
+float oal_ease_back_in_out(float x)
+{
+	float t = 2 * x;
+	if(x < 0.5f)
+	{
+		return t * t * ((kBackOvershootInOut + 1) * t - kBackOvershootInOut) * 0.5f;
+	}
+	t -= 2;
+	return (t * t * ((kBackOvershootInOut + 1) * t + kBackOvershootInOut) + 2) * 0.5f;
+}
+
+static const oal_ease_function g_ease_functions[OAL_EASE_TYPE_COUNT] =
+{
+	oal_ease_linear,
+	oal_ease_sine_in,
+	oal_ease_sine_out,
+	oal_ease_sine_in_out,
+	oal_ease_exponential_in,
+	oal_ease_exponential_out,
+	oal_ease_exponential_in_out,
+	oal_ease_cubic_in,
+	oal_ease_cubic_out,
+	oal_ease_cubic_in_out,
+	oal_ease_quartic_in,
+	oal_ease_quartic_out,
+	oal_ease_quartic_in_out,
+	oal_ease_back_in,
+	oal_ease_back_out,
+	oal_ease_back_in_out,
+};
+
+oal_ease_function oal_ease_function_for_type(oal_ease_type type)
+{
+	return g_ease_functions[type];
+}
+
+
+// Approximations
+
+/** sin(x * pi/2) for x in [0, 1], within 6e-7. */
+static inline float approximate_sine(float x)
+{
+	float x2 = x * x;
+	return x * (1.5707910145f + x2 * (-0.6458928719f + x2 * (0.0794343848f + x2 * -0.0043331168f)));
+}
+
+/** 2^t for t in [-126, 127], within 1.1e-7 relative. */
+static inline float approximate_exp2(float t)
+{
+	// floor(t), without a branch.
+	float truncated = (float)(int32_t)t;
+	float adjust = truncated > t ? 1.0f : 0.0f;
+	float whole = truncated - adjust;
+	float fraction = t - whole;
+	float power = 0.9999998931f + fraction * (0.6931547514f + fraction * (0.2401397193f +
+				  fraction * (0.0558662235f + fraction * (0.0089428549f + fraction * 0.0018964508f))));
+
+	// Build 2^whole directly in the exponent bits.
+	int32_t bits = ((int32_t)whole + 127) << 23;
+	float scale;
+	memcpy(&scale, &bits, sizeof(scale));
+	return power * scale;
+}
+
+static inline float clamp_unit(float x)
+{
+	float low = x > 0 ? x : 0;
+	return low < 1 ? low : 1;
+}
+
+/** Make the ends of a curve exact, which the approximations don't guarantee. */
+static inline float pin_ends(float x, float y)
+{
+	float start = x > 0 ? y : 0;
+	return x < 1 ? start : 1;
+}
+
+/** Define a batch evaluator. EXPRESSION computes the curve from x, which is already clamped. */
+#define DEFINE_BATCH(NAME, EXPRESSION) \
+static void NAME(const float* input, float* output, size_t count) \
+{ \
+	for(size_t i = 0; i < count; i++) \
+	{ \
+		float x = clamp_unit(input[i]); \
+		output[i] = pin_ends(x, (EXPRESSION)); \
+	} \
+}
+
+static inline float exponential_in_out_curve(float x)
+{
+	bool first_half = x < 0.5f;
+	float rising = 12 * x - 10.32f;
+	float falling = 4.998f - 12 * x;
+	float power = approximate_exp2(first_half ? rising : falling);
+	float first = 10 * power;
+	float second = 1 - power;
+	return first_half ? first : second;
+}
+
+static inline float cubic_in_out_curve(float x)
+{
+	float inverse = 2 - 2 * x;
+	float first = 4 * x * x * x;
+	float second = 1 - inverse * inverse * inverse * 0.5f;
+	return x < 0.5f ? first : second;
+}
+
+static inline float quartic_in_out_curve(float x)
+{
+	float inverse = 2 - 2 * x;
+	float inverse2 = inverse * inverse;
+	float x2 = x * x;
+	float first = 8 * x2 * x2;
+	float second = 1 - inverse2 * inverse2 * 0.5f;
+	return x < 0.5f ? first : second;
+}
+
+static inline float back_in_out_curve(float x)
+{
+	float rising = 2 * x;
+	float falling = 2 * x - 2;
+	float first = rising * rising * ((kBackOvershootInOut + 1) * rising - kBackOvershootInOut) * 0.5f;
+	float second = (falling * falling * ((kBackOvershootInOut + 1) * falling + kBackOvershootInOut) + 2) * 0.5f;
+	return x < 0.5f ? first : second;
+}
+
+DEFINE_BATCH(batch_linear, x)
+DEFINE_BATCH(batch_sine_in, 1 - approximate_sine(1 - x))
+DEFINE_BATCH(batch_sine_out, approximate_sine(x))
+DEFINE_BATCH(batch_sine_in_out, approximate_sine(x) * approximate_sine(x))
+DEFINE_BATCH(batch_exponential_in, approximate_exp2(10 * x - 10))
+DEFINE_BATCH(batch_exponential_out, 1 - approximate_exp2(-10 * x))
+DEFINE_BATCH(batch_exponential_in_out, exponential_in_out_curve(x))
+DEFINE_BATCH(batch_cubic_in, x * x * x)
+DEFINE_BATCH(batch_cubic_out, 1 - (1 - x) * (1 - x) * (1 - x))
+DEFINE_BATCH(batch_cubic_in_out, cubic_in_out_curve(x))
+DEFINE_BATCH(batch_quartic_in, x * x * x * x)
+DEFINE_BATCH(batch_quartic_out, 1 - (1 - x) * (1 - x) * (1 - x) * (1 - x))
+DEFINE_BATCH(batch_quartic_in_out, quartic_in_out_curve(x))
+DEFINE_BATCH(batch_back_in, x * x * ((kBackOvershoot + 1) * x - kBackOvershoot))
+DEFINE_BATCH(batch_back_out, 1 + (x - 1) * (x - 1) * ((kBackOvershoot + 1) * (x - 1) + kBackOvershoot))
+DEFINE_BATCH(batch_back_in_out, back_in_out_curve(x))
+
+static void (* const g_batch_functions[OAL_EASE_TYPE_COUNT])(const float*, float*, size_t) =
+{
+	batch_linear,
+	batch_sine_in,
+	batch_sine_out,
+	batch_sine_in_out,
+	batch_exponential_in,
+	batch_exponential_out,
+	batch_exponential_in_out,
+	batch_cubic_in,
+	batch_cubic_out,
+	batch_cubic_in_out,
+	batch_quartic_in,
+	batch_quartic_out,
+	batch_quartic_in_out,
+	batch_back_in,
+	batch_back_out,
+	batch_back_in_out,
+};
+
+void oal_ease_evaluate(oal_ease_type type, const float* x, float* y, size_t count)
+{
+	g_batch_functions[type](x, y, count);
+}
+
+
+// Tables
+
+static _Atomic(oal_ease_table*) g_tables[OAL_EASE_TYPE_COUNT];
+static pthread_mutex_t g_tables_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+const oal_ease_table* oal_ease_table_for_type(oal_ease_type type)
+{
+	oal_ease_table* table = atomic_load_explicit(&g_tables[type], memory_order_acquire);
+	if(NULL != table)
+	{
+		return table;
+	}
+
+	pthread_mutex_lock(&g_tables_mutex);
+	table = atomic_load_explicit(&g_tables[type], memory_order_relaxed);
+	if(NULL == table && NULL != (table = malloc(sizeof(*table))))
+	{
+		oal_ease_function function = g_ease_functions[type];
+		for(int i = 1; i < kTableSize; i++)
+		{
+			table->samples[i] = function((float)i / kTableSize);
+		}
+
+		// The exponential curves jump at their very ends, so sample just inside them.
+		// Lookups at exactly 0 and 1 are pinned anyway.
+		table->samples[0] = function(nextafterf(0, 1));
+		table->samples[kTableSize] = function(nextafterf(1, 0));
+		atomic_store_explicit(&g_tables[type], table, memory_order_release);
+	}
+	pthread_mutex_unlock(&g_tables_mutex);
+	return table;
+}
+
+/** Evaluate one coordinate of a cubic Bezier curve from 0 to 1 with control values a and b. */
+static double bezier(double t, double a, double b)
+{
+	double inverse = 1 - t;
+	return 3 * inverse * inverse * t * a + 3 * inverse * t * t * b + t * t * t;
+}
+
+/** The slope of bezier() with respect to t. */
+static double bezier_slope(double t, double a, double b)
+{
+	double inverse = 1 - t;
+	return 3 * inverse * inverse * a + 6 * inverse * t * (b - a) + 3 * t * t * (1 - b);
+}
+
+oal_ease_table* oal_ease_table_create_bezier(float x1, float y1, float x2, float y2)
+{
+	oal_ease_table* table = malloc(sizeof(*table));
+	if(NULL == table)
+	{
+		return NULL;
+	}
+
+	// With both x control values in [0, 1], x only ever increases with t, so each x has one t.
+	double cx1 = clamp_unit(x1);
+	double cx2 = clamp_unit(x2);
+	double t = 0;
+	for(int i = 0; i <= kTableSize; i++)
+	{
+		double x = (double)i / kTableSize;
+
+		// Newton's method from the previous point, falling back to bisection if it strays.
+		double low = 0;
+		double high = 1;
+		for(int iteration = 0; iteration < 32; iteration++)
+		{
+			double error = bezier(t, cx1, cx2) - x;
+			if(fabs(error) < 1e-9)
+			{
+				break;
+			}
+			if(error < 0)
+			{
+				low = t;
+			}
+			else
+			{
+				high = t;
+			}
+			double slope = bezier_slope(t, cx1, cx2);
+			double next = slope > 1e-9 ? t - error / slope : low - 1;
+			t = next > low && next < high ? next : (low + high) / 2;
+		}
+		table->samples[i] = (float)bezier(t, y1, y2);
+	}
+	table->samples[0] = 0;
+	table->samples[kTableSize] = 1;
+	return table;
+}
+
+void oal_ease_table_destroy(oal_ease_table* table)
+{
+	free(table);
+}
+
+static inline float table_lookup(const float* samples, float x)
+{
+	x = clamp_unit(x);
+	float position = x * kTableSize;
+	int32_t truncated = (int32_t)position;
+	int32_t index = truncated < kTableSize ? truncated : kTableSize - 1;
+	float fraction = position - (float)index;
+	float low = samples[index];
+	return pin_ends(x, low + (samples[index + 1] - low) * fraction);
+}
+
+float oal_ease_table_value(const oal_ease_table* table, float x)
+{
+	return table_lookup(table->samples, x);
+}
+
+void oal_ease_table_evaluate(const oal_ease_table* table, const float* x, float* y, size_t count)
+{
+	const float* samples = table->samples;
+	for(size_t i = 0; i < count; i++)
+	{
+		y[i] = table_lookup(samples, x[i]);
+	}
+}
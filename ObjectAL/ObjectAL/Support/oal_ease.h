@@ -0,0 +1,181 @@
+//
+//  oal_ease.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+
+/* Ease curves, mapping the proportion of a change's duration that has passed (0.0 - 1.0)
+ * to the proportion of the change that has been applied.
+ *
+ * Each curve can be evaluated three ways:
+ * - One value at a time with its exact function (oal_ease_sine_in() etc).
+ * - A whole array at a time with oal_ease_evaluate(), which uses branch-free polynomial
+ *   approximations that the compiler turns into SIMD code.
+ * - Through a lookup table (oal_ease_table), interpolating between precomputed points.
+ *   Tables also allow custom cubic Bezier curves.
+ *
+ * Accuracy, as the largest absolute difference from the exact function over [0, 1]:
+ * - oal_ease_evaluate(): 2e-6 for the sine and exponential curves. The cubic, quartic and
+ *   back curves are polynomials already, so they only differ by float rounding (1e-7).
+ * - Tables: 1e-6 for the built-in curves, except that the exponential in-out curve's
+ *   small step at 0.5 is smoothed over (3e-5). Bezier tables are within 1e-6 of the
+ *   curve, except near sections so steep that they are almost vertical.
+ *
+ * Every curve maps 0 to 0 and 1 to 1 exactly in all modes.
+ */
+
+#ifndef OAL_EASE_H
+#define OAL_EASE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The built-in ease curves. */
+typedef enum
+{
+	OAL_EASE_LINEAR,
+	OAL_EASE_SINE_IN,
+	OAL_EASE_SINE_OUT,
+	OAL_EASE_SINE_IN_OUT,
+	OAL_EASE_EXPONENTIAL_IN,
+	OAL_EASE_EXPONENTIAL_OUT,
+	OAL_EASE_EXPONENTIAL_IN_OUT,
+	OAL_EASE_CUBIC_IN,
+	OAL_EASE_CUBIC_OUT,
+	OAL_EASE_CUBIC_IN_OUT,
+	OAL_EASE_QUARTIC_IN,
+	OAL_EASE_QUARTIC_OUT,
+	OAL_EASE_QUARTIC_IN_OUT,
+	/** Pulls back slightly before moving forward. */
+	OAL_EASE_BACK_IN,
+	/** Overshoots slightly before settling. */
+	OAL_EASE_BACK_OUT,
+	OAL_EASE_BACK_IN_OUT,
+	/** The number of built-in curves. */
+	OAL_EASE_TYPE_COUNT,
+} oal_ease_type;
+
+/** An ease curve evaluated one value at a time. */
+typedef float (*oal_ease_function)(float x);
+
+/** A curve sampled into a lookup table. */
+typedef struct oal_ease_table oal_ease_table;
+
+
+// Exact Curves
+
+float oal_ease_linear(float x);
+float oal_ease_sine_in(float x);
+float oal_ease_sine_out(float x);
+float oal_ease_sine_in_out(float x);
+float oal_ease_exponential_in(float x);
+float oal_ease_exponential_out(float x);
+float oal_ease_exponential_in_out(float x);
+float oal_ease_cubic_in(float x);
+float oal_ease_cubic_out(float x);
+float oal_ease_cubic_in_out(float x);
+float oal_ease_quartic_in(float x);
+float oal_ease_quartic_out(float x);
+float oal_ease_quartic_in_out(float x);
+float oal_ease_back_in(float x);
+float oal_ease_back_out(float x);
+float oal_ease_back_in_out(float x);
+
+/** Get the exact function for a built-in curve.
+ *
+ * @param type The curve.
+ * @return The function.
+ */
+oal_ease_function oal_ease_function_for_type(oal_ease_type type);
+
+
+// Batches
+
+/** Evaluate a built-in curve for an array of values using polynomial approximations.
+ *
+ * @param type The curve.
+ * @param x The values to evaluate (clamped to 0.0 - 1.0).
+ * @param y Receives the results (may be the same as x).
+ * @param count The number of values.
+ */
+void oal_ease_evaluate(oal_ease_type type, const float* x, float* y, size_t count);
+
+
+// Tables
+
+/** Get the shared lookup table for a built-in curve. It is built on first use.
+ *
+ * @param type The curve.
+ * @return The table, or NULL if it could not be allocated.
+ */
+const oal_ease_table* oal_ease_table_for_type(oal_ease_type type);
+
+/** Create a lookup table for a cubic Bezier curve running from (0, 0) to (1, 1),
+ * like the CSS cubic-bezier() timing function.
+ *
+ * @param x1 The x coordinate of the first control point (clamped to 0.0 - 1.0).
+ * @param y1 The y coordinate of the first control point.
+ * @param x2 The x coordinate of the second control point (clamped to 0.0 - 1.0).
+ * @param y2 The y coordinate of the second control point.
+ * @return The table, or NULL if it could not be allocated.
+ */
+oal_ease_table* oal_ease_table_create_bezier(float x1, float y1, float x2, float y2);
+
+/** Destroy a table made by oal_ease_table_create_bezier().
+ *
+ * @param table The table (may be NULL).
+ */
+void oal_ease_table_destroy(oal_ease_table* table);
+
+/** Look up one value in a table.
+ *
+ * @param table The table.
+ * @param x The value to look up (clamped to 0.0 - 1.0).
+ * @return The result.
+ */
+float oal_ease_table_value(const oal_ease_table* table, float x);
+
+/** Look up an array of values in a table.
+ *
+ * @param table The table.
+ * @param x The values to look up (clamped to 0.0 - 1.0).
+ * @param y Receives the results (may be the same as x).
+ * @param count The number of values.
+ */
+void oal_ease_table_evaluate(const oal_ease_table* table, const float* x, float* y, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_EASE_H */
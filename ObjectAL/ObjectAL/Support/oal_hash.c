@@ -0,0 +1,138 @@
+//
+//  oal_hash.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#include "oal_hash.h"
+
+
+#define kPrime1 0x9E3779B185EBCA87ull
+#define kPrime2 0xC2B2AE3D27D4EB4Full
+#define kPrime3 0x165667B19E3779F9ull
+#define kPrime4 0x85EBCA77C2B2AE63ull
+#define kPrime5 0x27D4EB2F165667C5ull
+
+
+static uint64_t rotate_left(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t read_le64(const uint8_t* p)
+{
+	return (uint64_t)p[0] |
+		((uint64_t)p[1] << 8) |
+		((uint64_t)p[2] << 16) |
+		((uint64_t)p[3] << 24) |
+		((uint64_t)p[4] << 32) |
+		((uint64_t)p[5] << 40) |
+		((uint64_t)p[6] << 48) |
+		((uint64_t)p[7] << 56);
+}
+
+static uint64_t read_le32(const uint8_t* p)
+{
+	return (uint64_t)p[0] |
+		((uint64_t)p[1] << 8) |
+		((uint64_t)p[2] << 16) |
+		((uint64_t)p[3] << 24);
+}
+
+static uint64_t hash_round(uint64_t accumulator, uint64_t input)
+{
+	accumulator += input * kPrime2;
+	accumulator = rotate_left(accumulator, 31);
+	return accumulator * kPrime1;
+}
+
+static uint64_t merge_round(uint64_t accumulator, uint64_t value)
+{
+	accumulator ^= hash_round(0, value);
+	return accumulator * kPrime1 + kPrime4;
+}
+
+uint64_t oal_hash64(const void* data, size_t length, uint64_t seed)
+{
+	const uint8_t* p = data;
+	const uint8_t* end = p + length;
+	uint64_t hash;
+
+	if(length >= 32)
+	{
+		const uint8_t* limit = end - 32;
+		uint64_t v1 = seed + kPrime1 + kPrime2;
+		uint64_t v2 = seed + kPrime2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - kPrime1;
+		do
+		{
+			v1 = hash_round(v1, read_le64(p));
+			v2 = hash_round(v2, read_le64(p + 8));
+			v3 = hash_round(v3, read_le64(p + 16));
+			v4 = hash_round(v4, read_le64(p + 24));
+			p += 32;
+		} while(p <= limit);
+
+		hash = rotate_left(v1, 1) + rotate_left(v2, 7) + rotate_left(v3, 12) + rotate_left(v4, 18);
+		hash = merge_round(hash, v1);
+		hash = merge_round(hash, v2);
+		hash = merge_round(hash, v3);
+		hash = merge_round(hash, v4);
+	}
+	else
+	{
+		hash = seed + kPrime5;
+	}
+
+	hash += (uint64_t)length;
+
+	for(; p + 8 <= end; p += 8)
+	{
+		hash ^= hash_round(0, read_le64(p));
+		hash = rotate_left(hash, 27) * kPrime1 + kPrime4;
+	}
+	if(p + 4 <= end)
+	{
+		hash ^= read_le32(p) * kPrime1;
+		hash = rotate_left(hash, 23) * kPrime2 + kPrime3;
+		p += 4;
+	}
+	for(; p < end; p++)
+	{
+		hash ^= *p * kPrime5;
+		hash = rotate_left(hash, 11) * kPrime1;
+	}
+
+	// Avalanche
+	hash ^= hash >> 33;
+	hash *= kPrime2;
+	hash ^= hash >> 29;
+	hash *= kPrime3;
+	hash ^= hash >> 32;
+	return hash;
+}
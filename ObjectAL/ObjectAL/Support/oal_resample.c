@@ -0,0 +1,386 @@
+//
+//  oal_resample.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#include "oal_resample.h"
+#include "oal_convert.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#if defined(__SSE2__)
+	#define OAL_RESAMPLE_X86 1
+	#include <emmintrin.h>
+	#if defined(__GNUC__) || defined(__clang__)
+		#define OAL_RESAMPLE_AVX2 1
+		#include <immintrin.h>
+	#endif
+#elif defined(__aarch64__) || defined(__arm64__)
+	#define OAL_RESAMPLE_NEON 1
+	#include <arm_neon.h>
+#endif
+
+
+/** Upper limit on the number of filter phases.
+ * Rate pairs that need more than this have their phase rounded to the nearest one.
+ */
+#define kMaxPhases 1024
+
+/** Output frames produced per conversion pass. */
+#define kBlockFrames 1024
+
+struct oal_resampler
+{
+	uint32_t channels;
+	/** Input frames advanced per output frame is in_step / out_step. */
+	uint64_t in_step;
+	uint64_t out_step;
+	uint32_t taps;
+	uint32_t phases;
+	/** phases * taps coefficients. */
+	float* filters;
+};
+
+typedef struct
+{
+	uint32_t taps;
+	double beta;
+	double rolloff;
+} quality_settings;
+
+static const quality_settings g_quality[] =
+{
+	{8, 5.0, 0.85},
+	{16, 6.0, 0.90},
+	{32, 8.0, 0.94},
+	{64, 10.0, 0.97},
+};
+
+
+// Dot product kernels
+
+typedef float (*dot_function)(const float* a, const float* b, uint32_t count);
+
+static dot_function g_dot;
+static pthread_once_t g_dot_once = PTHREAD_ONCE_INIT;
+
+static float scalar_dot(const float* a, const float* b, uint32_t count)
+{
+	float sum = 0;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		sum += a[i] * b[i];
+	}
+	return sum;
+}
+
+#if OAL_RESAMPLE_X86
+static float sse2_dot(const float* a, const float* b, uint32_t count)
+{
+	// Tap counts are always a multiple of 8.
+	__m128 sum0 = _mm_setzero_ps();
+	__m128 sum1 = _mm_setzero_ps();
+	for(uint32_t i = 0; i < count; i += 8)
+	{
+		sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+		sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+	}
+	float lanes[4];
+	_mm_storeu_ps(lanes, _mm_add_ps(sum0, sum1));
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+#endif
+
+#if OAL_RESAMPLE_AVX2
+__attribute__((target("avx2"))) static float avx2_dot(const float* a, const float* b, uint32_t count)
+{
+	__m256 sum = _mm256_setzero_ps();
+	for(uint32_t i = 0; i < count; i += 8)
+	{
+		sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+	}
+	__m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+	float lanes[4];
+	_mm_storeu_ps(lanes, half);
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+#endif
+
+#if OAL_RESAMPLE_NEON
+static float neon_dot(const float* a, const float* b, uint32_t count)
+{
+	float32x4_t sum0 = vdupq_n_f32(0);
+	float32x4_t sum1 = vdupq_n_f32(0);
+	for(uint32_t i = 0; i < count; i += 8)
+	{
+		sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+		sum1 = vfmaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+	}
+	return vaddvq_f32(vaddq_f32(sum0, sum1));
+}
+#endif
+
+static void select_dot(void)
+{
+	g_dot = scalar_dot;
+#if OAL_RESAMPLE_X86
+	g_dot = sse2_dot;
+#endif
+#if OAL_RESAMPLE_AVX2
+	if(__builtin_cpu_supports("avx2"))
+	{
+		g_dot = avx2_dot;
+	}
+#endif
+#if OAL_RESAMPLE_NEON
+	g_dot = neon_dot;
+#endif
+}
+
+
+// Filter design
+
+/** Zeroth order modified Bessel function of the first kind. */
+static double bessel_i0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	double quarter_x2 = x * x / 4.0;
+	for(int k = 1; k < 50; k++)
+	{
+		term *= quarter_x2 / ((double)k * k);
+		sum += term;
+		if(term < sum * 1e-12)
+		{
+			break;
+		}
+	}
+	return sum;
+}
+
+static uint64_t gcd(uint64_t a, uint64_t b)
+{
+	while(0 != b)
+	{
+		uint64_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+static bool build_filters(oal_resampler* resampler, const quality_settings* settings, double cutoff)
+{
+	uint32_t taps = resampler->taps;
+	double half = taps / 2;
+	double i0_beta = bessel_i0(settings->beta);
+
+	resampler->filters = malloc((size_t)resampler->phases * taps * sizeof(*resampler->filters));
+	if(NULL == resampler->filters)
+	{
+		return false;
+	}
+
+	for(uint32_t phase = 0; phase < resampler->phases; phase++)
+	{
+		float* filter = resampler->filters + (size_t)phase * taps;
+		double fraction = (double)phase / resampler->phases;
+		double sum = 0;
+		for(uint32_t k = 0; k < taps; k++)
+		{
+			// Distance from the output position to input sample k.
+			double t = (double)k - half + 1.0 - fraction;
+			double x = t / half;
+			double window = fabs(x) >= 1.0 ? 0.0 : bessel_i0(settings->beta * sqrt(1.0 - x * x)) / i0_beta;
+			double sinc = 0 == t ? 1.0 : sin(M_PI * cutoff * t) / (M_PI * cutoff * t);
+			double value = cutoff * sinc * window;
+			filter[k] = (float)value;
+			sum += value;
+		}
+		// Unity gain at DC for every phase, otherwise the phases modulate the level.
+		for(uint32_t k = 0; k < taps; k++)
+		{
+			filter[k] = (float)(filter[k] / sum);
+		}
+	}
+	return true;
+}
+
+
+// API
+
+oal_resampler* oal_resampler_create(uint32_t in_rate,
+									uint32_t out_rate,
+									uint32_t channels,
+									oal_resample_quality quality)
+{
+	if(0 == in_rate || 0 == out_rate || 0 == channels || (unsigned)quality > OAL_RESAMPLE_QUALITY_BEST)
+	{
+		return NULL;
+	}
+	pthread_once(&g_dot_once, select_dot);
+
+	oal_resampler* resampler = calloc(1, sizeof(*resampler));
+	if(NULL == resampler)
+	{
+		return NULL;
+	}
+
+	const quality_settings* settings = &g_quality[quality];
+	uint64_t divisor = gcd(in_rate, out_rate);
+	resampler->channels = channels;
+	resampler->in_step = in_rate / divisor;
+	resampler->out_step = out_rate / divisor;
+	resampler->taps = settings->taps;
+	resampler->phases = resampler->out_step > kMaxPhases ? kMaxPhases : (uint32_t)resampler->out_step;
+
+	// When downsampling, the cutoff must move down to the new Nyquist frequency.
+	double cutoff = settings->rolloff;
+	if(out_rate < in_rate)
+	{
+		cutoff *= (double)out_rate / in_rate;
+	}
+
+	if(!build_filters(resampler, settings, cutoff))
+	{
+		oal_resampler_destroy(resampler);
+		return NULL;
+	}
+	return resampler;
+}
+
+void oal_resampler_destroy(oal_resampler* resampler)
+{
+	if(NULL != resampler)
+	{
+		free(resampler->filters);
+		free(resampler);
+	}
+}
+
+size_t oal_resampler_output_frames(const oal_resampler* resampler, size_t in_frames)
+{
+	return (size_t)((uint64_t)in_frames * resampler->out_step / resampler->in_step);
+}
+
+/** Resample interleaved int16_t or float audio. */
+static size_t resample(oal_resampler* resampler, const void* src, size_t in_frames, void* dst, bool is_float)
+{
+	uint32_t channels = resampler->channels;
+	uint32_t taps = resampler->taps;
+	uint32_t phases = resampler->phases;
+	uint64_t out_step = resampler->out_step;
+	size_t out_frames = oal_resampler_output_frames(resampler, in_frames);
+	if(0 == out_frames)
+	{
+		return 0;
+	}
+
+	// One channel at a time, as float, with half a filter of silence on each side.
+	// The extra frame covers the last phase rounding up to the next input frame.
+	size_t padded_frames = in_frames + taps + 1;
+	float* padded = calloc(padded_frames, sizeof(*padded));
+	if(NULL == padded)
+	{
+		return 0;
+	}
+	float block[kBlockFrames];
+	int16_t converted[kBlockFrames];
+
+	for(uint32_t ch = 0; ch < channels; ch++)
+	{
+		float* input = padded + taps / 2;
+		if(is_float)
+		{
+			const float* samples = src;
+			for(size_t i = 0; i < in_frames; i++)
+			{
+				input[i] = samples[i * channels + ch];
+			}
+		}
+		else
+		{
+			const int16_t* samples = src;
+			for(size_t i = 0; i < in_frames; i++)
+			{
+				input[i] = samples[i * channels + ch] * (1.0f / 32768.0f);
+			}
+		}
+
+		for(size_t start = 0; start < out_frames; start += kBlockFrames)
+		{
+			size_t count = out_frames - start < kBlockFrames ? out_frames - start : kBlockFrames;
+			for(size_t n = 0; n < count; n++)
+			{
+				uint64_t position = (uint64_t)(start + n) * resampler->in_step;
+				uint64_t index = position / out_step;
+				uint64_t phase = ((position % out_step) * phases + out_step / 2) / out_step;
+				if(phase == phases)
+				{
+					index++;
+					phase = 0;
+				}
+				// padded[index + 1] is the first tap, input[index - taps/2 + 1].
+				block[n] = g_dot(padded + index + 1, resampler->filters + phase * taps, taps);
+			}
+
+			if(is_float)
+			{
+				float* out = (float*)dst + start * channels + ch;
+				for(size_t n = 0; n < count; n++)
+				{
+					out[n * channels] = block[n];
+				}
+			}
+			else
+			{
+				oal_convert_float_to_s16(block, converted, count, NULL);
+				int16_t* out = (int16_t*)dst + start * channels + ch;
+				for(size_t n = 0; n < count; n++)
+				{
+					out[n * channels] = converted[n];
+				}
+			}
+		}
+	}
+
+	free(padded);
+	return out_frames;
+}
+
+size_t oal_resampler_process(oal_resampler* resampler, const int16_t* src, size_t in_frames, int16_t* dst)
+{
+	return resample(resampler, src, in_frames, dst, false);
+}
+
+size_t oal_resampler_process_float(oal_resampler* resampler, const float* src, size_t in_frames, float* dst)
+{
+	return resample(resampler, src, in_frames, dst, true);
+}
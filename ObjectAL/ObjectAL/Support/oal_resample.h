@@ -0,0 +1,100 @@
+//
+//  oal_resample.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+/* Polyphase windowed sinc sample rate converter for whole buffers of 16-bit or float audio.
+ *
+ * Meant for converting audio once at load time so that the mixer doesn't have to
+ * do it on every playback. The filter is a Kaiser windowed sinc whose length
+ * depends on the quality setting, with one precomputed filter per phase.
+ */
+
+#ifndef OAL_RESAMPLE_H
+#define OAL_RESAMPLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Resampling quality. Higher settings use longer filters with a sharper cutoff. */
+typedef enum
+{
+	/** 8 taps. */
+	OAL_RESAMPLE_QUALITY_LOW,
+	/** 16 taps. */
+	OAL_RESAMPLE_QUALITY_MEDIUM,
+	/** 32 taps. */
+	OAL_RESAMPLE_QUALITY_HIGH,
+	/** 64 taps. */
+	OAL_RESAMPLE_QUALITY_BEST,
+} oal_resample_quality;
+
+typedef struct oal_resampler oal_resampler;
+
+/** Create a resampler.
+ *
+ * @param in_rate The sample rate of the source audio.
+ * @param out_rate The sample rate to convert to.
+ * @param channels The number of interleaved channels.
+ * @param quality The filter quality.
+ * @return The resampler, or NULL on failure.
+ */
+oal_resampler* oal_resampler_create(uint32_t in_rate,
+									uint32_t out_rate,
+									uint32_t channels,
+									oal_resample_quality quality);
+
+/** Destroy a resampler. */
+void oal_resampler_destroy(oal_resampler* resampler);
+
+/** The number of frames oal_resampler_process() will produce from in_frames frames. */
+size_t oal_resampler_output_frames(const oal_resampler* resampler, size_t in_frames);
+
+/** Resample a complete buffer of interleaved native endian 16-bit audio.
+ * Audio beyond either end of the buffer is treated as silence.
+ *
+ * @param resampler The resampler.
+ * @param src The source audio.
+ * @param in_frames The number of frames in src.
+ * @param dst Where to write the result (at least oal_resampler_output_frames() frames).
+ * @return The number of frames written, or 0 on failure.
+ */
+size_t oal_resampler_process(oal_resampler* resampler, const int16_t* src, size_t in_frames, int16_t* dst);
+
+/** Same as oal_resampler_process(), but for interleaved 32-bit float audio. */
+size_t oal_resampler_process_float(oal_resampler* resampler, const float* src, size_t in_frames, float* dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_RESAMPLE_H */
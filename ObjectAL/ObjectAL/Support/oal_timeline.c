@@ -0,0 +1,366 @@
+//
+//  oal_timeline.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+#include "oal_timeline.h"
+#include <math.h>
+#include <stdlib.h>
+
+
+/** The number of segments to allocate space for in a new timeline. */
+#define kInitialCapacity 16
+
+struct oal_timeline
+{
+	oal_timeline_segment* segments;
+	uint32_t count;
+	uint32_t capacity;
+	float duration;
+	bool compiled;
+};
+
+/** A segment that a cursor is currently running. */
+typedef struct
+{
+	uint32_t segment;
+	float start_value;
+	float delta;
+} active_segment;
+
+struct oal_timeline_cursor
+{
+	const oal_timeline* timeline;
+	float time;
+	/** The next segment to begin. */
+	uint32_t next;
+	/** Running segments, in the order they began. */
+	active_segment* active;
+	uint32_t active_count;
+	/** The time that the first running segment ends (INFINITY if none are running). */
+	float next_end;
+};
+
+
+// Timelines
+
+oal_timeline* oal_timeline_create(void)
+{
+	oal_timeline* timeline = calloc(1, sizeof(*timeline));
+	if(NULL == timeline)
+	{
+		return NULL;
+	}
+	timeline->segments = malloc(kInitialCapacity * sizeof(*timeline->segments));
+	if(NULL == timeline->segments)
+	{
+		free(timeline);
+		return NULL;
+	}
+	timeline->capacity = kInitialCapacity;
+	return timeline;
+}
+
+void oal_timeline_destroy(oal_timeline* timeline)
+{
+	if(NULL == timeline)
+	{
+		return;
+	}
+	free(timeline->segments);
+	free(timeline);
+}
+
+bool oal_timeline_add(oal_timeline* timeline, const oal_timeline_segment* segment)
+{
+	if(timeline->compiled || !(segment->start >= 0) || !(segment->duration >= 0))
+	{
+		return false;
+	}
+	if(timeline->count == timeline->capacity)
+	{
+		if(timeline->capacity > UINT32_MAX / 2)
+		{
+			return false;
+		}
+		uint32_t capacity = timeline->capacity * 2;
+		oal_timeline_segment* segments = realloc(timeline->segments, capacity * sizeof(*segments));
+		if(NULL == segments)
+		{
+			return false;
+		}
+		timeline->segments = segments;
+		timeline->capacity = capacity;
+	}
+	timeline->segments[timeline->count++] = *segment;
+
+	float end = segment->start + segment->duration;
+	if(end > timeline->duration)
+	{
+		timeline->duration = end;
+	}
+	return true;
+}
+
+/** A segment's start time and the order it was added in, for sorting. */
+typedef struct
+{
+	float start;
+	uint32_t index;
+} sort_key;
+
+static int compare_sort_keys(const void* a, const void* b)
+{
+	const sort_key* key_a = a;
+	const sort_key* key_b = b;
+	if(key_a->start != key_b->start)
+	{
+		return key_a->start < key_b->start ? -1 : 1;
+	}
+	// Keep segments that start together in the order they were added.
+	return key_a->index < key_b->index ? -1 : key_a->index > key_b->index;
+}
+
+void oal_timeline_compile(oal_timeline* timeline)
+{
+	if(timeline->compiled)
+	{
+		return;
+	}
+	timeline->compiled = true;
+	if(timeline->count < 2)
+	{
+		return;
+	}
+
+	sort_key* keys = malloc(timeline->count * sizeof(*keys));
+	oal_timeline_segment* sorted = malloc(timeline->count * sizeof(*sorted));
+	if(NULL == keys || NULL == sorted)
+	{
+		// Fall back to a stable sort in place.
+		for(uint32_t i = 1; i < timeline->count; i++)
+		{
+			oal_timeline_segment segment = timeline->segments[i];
+			uint32_t j = i;
+			for(; j > 0 && timeline->segments[j - 1].start > segment.start; j--)
+			{
+				timeline->segments[j] = timeline->segments[j - 1];
+			}
+			timeline->segments[j] = segment;
+		}
+	}
+	else
+	{
+		for(uint32_t i = 0; i < timeline->count; i++)
+		{
+			keys[i].start = timeline->segments[i].start;
+			keys[i].index = i;
+		}
+		qsort(keys, timeline->count, sizeof(*keys), compare_sort_keys);
+		for(uint32_t i = 0; i < timeline->count; i++)
+		{
+			sorted[i] = timeline->segments[keys[i].index];
+		}
+		free(timeline->segments);
+		timeline->segments = sorted;
+		timeline->capacity = timeline->count;
+		sorted = NULL;
+	}
+	free(keys);
+	free(sorted);
+}
+
+float oal_timeline_duration(const oal_timeline* timeline)
+{
+	return timeline->duration;
+}
+
+uint32_t oal_timeline_count(const oal_timeline* timeline)
+{
+	return timeline->count;
+}
+
+
+// Cursors
+
+oal_timeline_cursor* oal_timeline_cursor_create(const oal_timeline* timeline)
+{
+	if(!timeline->compiled)
+	{
+		return NULL;
+	}
+	oal_timeline_cursor* cursor = calloc(1, sizeof(*cursor));
+	if(NULL == cursor)
+	{
+		return NULL;
+	}
+	// At most every segment can be running at once.
+	cursor->active = malloc((timeline->count > 0 ? timeline->count : 1) * sizeof(*cursor->active));
+	if(NULL == cursor->active)
+	{
+		free(cursor);
+		return NULL;
+	}
+	cursor->timeline = timeline;
+	cursor->next_end = INFINITY;
+	return cursor;
+}
+
+void oal_timeline_cursor_destroy(oal_timeline_cursor* cursor)
+{
+	if(NULL == cursor)
+	{
+		return;
+	}
+	free(cursor->active);
+	free(cursor);
+}
+
+void oal_timeline_cursor_reset(oal_timeline_cursor* cursor)
+{
+	cursor->time = 0;
+	cursor->next = 0;
+	cursor->active_count = 0;
+	cursor->next_end = INFINITY;
+}
+
+/** Finish the running segments that end by the specified time (all of them if
+ * finish_all is set), keeping the rest in order.
+ * Does nothing unless a segment is due, so that only ticks that finish something
+ * pay for a pass over the running segments.
+ */
+static void finish_segments(oal_timeline_cursor* cursor,
+							float time,
+							bool finish_all,
+							const oal_timeline_callbacks* callbacks,
+							void* context)
+{
+	if(!finish_all && time < cursor->next_end)
+	{
+		return;
+	}
+
+	const oal_timeline_segment* segments = cursor->timeline->segments;
+	uint32_t kept = 0;
+	float next_end = INFINITY;
+	for(uint32_t i = 0; i < cursor->active_count; i++)
+	{
+		const oal_timeline_segment* segment = &segments[cursor->active[i].segment];
+		float end = segment->start + segment->duration;
+		if(finish_all || end <= time)
+		{
+			callbacks->write(context, segment->channel, segment->end_value);
+		}
+		else
+		{
+			cursor->active[kept++] = cursor->active[i];
+			if(end < next_end)
+			{
+				next_end = end;
+			}
+		}
+	}
+	cursor->active_count = kept;
+	cursor->next_end = next_end;
+}
+
+static void begin_segment(oal_timeline_cursor* cursor,
+						  uint32_t index,
+						  const oal_timeline_callbacks* callbacks,
+						  void* context)
+{
+	const oal_timeline_segment* segment = &cursor->timeline->segments[index];
+	if(NULL != segment->event)
+	{
+		callbacks->fire(context, segment->event);
+		return;
+	}
+	if(segment->duration <= 0)
+	{
+		callbacks->write(context, segment->channel, segment->end_value);
+		return;
+	}
+
+	float start_value = segment->start_value;
+	if(isnan(start_value))
+	{
+		start_value = callbacks->read(context, segment->channel);
+	}
+	active_segment* active = &cursor->active[cursor->active_count++];
+	active->segment = index;
+	active->start_value = start_value;
+	active->delta = segment->end_value - start_value;
+
+	float end = segment->start + segment->duration;
+	if(end < cursor->next_end)
+	{
+		cursor->next_end = end;
+	}
+}
+
+bool oal_timeline_cursor_advance_to(oal_timeline_cursor* cursor,
+									float time,
+									const oal_timeline_callbacks* callbacks,
+									void* context)
+{
+	const oal_timeline* timeline = cursor->timeline;
+	if(!(time > cursor->time))
+	{
+		time = cursor->time;
+	}
+
+	// Begin every segment that has started by now, in order. Anything that ended
+	// before a segment starts is finished first, so that the new segment sees its
+	// end value.
+	while(cursor->next < timeline->count && timeline->segments[cursor->next].start <= time)
+	{
+		finish_segments(cursor, timeline->segments[cursor->next].start, false, callbacks, context);
+		begin_segment(cursor, cursor->next, callbacks, context);
+		cursor->next++;
+	}
+	cursor->time = time;
+
+	if(time >= timeline->duration)
+	{
+		finish_segments(cursor, time, true, callbacks, context);
+		return true;
+	}
+
+	finish_segments(cursor, time, false, callbacks, context);
+	for(uint32_t i = 0; i < cursor->active_count; i++)
+	{
+		const active_segment* active = &cursor->active[i];
+		const oal_timeline_segment* segment = &timeline->segments[active->segment];
+		float proportion = (time - segment->start) / segment->duration;
+		float eased = NULL != segment->curve
+			? oal_ease_table_value(segment->curve, proportion)
+			: oal_ease_function_for_type(segment->ease)(proportion);
+		callbacks->write(context, segment->channel, active->start_value + active->delta * eased);
+	}
+	return false;
+}
@@ -0,0 +1,175 @@
+//
+//  oal_timeline.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+/* Compiled action timelines.
+ *
+ * A timeline is a tree of sequential and concurrent ramps flattened into one list of
+ * segments, each with an absolute start time. A cursor walks a timeline for one target:
+ * segments are begun in start order and dropped once they end, so each step only
+ * touches the segments that are running. One timeline can be shared by any number of
+ * cursors.
+ */
+
+#ifndef OAL_TIMELINE_H
+#define OAL_TIMELINE_H
+
+#include "oal_ease.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** One ramp of one channel (or one instant event) in a timeline. */
+typedef struct
+{
+	/** When the segment starts, in seconds from the start of the timeline. */
+	float start;
+	/** How long the segment lasts, in seconds (0 = jump straight to end_value). */
+	float duration;
+	/** The value at the start (NAN = the channel's value when the segment starts). */
+	float start_value;
+	/** The value at the end. */
+	float end_value;
+	/** The channel (property) that the segment ramps. */
+	uint32_t channel;
+	/** The curve to follow. */
+	oal_ease_type ease;
+	/** A custom curve to follow instead of ease, or NULL. It must outlive the timeline. */
+	const oal_ease_table* curve;
+	/** If not NULL, this segment is an instant event rather than a ramp. */
+	void* event;
+} oal_timeline_segment;
+
+/** Callbacks used by a cursor to read and write its target's channels. */
+typedef struct
+{
+	/** Read the current value of a channel. */
+	float (*read)(void* context, uint32_t channel);
+	/** Write a new value to a channel. */
+	void (*write)(void* context, uint32_t channel, float value);
+	/** Fire an instant event. */
+	void (*fire)(void* context, void* event);
+} oal_timeline_callbacks;
+
+typedef struct oal_timeline oal_timeline;
+typedef struct oal_timeline_cursor oal_timeline_cursor;
+
+
+// Timelines
+
+/** Create an empty timeline.
+ *
+ * @return The timeline, or NULL if it could not be allocated.
+ */
+oal_timeline* oal_timeline_create(void);
+
+/** Destroy a timeline. Any cursors on it must be destroyed first.
+ *
+ * @param timeline The timeline (may be NULL).
+ */
+void oal_timeline_destroy(oal_timeline* timeline);
+
+/** Add a segment to a timeline. Segments can be added in any order, but segments
+ * with the same start time begin in the order they were added.
+ *
+ * @param timeline The timeline (must not have been compiled yet).
+ * @param segment The segment to add (it is copied).
+ * @return false if the segment could not be added.
+ */
+bool oal_timeline_add(oal_timeline* timeline, const oal_timeline_segment* segment);
+
+/** Sort a timeline's segments into start order. No more segments can be added
+ * afterwards, and cursors can only be created after this.
+ *
+ * @param timeline The timeline.
+ */
+void oal_timeline_compile(oal_timeline* timeline);
+
+/** Get the duration of a timeline (the time its last segment ends).
+ *
+ * @param timeline The timeline.
+ * @return The duration in seconds.
+ */
+float oal_timeline_duration(const oal_timeline* timeline);
+
+/** Get the number of segments in a timeline.
+ *
+ * @param timeline The timeline.
+ * @return The number of segments.
+ */
+uint32_t oal_timeline_count(const oal_timeline* timeline);
+
+
+// Cursors
+
+/** Create a cursor at the start of a compiled timeline.
+ * A cursor doesn't allocate anything after it has been created.
+ *
+ * @param timeline The timeline.
+ * @return The cursor, or NULL if it could not be allocated.
+ */
+oal_timeline_cursor* oal_timeline_cursor_create(const oal_timeline* timeline);
+
+/** Destroy a cursor.
+ *
+ * @param cursor The cursor (may be NULL).
+ */
+void oal_timeline_cursor_destroy(oal_timeline_cursor* cursor);
+
+/** Move a cursor back to the start of its timeline, without touching any channels.
+ *
+ * @param cursor The cursor.
+ */
+void oal_timeline_cursor_reset(oal_timeline_cursor* cursor);
+
+/** Advance a cursor to a later time, writing the new value of every running segment.
+ * Segments that end on the way write their end value before later segments begin,
+ * so a segment with no start value picks up where the one before it left off.
+ *
+ * @param cursor The cursor.
+ * @param time The time to advance to, in seconds (times before the cursor's
+ *             current time are treated as the current time).
+ * @param callbacks The callbacks for reading and writing channels.
+ * @param context The first argument to the callbacks.
+ * @return true if the cursor has reached the end of the timeline.
+ */
+bool oal_timeline_cursor_advance_to(oal_timeline_cursor* cursor,
+									float time,
+									const oal_timeline_callbacks* callbacks,
+									void* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_TIMELINE_H */
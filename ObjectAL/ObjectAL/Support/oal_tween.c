@@ -0,0 +1,364 @@
+//
+//  oal_tween.c
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+
+#include "oal_tween.h"
+#include <stdlib.h>
+
+
+/** Marks a handle as free. The remaining bits link to the next free handle. */
+#define kFreeHandle 0x80000000u
+
+/** Ends the list of free handles. */
+#define kNoFreeHandle (kFreeHandle - 1)
+
+/** The largest number of tweens an engine can hold. */
+#define kMaxTweens kNoFreeHandle
+
+/** The ease value of tweens that follow a custom curve. */
+#define kCustomCurve OAL_EASE_TYPE_COUNT
+
+/** The number of groups tweens are sorted into for evaluating their curves. */
+#define kCurveGroups (kCustomCurve + 1)
+
+struct oal_tween_engine
+{
+	uint32_t count;
+	uint32_t capacity;
+
+	// Per tween, packed.
+	float* start;
+	float* delta;
+	float* elapsed;
+	float* duration;
+	float* value;
+	uint8_t* ease;
+	const oal_ease_table** curve;
+	uint32_t* handle;
+	void** binding;
+
+	/** Scratch space for evaluating curves in batches. */
+	uint32_t* order;
+	float* batch;
+
+	bool use_tables;
+
+	/** Per handle: the tween's index, or kFreeHandle | the next free handle. */
+	uint32_t* index_of_handle;
+	uint32_t handle_count;
+	uint32_t first_free_handle;
+};
+
+
+// Lifecycle
+
+static bool grow(oal_tween_engine* engine, uint32_t capacity)
+{
+	// Each array is reassigned as soon as it is reallocated, so a failure part way
+	// through leaves the engine consistent at its old capacity.
+#define GROW(ARRAY) \
+	{ \
+		void* grown = realloc(engine->ARRAY, capacity * sizeof(*engine->ARRAY)); \
+		if(NULL == grown) \
+		{ \
+			return false; \
+		} \
+		engine->ARRAY = grown; \
+	}
+	GROW(start);
+	GROW(delta);
+	GROW(elapsed);
+	GROW(duration);
+	GROW(value);
+	GROW(ease);
+	GROW(curve);
+	GROW(handle);
+	GROW(binding);
+	GROW(order);
+	GROW(batch);
+	GROW(index_of_handle);
+#undef GROW
+	engine->capacity = capacity;
+	return true;
+}
+
+oal_tween_engine* oal_tween_engine_create(uint32_t capacity)
+{
+	oal_tween_engine* engine = calloc(1, sizeof(*engine));
+	if(NULL == engine)
+	{
+		return NULL;
+	}
+	engine->first_free_handle = kNoFreeHandle;
+	if(!grow(engine, capacity > 0 ? capacity : 1))
+	{
+		oal_tween_engine_destroy(engine);
+		return NULL;
+	}
+	return engine;
+}
+
+void oal_tween_engine_destroy(oal_tween_engine* engine)
+{
+	if(NULL == engine)
+	{
+		return;
+	}
+	free(engine->start);
+	free(engine->delta);
+	free(engine->elapsed);
+	free(engine->duration);
+	free(engine->value);
+	free(engine->ease);
+	free(engine->curve);
+	free(engine->handle);
+	free(engine->binding);
+	free(engine->order);
+	free(engine->batch);
+	free(engine->index_of_handle);
+	free(engine);
+}
+
+void oal_tween_engine_set_use_tables(oal_tween_engine* engine, bool use_tables)
+{
+	engine->use_tables = use_tables;
+}
+
+
+// Tweens
+
+uint32_t oal_tween_engine_count(const oal_tween_engine* engine)
+{
+	return engine->count;
+}
+
+void* oal_tween_engine_binding_at(const oal_tween_engine* engine, uint32_t index)
+{
+	return engine->binding[index];
+}
+
+uint32_t oal_tween_engine_add(oal_tween_engine* engine,
+							  float start_value,
+							  float end_value,
+							  float duration,
+							  oal_ease_type ease,
+							  const oal_ease_table* curve,
+							  void* binding)
+{
+	// Handles are only allocated for live tweens, so there are never more handles than capacity.
+	if(engine->count == engine->capacity)
+	{
+		if(engine->capacity >= kMaxTweens / 2 || !grow(engine, engine->capacity * 2))
+		{
+			return OAL_TWEEN_INVALID_HANDLE;
+		}
+	}
+
+	uint32_t handle;
+	if(kNoFreeHandle != engine->first_free_handle)
+	{
+		handle = engine->first_free_handle;
+		engine->first_free_handle = engine->index_of_handle[handle] & ~kFreeHandle;
+	}
+	else
+	{
+		handle = engine->handle_count++;
+	}
+
+	uint32_t index = engine->count++;
+	engine->start[index] = start_value;
+	engine->delta[index] = end_value - start_value;
+	engine->elapsed[index] = 0;
+	engine->duration[index] = duration;
+	engine->value[index] = start_value;
+	engine->ease[index] = (uint8_t)(NULL != curve ? kCustomCurve : ease);
+	engine->curve[index] = curve;
+	engine->handle[index] = handle;
+	engine->binding[index] = binding;
+	engine->index_of_handle[handle] = index;
+	return handle;
+}
+
+/** Remove the tween at an index by moving the last tween into its place. */
+static void remove_at(oal_tween_engine* engine, uint32_t index)
+{
+	uint32_t handle = engine->handle[index];
+	engine->index_of_handle[handle] = kFreeHandle | engine->first_free_handle;
+	engine->first_free_handle = handle;
+
+	uint32_t last = --engine->count;
+	if(index != last)
+	{
+		engine->start[index] = engine->start[last];
+		engine->delta[index] = engine->delta[last];
+		engine->elapsed[index] = engine->elapsed[last];
+		engine->duration[index] = engine->duration[last];
+		engine->value[index] = engine->value[last];
+		engine->ease[index] = engine->ease[last];
+		engine->curve[index] = engine->curve[last];
+		engine->handle[index] = engine->handle[last];
+		engine->binding[index] = engine->binding[last];
+		engine->index_of_handle[engine->handle[index]] = index;
+	}
+}
+
+bool oal_tween_engine_remove(oal_tween_engine* engine, uint32_t handle)
+{
+	if(handle >= engine->handle_count || 0 != (engine->index_of_handle[handle] & kFreeHandle))
+	{
+		return false;
+	}
+	remove_at(engine, engine->index_of_handle[handle]);
+	return true;
+}
+
+/** Replace each tween's proportion complete with its position along its curve.
+ * Tweens are sorted by curve so that each curve is evaluated in one batch.
+ */
+static void evaluate_curves(oal_tween_engine* engine)
+{
+	uint32_t count = engine->count;
+	const uint8_t* ease = engine->ease;
+	float* value = engine->value;
+	uint32_t* order = engine->order;
+	float* batch = engine->batch;
+
+	uint32_t group_start[kCurveGroups + 1] = {0};
+	for(uint32_t i = 0; i < count; i++)
+	{
+		group_start[ease[i] + 1]++;
+	}
+	if(group_start[OAL_EASE_LINEAR + 1] == count)
+	{
+		// Nothing to do.
+		return;
+	}
+	for(uint32_t group = 0; group < kCurveGroups; group++)
+	{
+		group_start[group + 1] += group_start[group];
+	}
+
+	uint32_t position[kCurveGroups];
+	for(uint32_t group = 0; group < kCurveGroups; group++)
+	{
+		position[group] = group_start[group];
+	}
+	for(uint32_t i = 0; i < count; i++)
+	{
+		order[position[ease[i]]++] = i;
+	}
+
+	// Linear tweens are already done.
+	for(uint32_t group = OAL_EASE_LINEAR + 1; group < kCurveGroups; group++)
+	{
+		uint32_t first = group_start[group];
+		uint32_t length = group_start[group + 1] - first;
+		if(0 == length)
+		{
+			continue;
+		}
+
+		if(kCustomCurve == group)
+		{
+			for(uint32_t i = first; i < first + length; i++)
+			{
+				value[order[i]] = oal_ease_table_value(engine->curve[order[i]], value[order[i]]);
+			}
+			continue;
+		}
+
+		for(uint32_t i = 0; i < length; i++)
+		{
+			batch[i] = value[order[first + i]];
+		}
+		const oal_ease_table* table = engine->use_tables ? oal_ease_table_for_type(group) : NULL;
+		if(NULL != table)
+		{
+			oal_ease_table_evaluate(table, batch, batch, length);
+		}
+		else
+		{
+			oal_ease_evaluate(group, batch, batch, length);
+		}
+		for(uint32_t i = 0; i < length; i++)
+		{
+			value[order[first + i]] = batch[i];
+		}
+	}
+}
+
+void oal_tween_engine_step(oal_tween_engine* engine,
+						   float elapsed,
+						   oal_tween_apply_function apply,
+						   void* context)
+{
+	uint32_t count = engine->count;
+	const float* start = engine->start;
+	const float* delta = engine->delta;
+	float* elapsed_time = engine->elapsed;
+	const float* duration = engine->duration;
+	float* value = engine->value;
+
+	// Proportion complete.
+	for(uint32_t i = 0; i < count; i++)
+	{
+		float time = elapsed_time[i] + elapsed;
+		elapsed_time[i] = time;
+		float proportion = time / duration[i];
+		value[i] = proportion < 1.0f ? proportion : 1.0f;
+	}
+
+	evaluate_curves(engine);
+
+	for(uint32_t i = 0; i < count; i++)
+	{
+		value[i] = start[i] + delta[i] * value[i];
+	}
+
+	// Apply, removing finished tweens as we go. A removed tween's place is
+	// taken by the last one, which has already been stepped.
+	uint32_t i = 0;
+	while(i < engine->count)
+	{
+		bool finished = elapsed_time[i] >= duration[i];
+		void* binding = engine->binding[i];
+		float result = finished ? start[i] + delta[i] : value[i];
+		if(finished)
+		{
+			remove_at(engine, i);
+		}
+		else
+		{
+			i++;
+		}
+		apply(context, binding, result, finished);
+	}
+}
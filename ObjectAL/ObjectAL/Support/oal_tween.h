@@ -0,0 +1,156 @@
+//
+//  oal_tween.h
+//  ObjectAL
+//
+//  Created by Karl Stenerud on 26-10-19.
+//
+//  Copyright (c) 2009 Karl Stenerud. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall remain in place
+// in this source code.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Attribution is not required, but appreciated :)
+//
+
+
+
+
+/* Packed tween engine.
+ *
+ * Holds any number of value ramps (a start value, a change, a duration and an ease
+ * curve) in parallel arrays, and advances them all in one pass per step. Tweens are
+ * grouped by curve each step so that each curve is evaluated in one batch. Finished
+ * tweens are swap-removed, so the live tweens always stay packed together.
+ */
+
+#ifndef OAL_TWEEN_H
+#define OAL_TWEEN_H
+
+#include "oal_ease.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Called for each tween when it is stepped.
+ *
+ * @param context The context passed to oal_tween_engine_step().
+ * @param binding The binding the tween was added with.
+ * @param value The tween's new value.
+ * @param finished If true, the tween has reached its end value and has been removed.
+ */
+typedef void (*oal_tween_apply_function)(void* context, void* binding, float value, bool finished);
+
+typedef struct oal_tween_engine oal_tween_engine;
+
+/** Returned in place of a handle when a tween could not be added. */
+#define OAL_TWEEN_INVALID_HANDLE UINT32_MAX
+
+
+// Lifecycle
+
+/** Create a tween engine. It grows as needed.
+ *
+ * @param capacity The number of tweens to allocate space for up front.
+ * @return The engine, or NULL if it could not be allocated.
+ */
+oal_tween_engine* oal_tween_engine_create(uint32_t capacity);
+
+/** Destroy a tween engine.
+ *
+ * @param engine The engine (may be NULL).
+ */
+void oal_tween_engine_destroy(oal_tween_engine* engine);
+
+/** Choose whether an engine evaluates the built-in curves through lookup tables
+ * rather than polynomial approximations (default false). See oal_ease.h for the
+ * accuracy of each.
+ *
+ * @param engine The engine.
+ * @param use_tables If true, use lookup tables.
+ */
+void oal_tween_engine_set_use_tables(oal_tween_engine* engine, bool use_tables);
+
+
+// Tweens
+
+/** Get the number of tweens running in an engine.
+ *
+ * @param engine The engine.
+ * @return The number of tweens.
+ */
+uint32_t oal_tween_engine_count(const oal_tween_engine* engine);
+
+/** Get the binding of a running tween, in no particular order.
+ *
+ * @param engine The engine.
+ * @param index The index of the tween (0 to count - 1).
+ * @return The binding.
+ */
+void* oal_tween_engine_binding_at(const oal_tween_engine* engine, uint32_t index);
+
+/** Add a tween to an engine.
+ *
+ * @param engine The engine.
+ * @param start_value The value at the start of the tween.
+ * @param end_value The value at the end of the tween.
+ * @param duration The duration of the tween in seconds (must be > 0).
+ * @param ease The curve to follow.
+ * @param curve A custom curve to follow instead of ease (NULL = use ease). It must
+ *              remain valid until the tween finishes or is removed.
+ * @param binding Passed to the apply function to identify what the tween controls.
+ * @return A handle for removing the tween, or OAL_TWEEN_INVALID_HANDLE if it could not be added.
+ *         The handle stays valid until the tween finishes or is removed.
+ */
+uint32_t oal_tween_engine_add(oal_tween_engine* engine,
+							  float start_value,
+							  float end_value,
+							  float duration,
+							  oal_ease_type ease,
+							  const oal_ease_table* curve,
+							  void* binding);
+
+/** Remove a tween before it finishes.
+ *
+ * @param engine The engine.
+ * @param handle The handle returned by oal_tween_engine_add().
+ * @return false if there was no such tween.
+ */
+bool oal_tween_engine_remove(oal_tween_engine* engine, uint32_t handle);
+
+/** Advance all tweens, and pass each one's new value to an apply function.
+ * Tweens that reach their end are removed after being applied.
+ * The apply function must not add or remove tweens.
+ *
+ * @param engine The engine.
+ * @param elapsed The time elapsed since the last step, in seconds.
+ * @param apply The function to apply each tween's value.
+ * @param context The first argument to the apply function.
+ */
+void oal_tween_engine_step(oal_tween_engine* engine,
+						   float elapsed,
+						   oal_tween_apply_function apply,
+						   void* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_TWEEN_H */